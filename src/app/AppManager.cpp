@@ -19,9 +19,12 @@
 #include "../server/overlay/OverlayTool.h"
 
 #include "../test/ds/BufferTest.h"
+#include "../test/ds/EncodingBenchmark.h"
 #include "../test/ds/HashTableTest.h"
+#include "../test/ds/LayoutBenchmark.h"
 #include "../test/flood/NetworkTest.h"
 #include "../test/multicast/MulticastConsumer.h"
+#include "../test/overlay/MessageLogTest.h"
 
 #include <iostream>
 #include <getopt.h>
@@ -243,18 +246,39 @@ void AppManager::runComponentsTest() noexcept {
 		std::cout << "\n-----HASH TABLE TEST END-----\n";
 	}
 
+	{
+		std::cout << "\n-----MESSAGE LOG TEST BEGIN-----\n";
+		MessageLogTest t;
+		t.execute();
+		std::cout << "\n-----MESSAGE LOG TEST END-----\n";
+	}
+
 	{
 		std::cout << "\n-----ENCODING TEST BEGIN-----\n";
 		Encoding::test();
 		std::cout << "\n-----ENCODING TEST END-----\n";
 	}
 
+	{
+		std::cout << "\n-----ENCODING BENCHMARK BEGIN-----\n";
+		EncodingBenchmark eb;
+		eb.execute();
+		std::cout << "\n-----ENCODING BENCHMARK END-----\n";
+	}
+
 	{
 		std::cout << "\n-----SERIALIZER TEST BEGIN-----\n";
 		Serializer::test();
 		std::cout << "\n-----SERIALIZER TEST END-----\n";
 	}
 
+	{
+		std::cout << "\n-----LAYOUT BENCHMARK BEGIN-----\n";
+		LayoutBenchmark lb;
+		lb.execute();
+		std::cout << "\n-----LAYOUT BENCHMARK END-----\n";
+	}
+
 	{
 		std::cout << "\n-----SRP VECTOR TEST BEGIN-----\n";
 		Timer t;
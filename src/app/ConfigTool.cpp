@@ -17,6 +17,7 @@
 #include "../base/ds/Encoding.h"
 #include "../util/Authenticator.h"
 #include "../util/Hosts.h"
+#include "../util/HostsSnapshot.h"
 #include "../util/PKI.h"
 #include <cinttypes>
 #include <cstring>
@@ -34,7 +35,8 @@ ConfigTool::~ConfigTool() {
 
 void ConfigTool::execute() noexcept {
 	std::cout << "Select an option\n" << "1. Generate keys\n"
-			<< "2. Manage hosts\n" << "3. Generate verifier\n" << "::";
+			<< "2. Manage hosts\n" << "3. Generate verifier\n"
+			<< "4. Decode structured logs\n" << "::";
 
 	int mode;
 	std::cin >> mode;
@@ -53,6 +55,9 @@ void ConfigTool::execute() noexcept {
 		case 3:
 			generateVerifier();
 			break;
+		case 4:
+			decodeLogs();
+			break;
 		default:
 			std::cerr << "Invalid option" << std::endl;
 			break;
@@ -90,12 +95,15 @@ void ConfigTool::generateKeyPair() {
 void ConfigTool::manageHosts() {
 	char hf[1024] = { '\0' };
 	char sf[1024] = { '\0' };
+	char nf[1024] = { '\0' };
 	unsigned int mode; //unsigned
 
 	std::cout << "Select operation\n"
 			<< "1: Dump the \"hosts\" file into an SQLite3 database\n"
 			<< "2: Dump the SQLite3 \"hosts\" database into a file\n"
-			<< "3: Generate a sample \"hosts\" file\n:: ";
+			<< "3: Generate a sample \"hosts\" file\n"
+			<< "4: Compile the SQLite3 \"hosts\" database into a snapshot\n"
+			<< "5: Compile the \"hosts\" file into a snapshot\n:: ";
 
 	std::cin >> mode;
 	if (CommandLine::inputError()) {
@@ -103,7 +111,7 @@ void ConfigTool::manageHosts() {
 	}
 
 	std::cin.ignore();
-	if (mode <= 3) {
+	if (mode <= 3 || mode == 5) {
 		std::cout << "Pathname of the \"hosts\" file: ";
 		std::cin.getline(hf, sizeof(hf));
 		if (CommandLine::inputError()) {
@@ -111,13 +119,21 @@ void ConfigTool::manageHosts() {
 		}
 	}
 
-	if (mode <= 2) {
+	if (mode <= 2 || mode == 4) {
 		std::cout << "Pathname of the \"hosts\" database: ";
 		std::cin.getline(sf, sizeof(sf));
 		if (CommandLine::inputError()) {
 			return;
 		}
 	}
+
+	if (mode == 4 || mode == 5) {
+		std::cout << "Pathname of the snapshot: ";
+		std::cin.getline(nf, sizeof(nf));
+		if (CommandLine::inputError()) {
+			return;
+		}
+	}
 	try {
 		if (mode == 1) {
 			Hosts hosts(sf);
@@ -127,6 +143,13 @@ void ConfigTool::manageHosts() {
 			hosts.batchDump(hf);
 		} else if (mode == 3) {
 			createDummyHostsFile(hf);
+		} else if (mode == 4) {
+			Hosts hosts(sf, true);
+			HostsSnapshot::create(nf, hosts);
+		} else if (mode == 5) {
+			Hosts hosts(":memory:");
+			hosts.batchUpdate(hf);
+			HostsSnapshot::create(nf, hosts);
 		} else {
 			std::cout << "Invalid option" << std::endl;
 		}
@@ -185,6 +208,20 @@ void ConfigTool::generateVerifier() {
 	}
 }
 
+void ConfigTool::decodeLogs() {
+	char path[1024] = { '\0' };
+	std::cout << "Pathname of the structured log: ";
+	std::cin.ignore();
+	std::cin.getline(path, sizeof(path));
+	if (CommandLine::inputError()) {
+		return;
+	}
+
+	if (!Logger::decode(path, stdout)) {
+		throw Exception(EX_RESOURCE);
+	}
+}
+
 void ConfigTool::createDummyHostsFile(const char *path) {
 	std::cout << "Generating a sample \"hosts\" file..." << std::endl;
 	Hosts::createDummy(path);
@@ -35,6 +35,7 @@ private:
 	static void generateKeyPair();
 	static void manageHosts();
 	static void generateVerifier();
+	static void decodeLogs();
 private:
 	static void createDummyHostsFile(const char *path);
 };
@@ -12,6 +12,7 @@
 
 #include "Network.h"
 #include "common/Exception.h"
+#include "ipc/Connector.h"
 #include "ipc/DNS.h"
 #include "unix/Fcntl.h"
 #include "unix/SystemException.h"
@@ -57,25 +58,28 @@ int Network::connectedSocket(const char *name, const char *service,
 	SocketTraits traits = { AF_UNSPEC, SOCK_STREAM, 0, 0 };
 	DNS dns(name, service, &traits);
 
+	SocketAddress addresses[Connector::MAX_ADDRESSES];
+	unsigned int count = 0;
 	const addrinfo *rp; //The iterator
-	//Try each address until we successfully connect(2).
-	while ((rp = dns.next())) {
-		//Linux-specific, saves a system call
-		auto sockType =
-				blocking ? rp->ai_socktype : rp->ai_socktype | SOCK_NONBLOCK;
-		auto sfd = ::socket(rp->ai_family, sockType, rp->ai_protocol);
-		if (sfd == -1) {
-			continue;
-		}
+	while (count < Connector::MAX_ADDRESSES && (rp = dns.next())) {
+		DNS::getAddress(rp, addresses[count++]);
+	}
 
-		auto ret = ::connect(sfd, rp->ai_addr, rp->ai_addrlen);
-		if (ret == 0 || (!blocking && errno == EINPROGRESS)) {
-			::memcpy(&sa.address, rp->ai_addr, rp->ai_addrlen);
-			sa.length = rp->ai_addrlen;
+	//Alternate the address families, starting with the preferred one
+	Connector::order(name, addresses, count);
+	if (blocking && count) {
+		return Connector::connect(name, addresses, count, sa);
+	}
+
+	//Try each address until we successfully connect(2).
+	for (unsigned int i = 0; i < count; ++i) {
+		try {
+			auto sfd = connectedSocket(addresses[i], false);
+			sa = addresses[i];
 			return sfd; /* Success */
+		} catch (const BaseException &e) {
+			continue;
 		}
-
-		close(sfd); /* Close and continue */
 	}
 
 	//Something went wrong
@@ -87,6 +91,33 @@ int Network::connectedSocket(const NameInfo &ni, SocketAddress &sa,
 	return connectedSocket(ni.host, ni.service, sa, blocking);
 }
 
+int Network::connectedSocket(const SocketAddress &sa, bool blocking) {
+	auto sockType = blocking ? SOCK_STREAM : (SOCK_STREAM | SOCK_NONBLOCK);
+	auto sfd = ::socket(sa.address.ss_family, sockType, 0);
+	if (sfd == -1) {
+		throw SystemException();
+	}
+
+	auto ret = ::connect(sfd, (const sockaddr*) &sa.address, sa.length);
+	if (ret == 0 || (!blocking && errno == EINPROGRESS)) {
+		return sfd;
+	} else {
+		auto error = errno;
+		close(sfd);
+		throw SystemException(error);
+	}
+}
+
+int Network::socketError(int sfd) {
+	int error = 0;
+	socklen_t length = sizeof(error);
+	if (::getsockopt(sfd, SOL_SOCKET, SO_ERROR, &error, &length) == -1) {
+		throw SystemException();
+	} else {
+		return error;
+	}
+}
+
 void Network::listen(int sfd, int backlog) {
 	if (::listen(sfd, backlog) == -1) {
 		throw SystemException();
@@ -30,7 +30,9 @@ public:
 	static int serverSocket(const char *service, SocketAddress &sa,
 			bool blocking);
 	/**
-	 * Creates a connected socket.
+	 * Creates a connected socket. The address families are tried in the
+	 * alternating order, and in the blocking mode the connection attempts
+	 * race each other (see Connector).
 	 * @param name describes the internet host (usually the IP address)
 	 * @param service describes the internet service (usually the port number)
 	 * @param sa stores host's socket address
@@ -48,6 +50,23 @@ public:
 	 */
 	static int connectedSocket(const NameInfo &ni, SocketAddress &sa,
 			bool blocking);
+	/**
+	 * Creates a socket connected to the given address (doesn't perform any
+	 * name resolution).
+	 * @param sa host's socket address
+	 * @param blocking true for blocking mode, false for nonblocking IO
+	 * @return connected socket's file descriptor, the connection may be in
+	 * progress in the nonblocking mode (see Network::socketError()).
+	 */
+	static int connectedSocket(const SocketAddress &sa, bool blocking);
+	/**
+	 * Reads and clears a socket's pending error. Call this after a socket with
+	 * nonblocking connection in progress becomes writable.
+	 * @param sfd socket descriptor
+	 * @return zero (0) if the connection was established, an error code
+	 * otherwise (see connect(2)).
+	 */
+	static int socketError(int sfd);
 	//-----------------------------------------------------------------
 	/**
 	 * Listens for incoming connections.
@@ -73,7 +73,7 @@ size_t Timer::print(char *buffer, size_t size) noexcept {
 unsigned long long Timer::timeSeed() noexcept {
 	Time t(CLOCK_MONOTONIC); //Cannot fail
 	decltype(auto) ts = t.get();
-	return Twiddler::FVN1aHash(&ts, sizeof(ts));
+	return Twiddler::wyHash(&ts, sizeof(ts));
 }
 
 unsigned long long Timer::currentTime() noexcept {
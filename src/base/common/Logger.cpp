@@ -11,9 +11,22 @@
  */
 
 #include "Logger.h"
+#include "Atomic.h"
+#include <cerrno>
+#include <csignal>
 #include <cstdarg>
+#include <cstdint>
 #include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fcntl.h>
+#include <new>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
 #include <syslog.h>
+#include <unistd.h>
 
 namespace {
 
@@ -24,17 +37,485 @@ LOG_NOTICE, LOG_INFO, LOG_DEBUG };
 const char *levelNames[] = { "EMERGENCY", "ALERT", "CRITICAL", "ERROR",
 		"WARNING", "NOTICE", "INFO", "DEBUG" };
 const char *targetNames[] = { "STDERR", "SYSLOG" };
+const char *overflowNames[] = { "DROP", "COUNT", "BLOCK" };
+
+//Records written out per system call
+constexpr unsigned int BATCH_SIZE = 64;
+//Writer thread's polling interval in nanoseconds
+constexpr long POLL_INTERVAL = 10000000L;
+//Fatal signals which flush the buffered records
+const int faults[] = { SIGSEGV, SIGBUS, SIGILL, SIGFPE, SIGABRT };
+
+//Structured log's file header and record types
+constexpr uint32_t STRUCTURED_MAGIC = 0x424C4857; //"WHLB"
+constexpr uint32_t STRUCTURED_VERSION = 1;
+enum : unsigned char {
+	SESSION, DEFINITION, EVENT
+};
+//Upper limit on the format identifiers accepted by the decoder
+constexpr uint32_t MAX_FORMATS = 1 << 20;
+
+void writeAll(int fd, iovec *iov, int count) noexcept {
+	while (count > 0) {
+		auto n = ::writev(fd, iov, count);
+		if (n == -1 && errno == EINTR) {
+			continue;
+		} else if (n <= 0) {
+			return;
+		}
+		//Partial write, skip the completed buffers
+		while (count > 0 && (size_t) n >= iov->iov_len) {
+			n -= iov->iov_len;
+			++iov;
+			--count;
+		}
+		if (count > 0) {
+			iov->iov_base = (char*) iov->iov_base + n;
+			iov->iov_len -= n;
+		}
+	}
+}
+
+//Fills in the header of a structured record
+void stamp(unsigned char *data, unsigned int length, unsigned char type,
+		unsigned char level, uint32_t id) noexcept {
+	timespec ts;
+	clock_gettime(CLOCK_REALTIME, &ts);
+	uint64_t time = ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+	uint16_t size = length;
+	memcpy(data, &size, sizeof(size));
+	data[2] = type;
+	data[3] = level;
+	memcpy(data + 4, &id, sizeof(id));
+	memcpy(data + 8, &time, sizeof(time));
+}
+
+//Translates the structured records into text
+struct Decoder {
+	static unsigned int size(const unsigned char *p) noexcept {
+		uint16_t n;
+		memcpy(&n, p, sizeof(n));
+		return n;
+	}
+
+	static uint32_t id(const unsigned char *p) noexcept {
+		uint32_t n;
+		memcpy(&n, p + 4, sizeof(n));
+		return n;
+	}
+
+	static unsigned int capacity(uint32_t id) noexcept {
+		unsigned int n = 64;
+		while (n <= id) {
+			n <<= 1;
+		}
+		return n;
+	}
+
+	static void print(FILE *stream, const unsigned char *event,
+			const unsigned char *definition) noexcept {
+		constexpr auto HEADER = wanhive::Logger::HEADER_SIZE;
+		uint64_t time;
+		memcpy(&time, event + 8, sizeof(time));
+		time_t seconds = time / 1000000000ULL;
+		tm t;
+		char date[32] = { '\0' };
+		if (localtime_r(&seconds, &t)) {
+			strftime(date, sizeof(date), "%Y-%m-%d %H:%M:%S", &t);
+		}
+		fprintf(stream, "%s.%06u ", date,
+				(unsigned int) ((time % 1000000000ULL) / 1000));
+
+		auto size = Decoder::size(definition ? definition : event);
+		if (!definition || size <= HEADER + 1
+				|| !memchr(definition + HEADER + 1, '\0', size - HEADER - 1)) {
+			fprintf(stream, "[format %u not found]\n", id(event));
+			return;
+		}
+
+		auto level = (event[3] <= wanhive::WH_LOGLEVEL_DEBUG) ? event[3] : 7;
+		auto function = (const char*) definition + HEADER + 1;
+		auto format = function + strlen(function) + 1;
+		if ((const unsigned char*) format >= definition + size
+				|| !memchr(format, '\0', definition + size
+						- (const unsigned char*) format)) {
+			fprintf(stream, "[format %u is corrupt]\n", id(event));
+			return;
+		} else if (definition[HEADER] == 1) {
+			fprintf(stream, "[%s]: ", levelNames[level]);
+		} else if (definition[HEADER] == 2) {
+			fprintf(stream, "[%s] [%s]: ", levelNames[level], function);
+		}
+		apply(stream, format, event + HEADER, event + Decoder::size(event));
+	}
+
+	//Reads the next argument
+	static bool next(const unsigned char *&p, const unsigned char *end,
+			char &type, uint64_t &value, const char *&text,
+			unsigned int &length) noexcept {
+		if (p >= end) {
+			return false;
+		}
+
+		type = *p;
+		if (type == 's' && p + 3 <= end) {
+			uint16_t n;
+			memcpy(&n, p + 1, sizeof(n));
+			if (p + 3 + n > end) {
+				return false;
+			}
+			text = (const char*) p + 3;
+			length = n;
+			p += 3 + n;
+			return true;
+		} else if (type != 's' && p + 9 <= end) {
+			memcpy(&value, p + 1, sizeof(value));
+			p += 9;
+			return true;
+		} else {
+			return false;
+		}
+	}
+
+	//Applies the format to the arguments
+	static void apply(FILE *stream, const char *format, const unsigned char *p,
+			const unsigned char *end) noexcept {
+		char type;
+		uint64_t value = 0;
+		const char *text = nullptr;
+		unsigned int length = 0;
+		char spec[64];
+		while (*format) {
+			if (*format != '%') {
+				fputc(*format++, stream);
+				continue;
+			} else if (format[1] == '%') {
+				fputc('%', stream);
+				format += 2;
+				continue;
+			}
+
+			//Rebuild the conversion specification for the stored types
+			unsigned int n = 0;
+			spec[n++] = *format++;
+			while (*format && strchr("-+ #0'", *format) && n < 32) {
+				spec[n++] = *format++;
+			}
+
+			for (int pass = 0; pass < 2; ++pass) {
+				if (pass && *format == '.') {
+					spec[n++] = *format++;
+				} else if (pass) {
+					break;
+				}
+
+				if (*format == '*') {
+					++format;
+					int x = next(p, end, type, value, text, length) ?
+							(int) value : 0;
+					n += snprintf(spec + n, 12, "%d", x);
+				} else {
+					while (*format >= '0' && *format <= '9' && n < 48) {
+						spec[n++] = *format++;
+					}
+				}
+			}
+
+			while (*format && strchr("hlLqjzt", *format)) {
+				++format;
+			}
+
+			auto conversion = *format;
+			if (!conversion) {
+				break;
+			}
+			++format;
+
+			if (!next(p, end, type, value, text, length)) {
+				fputs("<?>", stream);
+				continue;
+			}
+
+			switch (conversion) {
+			case 'd':
+			case 'i':
+				memcpy(spec + n, "lld", 4);
+				fprintf(stream, spec, (long long) value);
+				break;
+			case 'u':
+			case 'o':
+			case 'x':
+			case 'X':
+				spec[n++] = 'l';
+				spec[n++] = 'l';
+				spec[n++] = conversion;
+				spec[n] = '\0';
+				fprintf(stream, spec, (unsigned long long) value);
+				break;
+			case 'c':
+				spec[n++] = conversion;
+				spec[n] = '\0';
+				fprintf(stream, spec, (int) value);
+				break;
+			case 'e':
+			case 'E':
+			case 'f':
+			case 'F':
+			case 'g':
+			case 'G':
+			case 'a':
+			case 'A': {
+				double x;
+				if (type == 'd') {
+					memcpy(&x, &value, sizeof(x));
+				} else {
+					x = (double) (long long) value;
+				}
+				spec[n++] = conversion;
+				spec[n] = '\0';
+				fprintf(stream, spec, x);
+				break;
+			}
+			case 's':
+				if (type == 's') {
+					char s[wanhive::Logger::RECORD_SIZE];
+					length = (length < sizeof(s)) ? length : (sizeof(s) - 1);
+					memcpy(s, text, length);
+					s[length] = '\0';
+					spec[n++] = 's';
+					spec[n] = '\0';
+					fprintf(stream, spec, s);
+				} else {
+					fputs("<?>", stream);
+				}
+				break;
+			case 'p':
+				fprintf(stream, "%p", (void*) (uintptr_t) value);
+				break;
+			default:
+				break;
+			}
+		}
+	}
+};
+
 }  // namespace
 
 namespace wanhive {
 
+/*
+ * Bounded multi-producer single-consumer queue of the formatted records. Each
+ * slot carries a sequence number which tells the producers and the consumer
+ * whether the slot is free or holds a committed record.
+ */
+struct Logger::Ring {
+	struct Record {
+		unsigned long long sequence;
+		unsigned int length;
+		LogLevel level;
+		bool binary; //Structured record
+		char text[RECORD_SIZE];
+	};
+
+	Record *records;
+	unsigned long long mask;
+	alignas(64) unsigned long long head; //Next slot to claim
+	alignas(64) unsigned long long tail; //Next slot to write out
+	alignas(64) unsigned long long dropped;
+	unsigned long long reported;
+	LogOverflow policy;
+	bool running;
+	bool sleeping;
+	pthread_t thread;
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	const Logger *logger;
+
+	Ring(unsigned long long capacity) :
+			records(new Record[capacity]), mask(capacity - 1), head(0), tail(0),
+			dropped(0), reported(0), policy(WH_LOG_COUNT), running(false),
+			sleeping(false), thread(), logger(nullptr) {
+		pthread_mutex_init(&mutex, nullptr);
+		pthread_cond_init(&cond, nullptr);
+		reset();
+	}
+
+	~Ring() {
+		pthread_cond_destroy(&cond);
+		pthread_mutex_destroy(&mutex);
+		delete[] records;
+	}
+
+	void reset() noexcept {
+		for (unsigned long long i = 0; i <= mask; ++i) {
+			records[i].sequence = i;
+		}
+		head = 0;
+		tail = 0;
+		dropped = 0;
+		reported = 0;
+	}
+
+	Record* claim() noexcept {
+		auto pos = Atomic<unsigned long long>::load(&head, MO_RELAXED);
+		while (true) {
+			auto r = &records[pos & mask];
+			auto seq = Atomic<unsigned long long>::load(&r->sequence, MO_ACQUIRE);
+			auto diff = (long long) (seq - pos);
+			if (diff == 0) {
+				if (Atomic<unsigned long long>::compareExchange(&head, &pos, pos + 1,
+						MO_RELAXED, MO_RELAXED, true)) {
+					return r;
+				}
+			} else if (diff < 0) {
+				return nullptr; //Full
+			} else {
+				pos = Atomic<unsigned long long>::load(&head, MO_RELAXED);
+			}
+		}
+	}
+
+	//Claims a slot according to the overflow policy
+	Record* acquire(bool reliable) noexcept {
+		auto record = claim();
+		while (!record && (reliable || policy == WH_LOG_BLOCK)
+				&& Atomic<bool>::load(&running, MO_ACQUIRE)) {
+			wake();
+			sched_yield();
+			record = claim();
+		}
+
+		if (!record) {
+			Atomic<unsigned long long>::fetchAndAdd(&dropped, 1ULL, MO_RELAXED);
+		}
+		return record;
+	}
+
+	void commit(Record *r) noexcept {
+		auto seq = Atomic<unsigned long long>::load(&r->sequence, MO_RELAXED);
+		Atomic<unsigned long long>::store(&r->sequence, seq + 1, MO_RELEASE);
+		//The writer polls, wake it up only if a full batch is waiting
+		if (Atomic<bool>::load(&sleeping, MO_RELAXED)
+				&& seq - Atomic<unsigned long long>::load(&tail, MO_RELAXED)
+						>= (mask < BATCH_SIZE ? (mask + 1) / 2 : BATCH_SIZE)) {
+			wake();
+		}
+	}
+
+	//Returns the next committed record (consumer only)
+	Record* peek(unsigned long long pos) const noexcept {
+		auto r = &records[pos & mask];
+		if (Atomic<unsigned long long>::load(&r->sequence, MO_SEQ_CST) == pos + 1) {
+			return r;
+		} else {
+			return nullptr;
+		}
+	}
+
+	//Releases the records up to the given position (consumer only)
+	void release(unsigned long long pos) noexcept {
+		for (auto i = tail; i < pos; ++i) {
+			Atomic<unsigned long long>::store(&records[i & mask].sequence, i + mask + 1,
+					MO_RELEASE);
+		}
+		Atomic<unsigned long long>::store(&tail, pos, MO_RELEASE);
+	}
+
+	bool isEmpty() const noexcept {
+		return Atomic<unsigned long long>::load(&tail, MO_ACQUIRE)
+				== Atomic<unsigned long long>::load(&head, MO_ACQUIRE);
+	}
+
+	void wake() noexcept {
+		pthread_mutex_lock(&mutex);
+		pthread_cond_signal(&cond);
+		pthread_mutex_unlock(&mutex);
+	}
+
+	void sleep() noexcept {
+		pthread_mutex_lock(&mutex);
+		Atomic<bool>::store(&sleeping, true, MO_SEQ_CST);
+		if (!peek(tail) && Atomic<bool>::load(&running, MO_ACQUIRE)) {
+			timespec ts;
+			clock_gettime(CLOCK_REALTIME, &ts);
+			ts.tv_nsec += POLL_INTERVAL;
+			if (ts.tv_nsec >= 1000000000L) {
+				ts.tv_sec += 1;
+				ts.tv_nsec -= 1000000000L;
+			}
+			pthread_cond_timedwait(&cond, &mutex, &ts);
+		}
+		Atomic<bool>::store(&sleeping, false, MO_SEQ_CST);
+		pthread_mutex_unlock(&mutex);
+	}
+
+	//Writes out a batch of records, returns the number of records written
+	unsigned int drain() noexcept {
+		iovec iov[BATCH_SIZE];
+		iovec bin[BATCH_SIZE];
+		unsigned int n = 0;
+		unsigned int b = 0;
+		auto pos = tail;
+		for (Record *r; pos - tail < BATCH_SIZE && (r = peek(pos)); ++pos) {
+			if (!r->length) {
+				continue;
+			} else if (r->binary) {
+				bin[b].iov_base = r->text;
+				bin[b].iov_len = r->length;
+				++b;
+			} else if (logger->getTarget() == WH_LOG_STDERR) {
+				iov[n].iov_base = r->text;
+				iov[n].iov_len = r->length;
+				++n;
+			} else {
+				logger->write(r->level, r->text, r->length);
+			}
+		}
+
+		if (n) {
+			writeAll(STDERR_FILENO, iov, n);
+		}
+
+		if (b) {
+			auto slot = logger->enter();
+			auto fd = Atomic<int>::load(&logger->structured, MO_SEQ_CST);
+			if (fd != -1) {
+				writeAll(fd, bin, b);
+			}
+			logger->leave(slot);
+		}
+		auto count = (unsigned int) (pos - tail);
+		release(pos);
+		report();
+		return count;
+	}
+
+	void report() noexcept {
+		auto n = Atomic<unsigned long long>::load(&dropped, MO_RELAXED);
+		if (policy == WH_LOG_COUNT && n != reported) {
+			char text[128];
+			auto length = snprintf(text, sizeof(text),
+					"[%s]: %llu log records dropped\n",
+					Logger::levelString(WH_LOGLEVEL_WARNING), n - reported);
+			logger->write(WH_LOGLEVEL_WARNING, text, length);
+			reported = n;
+		}
+	}
+};
+
+namespace {
+//Ring buffer flushed by the fatal signals
+void *volatile faulting = nullptr;
+}  // namespace
+
 Logger::Logger() noexcept :
 		level(WH_LOGLEVEL_DEBUG), target(WH_LOG_STDERR) {
 
 }
 
 Logger::~Logger() {
-
+	stop();
+	delete retired;
 }
 
 void Logger::setLevel(unsigned int level) noexcept {
@@ -103,21 +584,400 @@ void Logger::log(LogLevel level, const char *format, ...) const noexcept {
 	if (level <= Logger::level) {
 		va_list ap;
 		va_start(ap, format);
-		switch (Logger::target) {
-		case WH_LOG_STDERR:
-			//POSIX-compliant vfprintf is thread safe
-			vfprintf(stderr, format, ap);
-			break;
-		case WH_LOG_SYS:
+		vlog(level, "", format, ap);
+		va_end(ap);
+	} else {
+		return;
+	}
+}
+
+void Logger::vlog(LogLevel level, const char *prefix, const char *format,
+		va_list ap) const noexcept {
+	auto slot = enter();
+	auto r = Atomic<Ring*>::load(&ring, MO_SEQ_CST);
+	if (r) {
+		auto record = r->acquire(false);
+		if (!record) {
+			leave(slot);
+			return;
+		}
+
+		va_list aq;
+		va_copy(aq, ap);
+		auto m = strnlen(prefix, sizeof(record->text) - 1);
+		memcpy(record->text, prefix, m);
+		auto n = vsnprintf(record->text + m, sizeof(record->text) - m, format,
+				aq);
+		va_end(aq);
+		record->binary = false;
+		if (n >= 0 && m + n < sizeof(record->text)) {
+			record->length = m + n;
+			record->level = level;
+			r->commit(record);
+			leave(slot);
+			return;
+		}
+
+		//Too long for a slot: preserve the order and write it synchronously
+		record->length = 0;
+		r->commit(record);
+		flush();
+	}
+	leave(slot);
+
+	switch (Logger::target) {
+	case WH_LOG_STDERR:
+		//POSIX-compliant stdio is thread safe, the lock keeps the parts together
+		flockfile(stderr);
+		fputs(prefix, stderr);
+		vfprintf(stderr, format, ap);
+		funlockfile(stderr);
+		break;
+	case WH_LOG_SYS:
+		if (*prefix) {
+			char text[2048];
+			auto m = snprintf(text, sizeof(text), "%s", prefix);
+			if (m >= 0 && (size_t) m < sizeof(text)) {
+				vsnprintf(text + m, sizeof(text) - m, format, ap);
+			}
+			syslog(priorities[level], "%s", text);
+		} else {
 			vsyslog(priorities[level], format, ap);
-			break;
-		default:
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+void Logger::print(const LogSite *site, ...) const noexcept {
+	char prefix[256];
+	switch (site->prefix) {
+	case 1:
+		snprintf(prefix, sizeof(prefix), "[%s]: ", levelString(site->level));
+		break;
+	case 2:
+		snprintf(prefix, sizeof(prefix), "[%s] [%s]: ",
+				levelString(site->level), site->function);
+		break;
+	default:
+		prefix[0] = '\0';
+		break;
+	}
+
+	va_list ap;
+	va_start(ap, site);
+	vlog(site->level, prefix, site->format, ap);
+	va_end(ap);
+}
+
+void Logger::emit(LogSite &site, unsigned char *data,
+		unsigned int length) const noexcept {
+	auto current = Atomic<unsigned int>::load(&generation, MO_ACQUIRE);
+	auto key = Atomic<unsigned long long>::load(&site.key, MO_ACQUIRE);
+	uint32_t id = key;
+	if ((key >> 32) != current || !id) {
+		//First use of the call site in this session
+		id = define(site);
+		Atomic<unsigned long long>::store(&site.key,
+				((unsigned long long) current << 32) | id, MO_RELEASE);
+	}
+
+	stamp(data, length, EVENT, site.level, id);
+	push(data, length, false);
+}
+
+unsigned int Logger::define(const LogSite &site) const noexcept {
+	auto id = Atomic<unsigned int>::addAndFetch(&sites, 1, MO_RELAXED);
+	unsigned char data[RECORD_SIZE];
+	unsigned int length = HEADER_SIZE;
+	data[length++] = site.prefix;
+	auto n = strnlen(site.function, 255);
+	memcpy(data + length, site.function, n);
+	length += n;
+	data[length++] = '\0';
+	n = strnlen(site.format, RECORD_SIZE - length - 1);
+	memcpy(data + length, site.format, n);
+	length += n;
+	data[length++] = '\0';
+	stamp(data, length, DEFINITION, site.level, id);
+	push(data, length, true);
+	return id;
+}
+
+void Logger::push(const void *data, unsigned int length,
+		bool reliable) const noexcept {
+	auto slot = enter();
+	auto r = Atomic<Ring*>::load(&ring, MO_SEQ_CST);
+	if (r) {
+		auto record = r->acquire(reliable);
+		if (record) {
+			memcpy(record->text, data, length);
+			record->length = length;
+			record->binary = true;
+			r->commit(record);
+		}
+	} else if (auto fd = Atomic<int>::load(&structured, MO_SEQ_CST); fd
+			!= -1) {
+		//O_APPEND keeps the records together
+		if (::write(fd, data, length) == -1) {
+			//Nothing to do
+		}
+	}
+	leave(slot);
+}
+
+void Logger::encode(unsigned char *data, unsigned int &length,
+		const char *value, int) noexcept {
+	if (!value) {
+		value = "(null)";
+	}
+
+	if (length + 3 <= RECORD_SIZE) {
+		uint16_t n = strnlen(value, RECORD_SIZE - length - 3);
+		data[length] = 's';
+		memcpy(data + length + 1, &n, sizeof(n));
+		memcpy(data + length + 3, value, n);
+		length += 3 + n;
+	}
+}
+
+bool Logger::openStructured(const char *path) noexcept {
+	closeStructured();
+	auto fd = ::open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+	if (fd == -1) {
+		return false;
+	}
+
+	struct stat sb;
+	if (fstat(fd, &sb) == -1) {
+		::close(fd);
+		return false;
+	}
+
+	const uint32_t header[2] = { STRUCTURED_MAGIC, STRUCTURED_VERSION };
+	if (!sb.st_size && ::write(fd, header, sizeof(header)) != sizeof(header)) {
+		::close(fd);
+		return false;
+	}
+
+	//The identifiers restart from one in each session
+	Atomic<unsigned int>::store(&sites, 0, MO_RELAXED);
+	Atomic<unsigned int>::fetchAndAdd(&generation, 1, MO_RELEASE);
+	Atomic<int>::store(&structured, fd, MO_SEQ_CST);
+
+	unsigned char data[HEADER_SIZE];
+	stamp(data, HEADER_SIZE, SESSION, WH_LOGLEVEL_EMERGENCY, 0);
+	push(data, HEADER_SIZE, true);
+	return true;
+}
+
+void Logger::closeStructured() noexcept {
+	if (!isStructured()) {
+		return;
+	}
+
+	flush();
+	auto fd = Atomic<int>::exchange(&structured, -1, MO_SEQ_CST);
+	//The callers and the writer thread may still be writing to the file
+	synchronize();
+	if (fd != -1) {
+		::close(fd);
+	}
+}
+
+bool Logger::decode(const char *path, FILE *stream) noexcept {
+	auto fp = fopen(path, "rb");
+	if (!fp) {
+		return false;
+	}
+
+	//Slurp the log
+	unsigned char *buffer = nullptr;
+	size_t size = 0;
+	size_t capacity = 0;
+	while (true) {
+		if (size == capacity) {
+			capacity = capacity ? (capacity << 1) : 65536;
+			auto p = (unsigned char*) realloc(buffer, capacity);
+			if (!p) {
+				break;
+			}
+			buffer = p;
+		}
+
+		auto n = fread(buffer + size, 1, capacity - size, fp);
+		if (n == 0) {
 			break;
 		}
-		va_end(ap);
+		size += n;
+	}
+	auto error = ferror(fp) || (size && !buffer);
+	fclose(fp);
+
+	uint32_t header[2] = { 0, 0 };
+	if (!error && size >= sizeof(header)) {
+		memcpy(header, buffer, sizeof(header));
+	}
+
+	if (error || header[0] != STRUCTURED_MAGIC
+			|| header[1] != STRUCTURED_VERSION) {
+		free(buffer);
+		return false;
+	}
+	//-----------------------------------------------------------------
+	auto end = buffer + size;
+	auto session = buffer + sizeof(header);
+	const unsigned char **formats = nullptr;
+	unsigned int count = 0;
+	while (session < end) {
+		//The session's boundary
+		auto limit = session;
+		for (auto p = session; p + HEADER_SIZE <= end;) {
+			auto length = Decoder::size(p);
+			if (length < HEADER_SIZE || length > RECORD_SIZE || p + length > end
+					|| (p != session && p[2] == SESSION)) {
+				break;
+			}
+			p += length;
+			limit = p;
+		}
+
+		if (limit == session) {
+			break; //Truncated or corrupt
+		}
+
+		//The definitions may trail the records of the concurrent callers
+		for (auto p = session; p < limit; p += Decoder::size(p)) {
+			auto id = Decoder::id(p);
+			if (p[2] != DEFINITION) {
+				continue;
+			} else if (id >= MAX_FORMATS) {
+				continue;
+			} else if (id >= count) {
+				auto n = Decoder::capacity(id);
+				auto q = (const unsigned char**) realloc(formats,
+						n * sizeof(*formats));
+				if (!q) {
+					continue;
+				}
+				memset(q + count, 0, (n - count) * sizeof(*q));
+				formats = q;
+				count = n;
+			}
+			formats[id] = p;
+		}
+
+		for (auto p = session; p < limit; p += Decoder::size(p)) {
+			auto id = Decoder::id(p);
+			if (p[2] == EVENT) {
+				Decoder::print(stream, p,
+						(id < count) ? formats[id] : nullptr);
+			}
+		}
+
+		if (count) {
+			memset(formats, 0, count * sizeof(*formats));
+		}
+		session = limit;
+	}
+
+	free(formats);
+	free(buffer);
+	return true;
+}
+
+bool Logger::start(unsigned int capacity, LogOverflow policy) noexcept {
+	if (ring || !capacity) {
+		return false;
+	}
+
+	//Round up to the next power of two
+	unsigned long long size = 1;
+	while (size < capacity) {
+		size <<= 1;
+	}
+
+	Ring *r = nullptr;
+	if (retired && retired->mask + 1 == size) {
+		r = retired;
+		r->reset();
 	} else {
+		r = new (std::nothrow) Ring(size);
+		if (!r || !r->records) {
+			delete r;
+			return false;
+		}
+		delete retired;
+	}
+	retired = nullptr;
+
+	r->policy = policy;
+	r->logger = this;
+	Atomic<bool>::store(&r->running, true, MO_RELEASE);
+	if (pthread_create(&r->thread, nullptr, writer, r)) {
+		Atomic<bool>::store(&r->running, false, MO_RELEASE);
+		retired = r;
+		return false;
+	}
+
+	Atomic<Ring*>::store(&ring, r, MO_RELEASE);
+	//Flush the buffered records on the unhandled fatal signals
+	faulting = r;
+	for (auto signum : faults) {
+		struct sigaction sa;
+		if (sigaction(signum, nullptr, &sa) == 0 && sa.sa_handler == SIG_DFL) {
+			sa.sa_handler = onFault;
+			sigemptyset(&sa.sa_mask);
+			sa.sa_flags = SA_RESETHAND;
+			sigaction(signum, &sa, nullptr);
+		}
+	}
+	return true;
+}
+
+void Logger::stop() noexcept {
+	auto r = Atomic<Ring*>::exchange(&ring, nullptr, MO_SEQ_CST);
+	if (!r) {
 		return;
 	}
+
+	for (auto signum : faults) {
+		struct sigaction sa;
+		if (sigaction(signum, nullptr, &sa) == 0 && sa.sa_handler == onFault) {
+			signal(signum, SIG_DFL);
+		}
+	}
+	if (faulting == r) {
+		faulting = nullptr;
+	}
+
+	Atomic<bool>::store(&r->running, false, MO_RELEASE);
+	r->wake();
+	pthread_join(r->thread, nullptr);
+	//The late records, committed before the callers left the ring
+	synchronize();
+	while (r->drain()) {
+	}
+	//No caller can reach the ring anymore, keep it for the next start
+	retired = r;
+}
+
+void Logger::flush() const noexcept {
+	auto r = Atomic<Ring*>::load(&ring, MO_ACQUIRE);
+	while (r && Atomic<bool>::load(&r->running, MO_ACQUIRE) && !r->isEmpty()) {
+		r->wake();
+		sched_yield();
+	}
+}
+
+bool Logger::isAsynchronous() const noexcept {
+	return Atomic<Ring*>::load(&ring, MO_ACQUIRE) != nullptr;
+}
+
+unsigned long long Logger::getDropped() const noexcept {
+	auto r = Atomic<Ring*>::load(&ring, MO_ACQUIRE);
+	return r ? Atomic<unsigned long long>::load(&r->dropped, MO_RELAXED) : 0;
 }
 
 Logger& Logger::getDefault() noexcept {
@@ -133,4 +993,88 @@ const char* Logger::targetString(LogTarget target) noexcept {
 	return targetNames[target];
 }
 
+const char* Logger::overflowString(LogOverflow policy) noexcept {
+	return overflowNames[policy];
+}
+
+void Logger::write(LogLevel level, const char *text,
+		unsigned int length) const noexcept {
+	switch (Logger::target) {
+	case WH_LOG_STDERR: {
+		iovec iov = { (void*) text, length };
+		writeAll(STDERR_FILENO, &iov, 1);
+		break;
+	}
+	case WH_LOG_SYS:
+		syslog(priorities[level], "%.*s", (int) length, text);
+		break;
+	default:
+		break;
+	}
+}
+
+unsigned int Logger::enter() const noexcept {
+	auto slot = Atomic<unsigned int>::load(&epoch, MO_SEQ_CST) & 1;
+	Atomic<unsigned int>::fetchAndAdd(&callers[slot], 1, MO_SEQ_CST);
+	return slot;
+}
+
+void Logger::leave(unsigned int slot) const noexcept {
+	Atomic<unsigned int>::fetchAndSub(&callers[slot], 1, MO_RELEASE);
+}
+
+void Logger::synchronize() const noexcept {
+	//Two advances: a caller may register in the old slot after the first one
+	for (unsigned int i = 0; i < 2; ++i) {
+		auto slot = Atomic<unsigned int>::fetchAndAdd(&epoch, 1, MO_SEQ_CST)
+				& 1;
+		while (Atomic<unsigned int>::load(&callers[slot], MO_ACQUIRE)) {
+			sched_yield();
+		}
+	}
+}
+
+void* Logger::writer(void *arg) noexcept {
+	//Signals are delivered to the other threads
+	sigset_t ss;
+	sigfillset(&ss);
+	pthread_sigmask(SIG_SETMASK, &ss, nullptr);
+
+	auto r = static_cast<Ring*>(arg);
+	while (true) {
+		if (r->drain()) {
+			continue;
+		} else if (!Atomic<bool>::load(&r->running, MO_ACQUIRE)) {
+			break;
+		} else {
+			r->sleep();
+		}
+	}
+	return nullptr;
+}
+
+void Logger::onFault(int signum) noexcept {
+	//Best effort, uses only the async-signal-safe calls
+	auto r = static_cast<Ring*>(faulting);
+	if (r) {
+		auto pos = Atomic<unsigned long long>::load(&r->tail, MO_ACQUIRE);
+		auto fd = Atomic<int>::load(&r->logger->structured, MO_RELAXED);
+		for (Ring::Record *record; (record = r->peek(pos)); ++pos) {
+			if (!record->length) {
+				continue;
+			} else if (record->binary && fd != -1) {
+				if (::write(fd, record->text, record->length) < 0) {
+					break;
+				}
+			} else if (!record->binary
+					&& ::write(STDERR_FILENO, record->text, record->length)
+							< 0) {
+				break;
+			}
+		}
+	}
+	//SA_RESETHAND restored the default action
+	raise(signum);
+}
+
 } /* namespace wanhive */
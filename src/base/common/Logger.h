@@ -12,7 +12,12 @@
 
 #ifndef WH_BASE_COMMON_LOGGER_H_
 #define WH_BASE_COMMON_LOGGER_H_
+#include "Atomic.h"
 #include "defines.h"
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
 
 namespace wanhive {
 /**
@@ -37,9 +42,37 @@ enum LogTarget : unsigned char {
 	WH_LOG_SYS /**< Use syslog */
 };
 
+/**
+ * Enumeration of overflow policies of the asynchronous logger
+ */
+enum LogOverflow : unsigned char {
+	WH_LOG_DROP, /**< Discard the record */
+	WH_LOG_COUNT, /**< Discard the record and report the count later */
+	WH_LOG_BLOCK /**< Wait for the free space */
+};
+
+/**
+ * Call site of a logging macro (see WH_LOG_EMIT)
+ */
+struct LogSite {
+	/** Message's level/priority */
+	LogLevel level;
+	/** Prefix: 0 for none, 1 for the level, 2 for the level and function */
+	unsigned char prefix;
+	/** Name of the calling function */
+	const char *function;
+	/** Message's format (same as the printf format string) */
+	const char *format;
+	/** Structured log's generation and format identifier (zero initialized) */
+	unsigned long long key;
+};
+
 /**
  * Thread-safe logging utility for sending application-generated logs
- * to syslog or stderr.
+ * to syslog or stderr. In the asynchronous mode the callers format the records
+ * into a lock-free ring buffer and a background thread writes them out in
+ * batches. In the structured mode the logging macros capture the raw arguments
+ * into binary records which are decoded offline (see Logger::decode()).
  */
 class Logger {
 public:
@@ -91,6 +124,90 @@ public:
 	 * @param format message's format (same as the printf format string).
 	 */
 	void log(LogLevel level, const char *format, ...) const noexcept;
+	/**
+	 * Checks whether the current priority (level) filter accepts a message.
+	 * @param level message's level/priority
+	 * @return true if the message should be logged, false otherwise
+	 */
+	bool isEnabled(LogLevel level) const noexcept {
+		return level <= this->level;
+	}
+	/**
+	 * Writes a message log from a call site, captures the raw arguments into a
+	 * binary record in the structured mode.
+	 * @param site the call site
+	 * @param args message's arguments (integers, floating point numbers,
+	 * strings, and pointers)
+	 */
+	template<typename ...Args>
+	void record(LogSite &site, Args ...args) const noexcept {
+		if (!isStructured()) {
+			print(&site, args...);
+		} else {
+			unsigned char data[RECORD_SIZE];
+			unsigned int length = HEADER_SIZE;
+			(encode(data, length, args), ...);
+			emit(site, data, length);
+		}
+	}
+	//-----------------------------------------------------------------
+	/**
+	 * Switches to the structured mode: the records written through the
+	 * logging macros are appended in the binary form to the given file.
+	 * @param path pathname of the structured log
+	 * @return true on success, false on error
+	 */
+	bool openStructured(const char *path) noexcept;
+	/**
+	 * Writes out the buffered records, closes the structured log and switches
+	 * back to the text mode.
+	 */
+	void closeStructured() noexcept;
+	/**
+	 * Checks whether the logger is running in the structured mode.
+	 * @return true if the structured log is open, false otherwise
+	 */
+	bool isStructured() const noexcept {
+		return Atomic<int>::load(&structured, MO_RELAXED) != -1;
+	}
+	/**
+	 * Translates a structured log into the text form.
+	 * @param path pathname of the structured log
+	 * @param stream the output stream
+	 * @return true on success, false on error (invalid or missing file)
+	 */
+	static bool decode(const char *path, FILE *stream) noexcept;
+	//-----------------------------------------------------------------
+	/**
+	 * Switches to the asynchronous mode and starts the writer thread. The
+	 * records still in the buffer get written out on fatal signals (SIGSEGV,
+	 * SIGBUS, SIGILL, SIGFPE, SIGABRT) if these signals are not handled.
+	 * @param capacity ring buffer's capacity in records (rounded up to the
+	 * next power of two).
+	 * @param policy the overflow policy
+	 * @return true on success, false on error or if the writer thread is
+	 * already running.
+	 */
+	bool start(unsigned int capacity, LogOverflow policy = WH_LOG_COUNT) noexcept;
+	/**
+	 * Writes out the buffered records, stops the writer thread and switches
+	 * back to the synchronous mode.
+	 */
+	void stop() noexcept;
+	/**
+	 * Waits until the writer thread has written out the buffered records.
+	 */
+	void flush() const noexcept;
+	/**
+	 * Checks whether the logger is running in the asynchronous mode.
+	 * @return true if the writer thread is running, false otherwise
+	 */
+	bool isAsynchronous() const noexcept;
+	/**
+	 * Returns the number of records discarded due to the buffer's overflow.
+	 * @return dropped records count
+	 */
+	unsigned long long getDropped() const noexcept;
 	//-----------------------------------------------------------------
 	/**
 	 * Returns the default logger that writes to the stderr.
@@ -109,9 +226,78 @@ public:
 	 * @return the output target describing string
 	 */
 	static const char* targetString(LogTarget target) noexcept;
+	/**
+	 * Returns a string that describes the overflow policy.
+	 * @param policy the overflow policy's code
+	 * @return the overflow policy describing string
+	 */
+	static const char* overflowString(LogOverflow policy) noexcept;
+	/** Maximum size in bytes of a buffered record */
+	static constexpr unsigned int RECORD_SIZE = 1008;
+	/** Structured record's header size in bytes (size, type, level, id, time) */
+	static constexpr unsigned int HEADER_SIZE = 16;
+private:
+	struct Ring;
+	void vlog(LogLevel level, const char *prefix, const char *format,
+			va_list ap) const noexcept;
+	void print(const LogSite *site, ...) const noexcept;
+	void emit(LogSite &site, unsigned char *data,
+			unsigned int length) const noexcept;
+	unsigned int define(const LogSite &site) const noexcept;
+	void push(const void *data, unsigned int length,
+			bool reliable) const noexcept;
+	void write(LogLevel level, const char *text, unsigned int length) const noexcept;
+	static void* writer(void *arg) noexcept;
+	static void onFault(int signum) noexcept;
+	//Registers a caller which uses the ring or the structured log
+	unsigned int enter() const noexcept;
+	void leave(unsigned int slot) const noexcept;
+	//Waits for the callers registered before the call to leave
+	void synchronize() const noexcept;
+
+	template<typename T>
+	static void encode(unsigned char *data, unsigned int &length,
+			T value) noexcept {
+		if constexpr (std::is_same_v<T, char*> || std::is_same_v<T, const char*>) {
+			encode(data, length, (const char*) value, 0);
+		} else if constexpr (std::is_floating_point_v<T>) {
+			double v = value;
+			encode(data, length, 'd', &v);
+		} else if constexpr (std::is_enum_v<T> || std::is_signed_v<T>) {
+			long long v = value;
+			encode(data, length, 'i', &v);
+		} else if constexpr (std::is_integral_v<T>) {
+			unsigned long long v = value;
+			encode(data, length, 'u', &v);
+		} else if constexpr (std::is_pointer_v<T>) {
+			unsigned long long v = (unsigned long long) value;
+			encode(data, length, 'p', &v);
+		} else {
+			static_assert(!sizeof(T), "Unsupported log argument");
+		}
+	}
+
+	static void encode(unsigned char *data, unsigned int &length, char type,
+			const void *value) noexcept {
+		if (length + 9 <= RECORD_SIZE) {
+			data[length] = type;
+			memcpy(data + length + 1, value, 8);
+			length += 9;
+		}
+	}
+
+	static void encode(unsigned char *data, unsigned int &length,
+			const char *value, int) noexcept;
 private:
 	volatile LogLevel level;
 	volatile LogTarget target;
+	Ring *ring { nullptr }; //Non-null in the asynchronous mode
+	Ring *retired { nullptr }; //Stopped ring, reused by the next start
+	int structured { -1 }; //Structured log's file descriptor
+	mutable unsigned int epoch { 0 }; //Selects the callers' slot
+	mutable unsigned int callers[2] { 0, 0 }; //Callers in each slot
+	mutable unsigned int generation { 0 }; //Incremented on each open
+	mutable unsigned int sites { 0 }; //Formats defined in this generation
 };
 
 //=================================================================
@@ -124,9 +310,20 @@ private:
 #define WH_DEFAULT_LOGGER Logger::getDefault()
 #define WH_LOG_LEVEL_STR(l) Logger::levelString(l)
 
-#define WH_LOG(l, format, ...) WH_DEFAULT_LOGGER.log(l, format "\n", ##__VA_ARGS__)
-#define WH_LOGL(l, format, ...) WH_LOG(l, "[%s]: " format, WH_LOG_LEVEL_STR(l), ##__VA_ARGS__)
-#define WH_LOGLF(l, format, ...) WH_LOG(l, "[%s] [%s]: " format, WH_LOG_LEVEL_STR(l), WH_FUNCTION, ##__VA_ARGS__)
+/*
+ * Messages below this level are compiled out. The arguments of a compiled out
+ * message are not evaluated.
+ */
+#ifndef WH_LOG_MIN_LEVEL
+#define WH_LOG_MIN_LEVEL WH_LOGLEVEL_DEBUG
+#endif
+
+#define WH_LOG_ENABLED(l) ((l) <= WH_LOG_MIN_LEVEL && WH_DEFAULT_LOGGER.isEnabled(l))
+#define WH_LOG_EMIT(l, prefix, format, ...) do { if (WH_LOG_ENABLED(l)) { static LogSite _whLogSite = { (l), (prefix), WH_FUNCTION, format "\n", 0 }; WH_DEFAULT_LOGGER.record(_whLogSite, ##__VA_ARGS__); } } while (0)
+
+#define WH_LOG(l, format, ...) WH_LOG_EMIT(l, 0, format, ##__VA_ARGS__)
+#define WH_LOGL(l, format, ...) WH_LOG_EMIT(l, 1, format, ##__VA_ARGS__)
+#define WH_LOGLF(l, format, ...) WH_LOG_EMIT(l, 2, format, ##__VA_ARGS__)
 //-----------------------------------------------------------------
 //For general logging
 #define WH_LOG_DEBUG(format, ...) WH_LOGLF(WH_LOGLEVEL_DEBUG, format, ##__VA_ARGS__)
@@ -46,9 +46,13 @@
 
 #include "Encoding.h"
 #include "Twiddler.h"
+#include "../common/Atomic.h"
 #include <cctype>
 #include <cstdio>
 #include <cstring>
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#endif
 
 namespace {
 
@@ -171,6 +175,562 @@ const unsigned char *INVERSE_LISTS[] = { BASE16_INVERSE_LIST,
 const char *testVectors[] = { "", "f", "fo", "foo", "foob", "fooba", "foobar",
 		nullptr };
 
+/*
+ * Vectorized kernels: each one consumes the input in whole blocks while the
+ * blocks are valid and returns the number of consumed input bytes, the scalar
+ * code completes the rest (including the padding and the error handling).
+ * Ref: W. Mula, D. Lemire, "Faster Base64 Encoding and Decoding Using AVX2
+ * Instructions", ACM Transactions on the Web 12(3), 2018.
+ */
+using Encoder = unsigned int (*)(char *dest, const unsigned char *src,
+		unsigned int length) noexcept;
+using Decoder = unsigned int (*)(unsigned char *dest, const char *src,
+		unsigned int length) noexcept;
+using Validator = unsigned int (*)(const char *src,
+		unsigned int length) noexcept;
+
+struct Kernels {
+	const char *name;
+	Encoder encoders[3]; //Indexed by the EncodingBase
+	Decoder decoders[3];
+	Validator validators[3];
+};
+
+unsigned int encodeNone(char*, const unsigned char*, unsigned int) noexcept {
+	return 0;
+}
+
+unsigned int decodeNone(unsigned char*, const char*, unsigned int) noexcept {
+	return 0;
+}
+
+unsigned int validateNone(const char*, unsigned int) noexcept {
+	return 0;
+}
+
+const Kernels SCALAR = { "scalar", { encodeNone, encodeNone, encodeNone }, {
+		decodeNone, decodeNone, decodeNone }, { validateNone, validateNone,
+		validateNone } };
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define WH_SSE41 __attribute__((target("sse4.1")))
+#define WH_AVX2 __attribute__((target("avx2")))
+//-----------------------------------------------------------------
+//Character class masks (signed comparisons reject the bytes above 0x7F)
+WH_SSE41 inline __m128i within(__m128i in, char low, char high) noexcept {
+	return _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8(low - 1)),
+			_mm_cmpgt_epi8(_mm_set1_epi8(high + 1), in));
+}
+
+WH_AVX2 inline __m256i within(__m256i in, char low, char high) noexcept {
+	return _mm256_and_si256(_mm256_cmpgt_epi8(in, _mm256_set1_epi8(low - 1)),
+			_mm256_cmpgt_epi8(_mm256_set1_epi8(high + 1), in));
+}
+
+//Base-16 values of the characters, fails on an invalid character
+template<bool LOWERCASE>
+WH_SSE41 inline bool values16(__m128i in, __m128i &values) noexcept {
+	auto digit = within(in, '0', '9');
+	auto folded = LOWERCASE ? _mm_or_si128(in, _mm_set1_epi8(0x20)) : in;
+	auto alpha = LOWERCASE ? within(folded, 'a', 'f') : within(in, 'A', 'F');
+	if (_mm_movemask_epi8(_mm_or_si128(digit, alpha)) != 0xFFFF) {
+		return false;
+	}
+
+	auto base = _mm_set1_epi8(LOWERCASE ? 'a' - 10 : 'A' - 10);
+	values = _mm_or_si128(_mm_and_si128(digit, _mm_sub_epi8(in,
+			_mm_set1_epi8('0'))), _mm_and_si128(alpha, _mm_sub_epi8(folded,
+			base)));
+	return true;
+}
+
+template<bool LOWERCASE>
+WH_AVX2 inline bool values16(__m256i in, __m256i &values) noexcept {
+	auto digit = within(in, '0', '9');
+	auto folded = LOWERCASE ? _mm256_or_si256(in, _mm256_set1_epi8(0x20)) : in;
+	auto alpha = LOWERCASE ? within(folded, 'a', 'f') : within(in, 'A', 'F');
+	if (_mm256_movemask_epi8(_mm256_or_si256(digit, alpha)) != -1) {
+		return false;
+	}
+
+	auto base = _mm256_set1_epi8(LOWERCASE ? 'a' - 10 : 'A' - 10);
+	values = _mm256_or_si256(_mm256_and_si256(digit, _mm256_sub_epi8(in,
+			_mm256_set1_epi8('0'))), _mm256_and_si256(alpha, _mm256_sub_epi8(
+			folded, base)));
+	return true;
+}
+
+//Base-32 values of the characters, fails on an invalid character
+template<bool LOWERCASE>
+WH_SSE41 inline bool values32(__m128i in, __m128i &values) noexcept {
+	auto upper = within(in, 'A', 'Z');
+	auto lower = LOWERCASE ? within(in, 'a', 'z') : _mm_setzero_si128();
+	auto digit = within(in, '2', '7');
+	if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(upper, lower), digit))
+			!= 0xFFFF) {
+		return false;
+	}
+
+	values = _mm_or_si128(
+			_mm_or_si128(_mm_and_si128(upper, _mm_sub_epi8(in,
+					_mm_set1_epi8('A'))), _mm_and_si128(lower, _mm_sub_epi8(in,
+					_mm_set1_epi8('a')))), _mm_and_si128(digit, _mm_sub_epi8(in,
+					_mm_set1_epi8('2' - 26))));
+	return true;
+}
+
+template<bool LOWERCASE>
+WH_AVX2 inline bool values32(__m256i in, __m256i &values) noexcept {
+	auto upper = within(in, 'A', 'Z');
+	auto lower = LOWERCASE ? within(in, 'a', 'z') : _mm256_setzero_si256();
+	auto digit = within(in, '2', '7');
+	if (_mm256_movemask_epi8(
+			_mm256_or_si256(_mm256_or_si256(upper, lower), digit)) != -1) {
+		return false;
+	}
+
+	values = _mm256_or_si256(
+			_mm256_or_si256(_mm256_and_si256(upper, _mm256_sub_epi8(in,
+					_mm256_set1_epi8('A'))), _mm256_and_si256(lower,
+					_mm256_sub_epi8(in, _mm256_set1_epi8('a')))),
+			_mm256_and_si256(digit, _mm256_sub_epi8(in,
+					_mm256_set1_epi8('2' - 26))));
+	return true;
+}
+
+//Base-64 values of the characters, fails on an invalid character
+WH_SSE41 inline bool values64(__m128i in, __m128i &values) noexcept {
+	const auto lutLo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+			0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+	const auto lutHi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04,
+			0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+	const auto lutRoll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0,
+			0, 0, 0, 0, 0, 0);
+	const auto mask = _mm_set1_epi8(0x2F);
+	auto hi = _mm_and_si128(_mm_srli_epi32(in, 4), mask);
+	auto lo = _mm_and_si128(in, mask);
+	if (!_mm_testz_si128(_mm_shuffle_epi8(lutLo, lo),
+			_mm_shuffle_epi8(lutHi, hi))) {
+		return false;
+	}
+
+	auto roll = _mm_shuffle_epi8(lutRoll,
+			_mm_add_epi8(_mm_cmpeq_epi8(in, mask), hi));
+	values = _mm_add_epi8(in, roll);
+	return true;
+}
+
+WH_AVX2 inline bool values64(__m256i in, __m256i &values) noexcept {
+	const auto lutLo = _mm256_broadcastsi128_si256(
+			_mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+					0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A));
+	const auto lutHi = _mm256_broadcastsi128_si256(
+			_mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+					0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10));
+	const auto lutRoll = _mm256_broadcastsi128_si256(
+			_mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0,
+					0, 0));
+	const auto mask = _mm256_set1_epi8(0x2F);
+	auto hi = _mm256_and_si256(_mm256_srli_epi32(in, 4), mask);
+	auto lo = _mm256_and_si256(in, mask);
+	if (!_mm256_testz_si256(_mm256_shuffle_epi8(lutLo, lo),
+			_mm256_shuffle_epi8(lutHi, hi))) {
+		return false;
+	}
+
+	auto roll = _mm256_shuffle_epi8(lutRoll,
+			_mm256_add_epi8(_mm256_cmpeq_epi8(in, mask), hi));
+	values = _mm256_add_epi8(in, roll);
+	return true;
+}
+//-----------------------------------------------------------------
+//16 bytes into 32 characters
+WH_SSE41 unsigned int encode16SSE(char *dest, const unsigned char *src,
+		unsigned int length) noexcept {
+	const auto lut = _mm_loadu_si128((const __m128i*) BASE16_ALPHABET);
+	const auto mask = _mm_set1_epi8(0x0F);
+	unsigned int n = 0;
+	for (; length - n >= 16; n += 16, dest += 32) {
+		auto in = _mm_loadu_si128((const __m128i*) (src + n));
+		auto hi = _mm_shuffle_epi8(lut,
+				_mm_and_si128(_mm_srli_epi16(in, 4), mask));
+		auto lo = _mm_shuffle_epi8(lut, _mm_and_si128(in, mask));
+		_mm_storeu_si128((__m128i*) dest, _mm_unpacklo_epi8(hi, lo));
+		_mm_storeu_si128((__m128i*) (dest + 16), _mm_unpackhi_epi8(hi, lo));
+	}
+	return n;
+}
+
+//32 characters into 16 bytes
+WH_SSE41 unsigned int decode16SSE(unsigned char *dest, const char *src,
+		unsigned int length) noexcept {
+	const auto weights = _mm_set1_epi16(0x0110);
+	unsigned int n = 0;
+	for (; length - n >= 32; n += 32, dest += 16) {
+		__m128i a, b;
+		if (!values16<true>(_mm_loadu_si128((const __m128i*) (src + n)), a)
+				|| !values16<true>(
+						_mm_loadu_si128((const __m128i*) (src + n + 16)), b)) {
+			break;
+		}
+
+		_mm_storeu_si128((__m128i*) dest,
+				_mm_packus_epi16(_mm_maddubs_epi16(a, weights),
+						_mm_maddubs_epi16(b, weights)));
+	}
+	return n;
+}
+
+WH_SSE41 unsigned int validate16SSE(const char *src,
+		unsigned int length) noexcept {
+	unsigned int n = 0;
+	for (__m128i v; length - n >= 16; n += 16) {
+		if (!values16<false>(_mm_loadu_si128((const __m128i*) (src + n)), v)) {
+			break;
+		}
+	}
+	return n;
+}
+
+//10 bytes into 16 characters (reads 16 bytes)
+WH_SSE41 unsigned int encode32SSE(char *dest, const unsigned char *src,
+		unsigned int length) noexcept {
+	//Each 16-bit lane gets the two bytes which contain a pair of 5-bit values
+	const auto order = _mm_setr_epi8(1, 0, 2, 1, 3, 2, 4, 3, 6, 5, 7, 6, 8, 7,
+			9, 8);
+	const auto shifts = _mm_setr_epi16(1, 4, 16, 64, 1, 4, 16, 64);
+	unsigned int n = 0;
+	for (; length - n >= 16; n += 10, dest += 16) {
+		auto in = _mm_loadu_si128((const __m128i*) (src + n));
+		auto t = _mm_mullo_epi16(_mm_shuffle_epi8(in, order), shifts);
+		auto index = _mm_or_si128(_mm_srli_epi16(t, 11),
+				_mm_and_si128(_mm_slli_epi16(t, 2), _mm_set1_epi16(0x1F00)));
+		auto offset = _mm_sub_epi8(_mm_set1_epi8('A'),
+				_mm_and_si128(_mm_cmpgt_epi8(index, _mm_set1_epi8(25)),
+						_mm_set1_epi8('A' - ('2' - 26))));
+		_mm_storeu_si128((__m128i*) dest, _mm_add_epi8(index, offset));
+	}
+	return n;
+}
+
+//16 characters into 10 bytes (writes 16 bytes)
+WH_SSE41 inline __m128i pack32(__m128i values) noexcept {
+	auto pairs = _mm_maddubs_epi16(values, _mm_set1_epi16(0x0120));
+	auto quads = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00010400));
+	auto groups = _mm_or_si128(
+			_mm_slli_epi64(_mm_and_si128(quads, _mm_set1_epi64x(0xFFFFFFFF)),
+					20), _mm_srli_epi64(quads, 32));
+	return _mm_shuffle_epi8(groups,
+			_mm_setr_epi8(4, 3, 2, 1, 0, 12, 11, 10, 9, 8, -1, -1, -1, -1, -1,
+					-1));
+}
+
+WH_SSE41 unsigned int decode32SSE(unsigned char *dest, const char *src,
+		unsigned int length) noexcept {
+	unsigned int n = 0;
+	for (__m128i v; length - n >= 32; n += 16, dest += 10) {
+		if (!values32<true>(_mm_loadu_si128((const __m128i*) (src + n)), v)) {
+			break;
+		}
+
+		_mm_storeu_si128((__m128i*) dest, pack32(v));
+	}
+	return n;
+}
+
+WH_SSE41 unsigned int validate32SSE(const char *src,
+		unsigned int length) noexcept {
+	unsigned int n = 0;
+	for (__m128i v; length - n >= 16; n += 16) {
+		if (!values32<false>(_mm_loadu_si128((const __m128i*) (src + n)), v)) {
+			break;
+		}
+	}
+	return n;
+}
+
+//12 bytes into 16 characters (reads 16 bytes)
+WH_SSE41 inline __m128i encode64x12(__m128i in) noexcept {
+	in = _mm_shuffle_epi8(in,
+			_mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+	auto t0 = _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0FC0FC00)),
+			_mm_set1_epi32(0x04000040));
+	auto t1 = _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003F03F0)),
+			_mm_set1_epi32(0x01000010));
+	auto index = _mm_or_si128(t0, t1);
+	//Offsets: 'A' for [0, 25], 'a' for [26, 51], '0' for [52, 61], '+', '/'
+	const auto offsets = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52,
+			'0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+			'0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+	auto key = _mm_or_si128(_mm_subs_epu8(index, _mm_set1_epi8(51)),
+			_mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), index),
+					_mm_set1_epi8(13)));
+	return _mm_add_epi8(index, _mm_shuffle_epi8(offsets, key));
+}
+
+WH_SSE41 unsigned int encode64SSE(char *dest, const unsigned char *src,
+		unsigned int length) noexcept {
+	unsigned int n = 0;
+	for (; length - n >= 16; n += 12, dest += 16) {
+		auto in = _mm_loadu_si128((const __m128i*) (src + n));
+		_mm_storeu_si128((__m128i*) dest, encode64x12(in));
+	}
+	return n;
+}
+
+//16 characters into 12 bytes (writes 16 bytes)
+WH_SSE41 inline __m128i pack64(__m128i values) noexcept {
+	auto pairs = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+	auto triples = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+	return _mm_shuffle_epi8(triples,
+			_mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1,
+					-1));
+}
+
+WH_SSE41 unsigned int decode64SSE(unsigned char *dest, const char *src,
+		unsigned int length) noexcept {
+	unsigned int n = 0;
+	for (__m128i v; length - n >= 24; n += 16, dest += 12) {
+		if (!values64(_mm_loadu_si128((const __m128i*) (src + n)), v)) {
+			break;
+		}
+
+		_mm_storeu_si128((__m128i*) dest, pack64(v));
+	}
+	return n;
+}
+
+WH_SSE41 unsigned int validate64SSE(const char *src,
+		unsigned int length) noexcept {
+	unsigned int n = 0;
+	for (__m128i v; length - n >= 16; n += 16) {
+		if (!values64(_mm_loadu_si128((const __m128i*) (src + n)), v)) {
+			break;
+		}
+	}
+	return n;
+}
+//-----------------------------------------------------------------
+//Two 128-bit lanes loaded from the given offsets
+WH_AVX2 inline __m256i load2(const void *src, unsigned int offset) noexcept {
+	auto p = (const unsigned char*) src;
+	return _mm256_inserti128_si256(
+			_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*) p)),
+			_mm_loadu_si128((const __m128i*) (p + offset)), 1);
+}
+
+//32 bytes into 64 characters
+WH_AVX2 unsigned int encode16AVX2(char *dest, const unsigned char *src,
+		unsigned int length) noexcept {
+	const auto lut = _mm256_broadcastsi128_si256(
+			_mm_loadu_si128((const __m128i*) BASE16_ALPHABET));
+	const auto mask = _mm256_set1_epi8(0x0F);
+	unsigned int n = 0;
+	for (; length - n >= 32; n += 32, dest += 64) {
+		auto in = _mm256_loadu_si256((const __m256i*) (src + n));
+		auto hi = _mm256_shuffle_epi8(lut,
+				_mm256_and_si256(_mm256_srli_epi16(in, 4), mask));
+		auto lo = _mm256_shuffle_epi8(lut, _mm256_and_si256(in, mask));
+		auto a = _mm256_unpacklo_epi8(hi, lo);
+		auto b = _mm256_unpackhi_epi8(hi, lo);
+		_mm256_storeu_si256((__m256i*) dest, _mm256_permute2x128_si256(a, b,
+				0x20));
+		_mm256_storeu_si256((__m256i*) (dest + 32),
+				_mm256_permute2x128_si256(a, b, 0x31));
+	}
+	return n + encode16SSE(dest, src + n, length - n);
+}
+
+//64 characters into 32 bytes
+WH_AVX2 unsigned int decode16AVX2(unsigned char *dest, const char *src,
+		unsigned int length) noexcept {
+	const auto weights = _mm256_set1_epi16(0x0110);
+	unsigned int n = 0;
+	for (; length - n >= 64; n += 64, dest += 32) {
+		__m256i a, b;
+		if (!values16<true>(_mm256_loadu_si256((const __m256i*) (src + n)), a)
+				|| !values16<true>(
+						_mm256_loadu_si256((const __m256i*) (src + n + 32)),
+						b)) {
+			break;
+		}
+
+		auto packed = _mm256_packus_epi16(_mm256_maddubs_epi16(a, weights),
+				_mm256_maddubs_epi16(b, weights));
+		_mm256_storeu_si256((__m256i*) dest,
+				_mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0)));
+	}
+	return n + decode16SSE(dest, src + n, length - n);
+}
+
+WH_AVX2 unsigned int validate16AVX2(const char *src,
+		unsigned int length) noexcept {
+	unsigned int n = 0;
+	for (__m256i v; length - n >= 32; n += 32) {
+		if (!values16<false>(_mm256_loadu_si256((const __m256i*) (src + n)),
+				v)) {
+			break;
+		}
+	}
+	return n + validate16SSE(src + n, length - n);
+}
+
+//20 bytes into 32 characters (reads 26 bytes)
+WH_AVX2 unsigned int encode32AVX2(char *dest, const unsigned char *src,
+		unsigned int length) noexcept {
+	const auto order = _mm256_broadcastsi128_si256(
+			_mm_setr_epi8(1, 0, 2, 1, 3, 2, 4, 3, 6, 5, 7, 6, 8, 7, 9, 8));
+	const auto shifts = _mm256_broadcastsi128_si256(
+			_mm_setr_epi16(1, 4, 16, 64, 1, 4, 16, 64));
+	unsigned int n = 0;
+	for (; length - n >= 26; n += 20, dest += 32) {
+		auto t = _mm256_mullo_epi16(
+				_mm256_shuffle_epi8(load2(src + n, 10), order), shifts);
+		auto index = _mm256_or_si256(_mm256_srli_epi16(t, 11),
+				_mm256_and_si256(_mm256_slli_epi16(t, 2),
+						_mm256_set1_epi16(0x1F00)));
+		auto offset = _mm256_sub_epi8(_mm256_set1_epi8('A'),
+				_mm256_and_si256(_mm256_cmpgt_epi8(index, _mm256_set1_epi8(25)),
+						_mm256_set1_epi8('A' - ('2' - 26))));
+		_mm256_storeu_si256((__m256i*) dest, _mm256_add_epi8(index, offset));
+	}
+	return n + encode32SSE(dest, src + n, length - n);
+}
+
+//32 characters into 20 bytes (writes 26 bytes)
+WH_AVX2 unsigned int decode32AVX2(unsigned char *dest, const char *src,
+		unsigned int length) noexcept {
+	const auto order = _mm256_broadcastsi128_si256(
+			_mm_setr_epi8(4, 3, 2, 1, 0, 12, 11, 10, 9, 8, -1, -1, -1, -1, -1,
+					-1));
+	unsigned int n = 0;
+	for (__m256i v; length - n >= 48; n += 32, dest += 20) {
+		if (!values32<true>(_mm256_loadu_si256((const __m256i*) (src + n)),
+				v)) {
+			break;
+		}
+
+		auto pairs = _mm256_maddubs_epi16(v, _mm256_set1_epi16(0x0120));
+		auto quads = _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00010400));
+		auto groups = _mm256_or_si256(
+				_mm256_slli_epi64(
+						_mm256_and_si256(quads,
+								_mm256_set1_epi64x(0xFFFFFFFF)), 20),
+				_mm256_srli_epi64(quads, 32));
+		auto out = _mm256_shuffle_epi8(groups, order);
+		_mm_storeu_si128((__m128i*) dest, _mm256_castsi256_si128(out));
+		_mm_storeu_si128((__m128i*) (dest + 10),
+				_mm256_extracti128_si256(out, 1));
+	}
+	return n + decode32SSE(dest, src + n, length - n);
+}
+
+WH_AVX2 unsigned int validate32AVX2(const char *src,
+		unsigned int length) noexcept {
+	unsigned int n = 0;
+	for (__m256i v; length - n >= 32; n += 32) {
+		if (!values32<false>(_mm256_loadu_si256((const __m256i*) (src + n)),
+				v)) {
+			break;
+		}
+	}
+	return n + validate32SSE(src + n, length - n);
+}
+
+//24 bytes into 32 characters (reads 28 bytes)
+WH_AVX2 unsigned int encode64AVX2(char *dest, const unsigned char *src,
+		unsigned int length) noexcept {
+	const auto order = _mm256_broadcastsi128_si256(
+			_mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+	const auto offsets = _mm256_broadcastsi128_si256(
+			_mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+					'0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+					'+' - 62, '/' - 63, 'A', 0, 0));
+	unsigned int n = 0;
+	for (; length - n >= 28; n += 24, dest += 32) {
+		auto in = _mm256_shuffle_epi8(load2(src + n, 12), order);
+		auto t0 = _mm256_mulhi_epu16(
+				_mm256_and_si256(in, _mm256_set1_epi32(0x0FC0FC00)),
+				_mm256_set1_epi32(0x04000040));
+		auto t1 = _mm256_mullo_epi16(
+				_mm256_and_si256(in, _mm256_set1_epi32(0x003F03F0)),
+				_mm256_set1_epi32(0x01000010));
+		auto index = _mm256_or_si256(t0, t1);
+		auto key = _mm256_or_si256(
+				_mm256_subs_epu8(index, _mm256_set1_epi8(51)),
+				_mm256_and_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8(26), index),
+						_mm256_set1_epi8(13)));
+		_mm256_storeu_si256((__m256i*) dest,
+				_mm256_add_epi8(index, _mm256_shuffle_epi8(offsets, key)));
+	}
+	return n + encode64SSE(dest, src + n, length - n);
+}
+
+//32 characters into 24 bytes (writes 32 bytes)
+WH_AVX2 unsigned int decode64AVX2(unsigned char *dest, const char *src,
+		unsigned int length) noexcept {
+	const auto order = _mm256_broadcastsi128_si256(
+			_mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1,
+					-1));
+	unsigned int n = 0;
+	for (__m256i v; length - n >= 44; n += 32, dest += 24) {
+		if (!values64(_mm256_loadu_si256((const __m256i*) (src + n)), v)) {
+			break;
+		}
+
+		auto pairs = _mm256_maddubs_epi16(v, _mm256_set1_epi32(0x01400140));
+		auto triples = _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+		auto out = _mm256_shuffle_epi8(triples, order);
+		_mm256_storeu_si256((__m256i*) dest,
+				_mm256_permutevar8x32_epi32(out,
+						_mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7)));
+	}
+	return n + decode64SSE(dest, src + n, length - n);
+}
+
+WH_AVX2 unsigned int validate64AVX2(const char *src,
+		unsigned int length) noexcept {
+	unsigned int n = 0;
+	for (__m256i v; length - n >= 32; n += 32) {
+		if (!values64(_mm256_loadu_si256((const __m256i*) (src + n)), v)) {
+			break;
+		}
+	}
+	return n + validate64SSE(src + n, length - n);
+}
+
+const Kernels SSE41 = { "SSE4.1", { encode16SSE, encode32SSE, encode64SSE }, {
+		decode16SSE, decode32SSE, decode64SSE }, { validate16SSE,
+		validate32SSE, validate64SSE } };
+const Kernels AVX2 = { "AVX2", { encode16AVX2, encode32AVX2, encode64AVX2 }, {
+		decode16AVX2, decode32AVX2, decode64AVX2 }, { validate16AVX2,
+		validate32AVX2, validate64AVX2 } };
+
+const Kernels* detect() noexcept {
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) {
+		return &AVX2;
+	} else if (__builtin_cpu_supports("sse4.1")) {
+		return &SSE41;
+	} else {
+		return &SCALAR;
+	}
+}
+#else
+const Kernels* detect() noexcept {
+	return &SCALAR;
+}
+#endif
+
+//The kernels selected by Encoding::accelerate (nullptr for the best ones)
+const Kernels *selected = nullptr;
+
+const Kernels& kernels() noexcept {
+	static const Kernels *best = detect();
+	auto k = wanhive::Atomic<const Kernels*>::load(&selected);
+	return k ? *k : *best;
+}
+
 }  // namespace
 
 namespace wanhive {
@@ -249,8 +809,9 @@ unsigned int Encoding::base64Encode(char *dest, const void *src,
 
 	//Consume the input three characters at a time
 	auto data = (const unsigned char*) src;
-	unsigned int length = 0;
-	for (unsigned int x = 0; x < srcLength; x += BASE64_ENCODER_IN) {
+	auto start = kernels().encoders[ENC_BASE64](dest, data, srcLength);
+	unsigned int length = (start / BASE64_ENCODER_IN) * BASE64_DECODER_IN;
+	for (unsigned int x = start; x < srcLength; x += BASE64_ENCODER_IN) {
 		auto in = srcLength - x;
 		if (in > BASE64_ENCODER_IN) {
 			in = BASE64_ENCODER_IN;
@@ -316,9 +877,11 @@ unsigned int Encoding::base64Decode(unsigned char *dest, const char *src,
 		return 0;
 	}
 
-	unsigned int length = 0;
+	auto start = kernels().decoders[ENC_BASE64](dest, src, srcLength);
+	unsigned int length = (start / BASE64_DECODER_IN) * BASE64_ENCODER_IN;
+	dest += length;
 	unsigned long long buf = 1;
-	for (unsigned int index = 0; index < srcLength; ++index) {
+	for (unsigned int index = start; index < srcLength; ++index) {
 		auto c = decode64(src[index]);
 		if (c <= BASE64_MAX_VALUE) {
 			buf = buf << BASE64_GROUP_LENGTH | c;
@@ -362,8 +925,9 @@ unsigned int Encoding::base32Encode(char *dest, const void *src,
 
 	//Consume the input five characters at a time
 	auto data = (const unsigned char*) src;
-	unsigned int length = 0;
-	for (unsigned int x = 0; x < srcLength; x += BASE32_ENCODER_IN) {
+	auto start = kernels().encoders[ENC_BASE32](dest, data, srcLength);
+	unsigned int length = (start / BASE32_ENCODER_IN) * BASE32_DECODER_IN;
+	for (unsigned int x = start; x < srcLength; x += BASE32_ENCODER_IN) {
 		auto in = srcLength - x;
 		if (in > BASE32_ENCODER_IN) {
 			in = BASE32_ENCODER_IN;
@@ -451,9 +1015,11 @@ unsigned int Encoding::base32Decode(unsigned char *dest, const char *src,
 		return 0;
 	}
 
-	unsigned int length = 0;
+	auto start = kernels().decoders[ENC_BASE32](dest, src, srcLength);
+	unsigned int length = (start / BASE32_DECODER_IN) * BASE32_ENCODER_IN;
+	dest += length;
 	unsigned long long buf = 1;
-	for (unsigned int index = 0; index < srcLength; ++index) {
+	for (unsigned int index = start; index < srcLength; ++index) {
 		auto c = decode32(toupper(src[index]));
 		if (c <= BASE32_MAX_VALUE) {
 			buf = buf << BASE32_GROUP_LENGTH | c;
@@ -509,8 +1075,9 @@ unsigned int Encoding::base16Encode(char *dest, const void *src,
 
 	//Consume the input one characters at a time
 	auto data = (const unsigned char*) src;
-	unsigned int length = 0;
-	for (unsigned int x = 0; x < srcLength; x += BASE16_ENCODER_IN) {
+	auto start = kernels().encoders[ENC_BASE16](dest, data, srcLength);
+	unsigned int length = start * BASE16_DECODER_IN;
+	for (unsigned int x = start; x < srcLength; x += BASE16_ENCODER_IN) {
 		//Assemble the 8-bit number
 		unsigned long long n = data[x];
 
@@ -536,9 +1103,11 @@ unsigned int Encoding::base16Decode(unsigned char *dest, const char *src,
 		return 0;
 	}
 
-	unsigned int length = 0;
+	auto start = kernels().decoders[ENC_BASE16](dest, src, srcLength);
+	unsigned int length = (start / BASE16_DECODER_IN) * BASE16_ENCODER_IN;
+	dest += length;
 	unsigned long long buf = 1;
-	for (unsigned int index = 0; index < srcLength; ++index) {
+	for (unsigned int index = start; index < srcLength; ++index) {
 		auto c = decode16(toupper(src[index]));
 		if (c <= BASE16_MAX_VALUE) {
 			buf = buf << BASE16_GROUP_LENGTH | c;
@@ -606,7 +1175,7 @@ bool Encoding::validate(EncodingBase base, const char *src,
 		return false;
 	}
 
-	unsigned int i = 0;
+	auto i = kernels().validators[base](src, size);
 	for (; i < size; ++i) {
 		auto c = list[(unsigned char) src[i]];
 		if (c <= traits.value) {
@@ -634,6 +1203,11 @@ bool Encoding::validate(EncodingBase base, const char *src,
 	return true;
 }
 
+const char* Encoding::accelerate(bool enable) noexcept {
+	Atomic<const Kernels*>::store(&selected, enable ? nullptr : &SCALAR);
+	return kernels().name;
+}
+
 void Encoding::printAlphabet(EncodingBase base) noexcept {
 	printf("%s\n", ALPHABETS[base]);
 }
@@ -256,6 +256,16 @@ public:
 	static bool validate(EncodingBase base, const char *src,
 			unsigned int size) noexcept;
 	//-----------------------------------------------------------------
+	/**
+	 * Selects the implementation: the vectorized (AVX2 or SSE4.1) kernels are
+	 * chosen at runtime if the processor supports them, otherwise the scalar
+	 * code is used. Both produce identical results.
+	 * @param enable true to use the best supported kernels (default), false
+	 * to force the scalar code.
+	 * @return name of the implementation in use
+	 */
+	static const char* accelerate(bool enable) noexcept;
+	//-----------------------------------------------------------------
 	/**
 	 * For debugging: prints the alphabet table.
 	 * @param base the base selector
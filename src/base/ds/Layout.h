@@ -0,0 +1,221 @@
+/*
+ * Layout.h
+ *
+ * Compile-time wire layouts
+ *
+ *
+ * Copyright (C) 2025 Wanhive Systems Private Limited (info@wanhive.com)
+ * This program is part of the Wanhive IoT Platform.
+ * Check the COPYING file for the license.
+ *
+ */
+
+#ifndef WH_BASE_DS_LAYOUT_H_
+#define WH_BASE_DS_LAYOUT_H_
+#include "Serializer.h"
+#include <cstring>
+#include <endian.h>
+#include <type_traits>
+#include <utility>
+
+namespace wanhive {
+/**
+ * Fixed-size field of a wire layout: big-endian integer or IEEE-754 floating
+ * point number (same encoding as the Serializer).
+ * @tparam T the native type
+ * @tparam BYTES field's size in bytes
+ */
+template<typename T, size_t BYTES = sizeof(T)> struct Field {
+	static_assert(std::is_arithmetic_v<T>, "Invalid field type");
+	static_assert(BYTES == 1 || BYTES == 2 || BYTES == 4 || BYTES == 8,
+			"Invalid field size");
+	static_assert(!std::is_floating_point_v<T> || BYTES > 1,
+			"Invalid field size");
+	/** The native type */
+	using Type = T;
+	/** Field's size in bytes */
+	static constexpr size_t SIZE = BYTES;
+	/**
+	 * Writes a value into the buffer.
+	 * @param buf the output buffer
+	 * @param value the value
+	 */
+	static void write(unsigned char *buf, T value) noexcept {
+		if constexpr (std::is_floating_point_v<T> && BYTES == 2) {
+			Serializer::packf16(buf, value);
+		} else if constexpr (std::is_floating_point_v<T> && BYTES == 4) {
+			Serializer::packf32(buf, value);
+		} else if constexpr (std::is_floating_point_v<T>) {
+			Serializer::packf64(buf, value);
+		} else {
+			auto v = convert((Unsigned) (std::make_unsigned_t<T>) value);
+			memcpy(buf, &v, BYTES);
+		}
+	}
+	/**
+	 * Reads a value from the buffer.
+	 * @param buf the input buffer
+	 * @return the value
+	 */
+	static T read(const unsigned char *buf) noexcept {
+		if constexpr (std::is_floating_point_v<T> && BYTES == 2) {
+			return Serializer::unpackf16(buf);
+		} else if constexpr (std::is_floating_point_v<T> && BYTES == 4) {
+			return Serializer::unpackf32(buf);
+		} else if constexpr (std::is_floating_point_v<T>) {
+			return Serializer::unpackf64(buf);
+		} else {
+			Unsigned v;
+			memcpy(&v, buf, BYTES);
+			return (T) (std::make_unsigned_t<T>) convert(v);
+		}
+	}
+private:
+	//Unsigned integer of the field's size
+	using Unsigned = std::conditional_t<BYTES == 1, uint8_t,
+	std::conditional_t<BYTES == 2, uint16_t,
+	std::conditional_t<BYTES == 4, uint32_t, uint64_t>>>;
+
+	//Host to network byte order and vice versa
+	static Unsigned convert(Unsigned v) noexcept {
+		if constexpr (BYTES == 2) {
+			return htobe16(v);
+		} else if constexpr (BYTES == 4) {
+			return htobe32(v);
+		} else if constexpr (BYTES == 8) {
+			return htobe64(v);
+		} else {
+			return v;
+		}
+	}
+};
+
+/*
+ * The fields corresponding to the Serializer's format characters
+ */
+using WireI8 = Field<int8_t>; /**< 'c' */
+using WireU8 = Field<uint8_t>; /**< 'C' */
+using WireI16 = Field<int16_t>; /**< 'h' */
+using WireU16 = Field<uint16_t>; /**< 'H' */
+using WireI32 = Field<int32_t>; /**< 'l' */
+using WireU32 = Field<uint32_t>; /**< 'L' */
+using WireI64 = Field<int64_t>; /**< 'q' */
+using WireU64 = Field<uint64_t>; /**< 'Q' */
+using WireF16 = Field<float, 2>; /**< 'f' */
+using WireF32 = Field<float, 4>; /**< 'd' */
+using WireF64 = Field<double, 8>; /**< 'g' */
+
+/**
+ * Wire layout described by a list of fixed-size fields. The offsets are
+ * computed at compile time and the bounds are checked once per call. The
+ * encoding is compatible with the Serializer's format strings, for example
+ * Layout<WireU64, WireU32> is equivalent to "QL". The variable-length strings
+ * and blobs are not supported.
+ * @tparam Fields the fields in the wire order
+ */
+template<typename ...Fields> class Layout {
+public:
+	/** Number of fields */
+	static constexpr size_t COUNT = sizeof...(Fields);
+	/** Total size in bytes */
+	static constexpr size_t SIZE = (Fields::SIZE + ... + 0);
+	/**
+	 * Returns a field's offset from the beginning of the layout.
+	 * @tparam I the field's index
+	 * @return offset in bytes
+	 */
+	template<size_t I> static constexpr size_t offset() noexcept {
+		static_assert(I < COUNT, "Invalid field index");
+		constexpr size_t sizes[] = { Fields::SIZE..., 0 };
+		size_t n = 0;
+		for (size_t i = 0; i < I; ++i) {
+			n += sizes[i];
+		}
+		return n;
+	}
+	//-----------------------------------------------------------------
+	/**
+	 * Stores the values in the buffer.
+	 * @param buf the output buffer (at least Layout::SIZE bytes)
+	 * @param values the values in the wire order
+	 * @return number of bytes written into the buffer, 0 on error
+	 */
+	static size_t pack(unsigned char *buf,
+			typename Fields::Type ...values) noexcept {
+		if (!buf) {
+			return 0;
+		}
+
+		write(buf, std::index_sequence_for<Fields...> { }, values...);
+		return SIZE;
+	}
+	/**
+	 * Stores the values in the buffer. This one is the error checking version
+	 * which fails on buffer overflow.
+	 * @param buf the output buffer
+	 * @param size output buffer's size in bytes
+	 * @param values the values in the wire order
+	 * @return number of bytes written into the buffer, 0 on error
+	 */
+	static size_t pack(unsigned char *buf, size_t size,
+			typename Fields::Type ...values) noexcept {
+		if (!buf || size < SIZE) {
+			return 0;
+		}
+
+		write(buf, std::index_sequence_for<Fields...> { }, values...);
+		return SIZE;
+	}
+	/**
+	 * Extracts the values from the buffer.
+	 * @param buf the input buffer (at least Layout::SIZE bytes)
+	 * @param values objects for storing the values in the wire order
+	 * @return number of transferred bytes, 0 on error
+	 */
+	template<typename ...Args, typename = std::enable_if_t<
+			sizeof...(Args) == COUNT>>
+	static size_t unpack(const unsigned char *buf, Args &...values) noexcept {
+		if (!buf) {
+			return 0;
+		}
+
+		read(buf, std::index_sequence_for<Fields...> { }, values...);
+		return SIZE;
+	}
+	/**
+	 * Extracts the values from the buffer. This one is the error checking
+	 * version which fails on buffer overflow.
+	 * @param buf the input buffer
+	 * @param size input buffer's size in bytes
+	 * @param values objects for storing the values in the wire order
+	 * @return number of transferred bytes, 0 on error
+	 */
+	template<typename ...Args, typename = std::enable_if_t<
+			sizeof...(Args) == COUNT>>
+	static size_t unpack(const unsigned char *buf, size_t size,
+			Args &...values) noexcept {
+		if (!buf || size < SIZE) {
+			return 0;
+		}
+
+		read(buf, std::index_sequence_for<Fields...> { }, values...);
+		return SIZE;
+	}
+private:
+	template<size_t ...I>
+	static void write(unsigned char *buf, std::index_sequence<I...>,
+			typename Fields::Type ...values) noexcept {
+		(Fields::write(buf + offset<I>(), values), ...);
+	}
+
+	template<size_t ...I, typename ...Args>
+	static void read(const unsigned char *buf, std::index_sequence<I...>,
+			Args &...values) noexcept {
+		static_assert((std::is_arithmetic_v<Args> && ...), "Invalid value type");
+		((values = (Args) Fields::read(buf + offset<I>())), ...);
+	}
+};
+
+} /* namespace wanhive */
+
+#endif /* WH_BASE_DS_LAYOUT_H_ */
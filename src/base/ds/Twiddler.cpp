@@ -13,6 +13,7 @@
 #include "Twiddler.h"
 #include <cctype>
 #include <cstring>
+#include <endian.h>
 
 namespace {
 
@@ -38,6 +39,55 @@ const unsigned char bitOrdinal_[256] = {
 
 }  // namespace
 
+namespace {
+
+//Wyhash's default secret
+constexpr uint64_t WYP[4] = { 0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL,
+		0x4b33a62ed433d4a3ULL, 0x4d5a2da51de1aa47ULL };
+
+//128-bit product of a and b, low half in a and high half in b
+void wyMum(uint64_t &a, uint64_t &b) noexcept {
+#ifdef __SIZEOF_INT128__
+	__uint128_t r = a;
+	r *= b;
+	a = (uint64_t) r;
+	b = (uint64_t) (r >> 64);
+#else
+	uint64_t ha = a >> 32, hb = b >> 32, la = (uint32_t) a, lb = (uint32_t) b;
+	uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+	uint64_t t = rl + (rm0 << 32);
+	uint64_t c = t < rl;
+	uint64_t lo = t + (rm1 << 32);
+	c += lo < t;
+	a = lo;
+	b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+uint64_t wyMix(uint64_t a, uint64_t b) noexcept {
+	wyMum(a, b);
+	return a ^ b;
+}
+
+//Little-endian reads
+uint64_t wyR8(const unsigned char *p) noexcept {
+	uint64_t v;
+	memcpy(&v, p, 8);
+	return le64toh(v);
+}
+
+uint64_t wyR4(const unsigned char *p) noexcept {
+	uint32_t v;
+	memcpy(&v, p, 4);
+	return le32toh(v);
+}
+
+uint64_t wyR3(const unsigned char *p, size_t k) noexcept {
+	return (((uint64_t) p[0]) << 16) | (((uint64_t) p[k >> 1]) << 8) | p[k - 1];
+}
+
+}  // namespace
+
 namespace wanhive {
 
 unsigned int Twiddler::max(unsigned int x, unsigned int y) noexcept {
@@ -138,6 +188,51 @@ unsigned long long Twiddler::FVN1aHash(const void *data,
 	return hash;
 }
 
+unsigned long long Twiddler::wyHash(const void *data, unsigned int bytes,
+		unsigned long long seed) noexcept {
+	auto p = (const unsigned char*) data;
+	size_t len = data ? bytes : 0;
+	uint64_t a, b;
+	seed ^= wyMix(seed ^ WYP[0], WYP[1]);
+	if (len <= 16) {
+		if (len >= 4) {
+			a = (wyR4(p) << 32) | wyR4(p + ((len >> 3) << 2));
+			b = (wyR4(p + len - 4) << 32) | wyR4(p + len - 4 - ((len >> 3) << 2));
+		} else if (len > 0) {
+			a = wyR3(p, len);
+			b = 0;
+		} else {
+			a = b = 0;
+		}
+	} else {
+		auto i = len;
+		if (i >= 48) {
+			uint64_t see1 = seed, see2 = seed;
+			do {
+				seed = wyMix(wyR8(p) ^ WYP[1], wyR8(p + 8) ^ seed);
+				see1 = wyMix(wyR8(p + 16) ^ WYP[2], wyR8(p + 24) ^ see1);
+				see2 = wyMix(wyR8(p + 32) ^ WYP[3], wyR8(p + 40) ^ see2);
+				p += 48;
+				i -= 48;
+			} while (i >= 48);
+			seed ^= see1 ^ see2;
+		}
+
+		while (i > 16) {
+			seed = wyMix(wyR8(p) ^ WYP[1], wyR8(p + 8) ^ seed);
+			i -= 16;
+			p += 16;
+		}
+		a = wyR8(p + i - 16);
+		b = wyR8(p + i - 8);
+	}
+
+	a ^= WYP[1];
+	b ^= seed;
+	wyMum(a, b);
+	return wyMix(a ^ WYP[0] ^ len, b ^ WYP[1]);
+}
+
 bool Twiddler::isBetween(unsigned int value, unsigned int from,
 		unsigned int to) noexcept {
 	if (from < to) {
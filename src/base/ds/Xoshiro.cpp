@@ -0,0 +1,217 @@
+/*
+ * Xoshiro.cpp
+ *
+ * Xoshiro256++ based 64-bit random number generator
+ *
+ *
+ * Copyright (C) 2025 Wanhive Systems Private Limited (info@wanhive.com)
+ * This program is part of the Wanhive IoT Platform.
+ * Check the COPYING file for the license.
+ *
+ */
+
+#include "Xoshiro.h"
+#include <cstring>
+
+namespace {
+
+using State = unsigned long long[4][wanhive::Xoshiro::LANES];
+using Generator = void (*)(State&, unsigned long long*, unsigned int);
+
+inline unsigned long long rotl(unsigned long long x, int k) noexcept {
+	return (x << k) | (x >> (64 - k));
+}
+
+//Generates blocks of LANES outputs, one step of each stream per block
+inline __attribute__((always_inline)) void generate(State &state,
+		unsigned long long *out, unsigned int blocks) noexcept {
+	constexpr auto N = wanhive::Xoshiro::LANES;
+	//Local copy of the state prevents aliasing with the output
+	unsigned long long s0[N], s1[N], s2[N], s3[N];
+	memcpy(s0, state[0], sizeof(s0));
+	memcpy(s1, state[1], sizeof(s1));
+	memcpy(s2, state[2], sizeof(s2));
+	memcpy(s3, state[3], sizeof(s3));
+	for (unsigned int b = 0; b < blocks; ++b, out += N) {
+		unsigned long long r[N];
+		for (unsigned int i = 0; i < N; ++i) {
+			r[i] = rotl(s0[i] + s3[i], 23) + s0[i];
+			auto t = s1[i] << 17;
+			s2[i] ^= s0[i];
+			s3[i] ^= s1[i];
+			s1[i] ^= s2[i];
+			s0[i] ^= s3[i];
+			s2[i] ^= t;
+			s3[i] = rotl(s3[i], 45);
+		}
+		memcpy(out, r, sizeof(r));
+	}
+	memcpy(state[0], s0, sizeof(s0));
+	memcpy(state[1], s1, sizeof(s1));
+	memcpy(state[2], s2, sizeof(s2));
+	memcpy(state[3], s3, sizeof(s3));
+}
+
+void generateScalar(State &state, unsigned long long *out,
+		unsigned int blocks) noexcept {
+	generate(state, out, blocks);
+}
+
+#if defined(__x86_64__) && defined(__GNUC__)
+__attribute__((target("avx2"))) void generateAVX2(State &state,
+		unsigned long long *out, unsigned int blocks) noexcept {
+	generate(state, out, blocks);
+}
+#endif
+
+Generator generator() noexcept {
+#if defined(__x86_64__) && defined(__GNUC__)
+	static const Generator best = __builtin_cpu_supports("avx2") ?
+			generateAVX2 : generateScalar;
+	return best;
+#else
+	return generateScalar;
+#endif
+}
+
+unsigned long long splitMix(unsigned long long &x) noexcept {
+	auto z = (x += 0x9e3779b97f4a7c15ULL);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+	return z ^ (z >> 31);
+}
+
+}  // namespace
+
+namespace wanhive {
+
+Xoshiro::Xoshiro(unsigned long long s) noexcept :
+		index(LANES) {
+	seed(s);
+}
+
+Xoshiro::~Xoshiro() {
+
+}
+
+void Xoshiro::seed(unsigned long long s) noexcept {
+	unsigned long long x[4];
+	for (auto &w : x) {
+		w = splitMix(s);
+	}
+
+	for (unsigned int i = 0; i < LANES; ++i) {
+		for (unsigned int w = 0; w < 4; ++w) {
+			state[w][i] = x[w];
+		}
+		jump(x);
+	}
+
+	index = LANES;
+}
+
+unsigned long long Xoshiro::next() noexcept {
+	if (index == LANES) {
+		refill();
+	}
+
+	return outputs[index++];
+}
+
+unsigned long long Xoshiro::next(unsigned long long bound) noexcept {
+	if (!bound) {
+		return 0;
+	}
+#ifdef __SIZEOF_INT128__
+	//Lemire's multiply-and-reject method
+	__uint128_t m = (__uint128_t) next() * bound;
+	auto low = (unsigned long long) m;
+	if (low < bound) {
+		auto threshold = -bound % bound;
+		while (low < threshold) {
+			m = (__uint128_t) next() * bound;
+			low = (unsigned long long) m;
+		}
+	}
+	return (unsigned long long) (m >> 64);
+#else
+	auto threshold = -bound % bound;
+	unsigned long long x;
+	do {
+		x = next();
+	} while (x < threshold);
+	return x % bound;
+#endif
+}
+
+void Xoshiro::fill(unsigned long long *values, unsigned int count) noexcept {
+	if (!values) {
+		return;
+	}
+
+	//Drain the buffered outputs first to preserve the sequence
+	while (count && index != LANES) {
+		*values++ = outputs[index++];
+		--count;
+	}
+
+	if (auto blocks = count / LANES; blocks) {
+		generator()(state, values, blocks);
+		values += blocks * LANES;
+		count -= blocks * LANES;
+	}
+
+	while (count--) {
+		*values++ = next();
+	}
+}
+
+void Xoshiro::bytes(void *buffer, unsigned int count) noexcept {
+	if (!buffer) {
+		return;
+	}
+
+	auto p = (unsigned char*) buffer;
+	unsigned long long block[LANES * 16];
+	while (count) {
+		auto n = count < sizeof(block) ? count : sizeof(block);
+		fill(block, (n + sizeof(block[0]) - 1) / sizeof(block[0]));
+		memcpy(p, block, n);
+		p += n;
+		count -= n;
+	}
+}
+
+void Xoshiro::refill() noexcept {
+	generateScalar(state, outputs, 1);
+	index = 0;
+}
+
+void Xoshiro::jump(unsigned long long (&s)[4]) noexcept {
+	static constexpr unsigned long long JUMP[] = { 0x180ec6d33cfd0abaULL,
+			0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL,
+			0x39abdc4529b1661cULL };
+
+	unsigned long long t[4] = { 0, 0, 0, 0 };
+	for (auto j : JUMP) {
+		for (int b = 0; b < 64; ++b) {
+			if (j & (1ULL << b)) {
+				t[0] ^= s[0];
+				t[1] ^= s[1];
+				t[2] ^= s[2];
+				t[3] ^= s[3];
+			}
+			//One step of the generator
+			auto x = s[1] << 17;
+			s[2] ^= s[0];
+			s[3] ^= s[1];
+			s[1] ^= s[2];
+			s[0] ^= s[3];
+			s[2] ^= x;
+			s[3] = rotl(s[3], 45);
+		}
+	}
+	memcpy(s, t, sizeof(t));
+}
+
+} /* namespace wanhive */
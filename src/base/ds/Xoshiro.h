@@ -0,0 +1,81 @@
+/*
+ * Xoshiro.h
+ *
+ * Xoshiro256++ based 64-bit random number generator
+ *
+ *
+ * Copyright (C) 2025 Wanhive Systems Private Limited (info@wanhive.com)
+ * This program is part of the Wanhive IoT Platform.
+ * Check the COPYING file for the license.
+ *
+ */
+
+#ifndef WH_BASE_DS_XOSHIRO_H_
+#define WH_BASE_DS_XOSHIRO_H_
+
+namespace wanhive {
+/**
+ * Xoshiro256++ (64-bit generator) running multiple interleaved streams which
+ * are advanced together (vectorized with AVX2 if the processor supports it).
+ * The streams start 2^128 steps apart (jump function), the outputs are served
+ * in the round-robin order.
+ * Not suitable for cryptographic application
+ * @ref https://prng.di.unimi.it/xoshiro256plusplus.c
+ */
+class Xoshiro {
+public:
+	/**
+	 * Constructor: creates a new random number generator.
+	 * @param s value for seeding the generator
+	 */
+	Xoshiro(unsigned long long s = 0) noexcept;
+	/**
+	 * Destructor
+	 */
+	~Xoshiro();
+	/**
+	 * Applies a new seed to the generator (expanded with SplitMix64).
+	 * @param s the new seed's value
+	 */
+	void seed(unsigned long long s) noexcept;
+	/**
+	 * Generates and returns a 64-bit random number.
+	 * @return the random number
+	 */
+	unsigned long long next() noexcept;
+	/**
+	 * Generates a uniformly distributed random number in the range
+	 * [0, bound) without the modulo bias.
+	 * @param bound the upper bound (exclusive)
+	 * @return the random number, 0 if the bound is 0
+	 */
+	unsigned long long next(unsigned long long bound) noexcept;
+	/**
+	 * Fills an array with 64-bit random numbers.
+	 * @param values the output array
+	 * @param count number of elements
+	 */
+	void fill(unsigned long long *values, unsigned int count) noexcept;
+	/**
+	 * Fills a buffer with random bytes.
+	 * @param buffer the output buffer
+	 * @param count number of bytes
+	 */
+	void bytes(void *buffer, unsigned int count) noexcept;
+public:
+	/** Number of interleaved streams */
+	static constexpr unsigned int LANES = 4;
+private:
+	void refill() noexcept;
+	static void jump(unsigned long long (&state)[4]) noexcept;
+private:
+	//Internal state, word-major for the vectorization
+	unsigned long long state[4][LANES];
+	//Outputs of the last step
+	unsigned long long outputs[LANES];
+	unsigned int index;
+};
+
+} /* namespace wanhive */
+
+#endif /* WH_BASE_DS_XOSHIRO_H_ */
@@ -0,0 +1,277 @@
+/*
+ * Connector.cpp
+ *
+ * Dual-stack connection establishment (happy eyeballs)
+ *
+ *
+ * Copyright (C) 2025 Wanhive Systems Private Limited (info@wanhive.com)
+ * This program is part of the Wanhive IoT Platform.
+ * Check the COPYING file for the license.
+ *
+ */
+
+#include "Connector.h"
+#include "../Network.h"
+#include "../Timer.h"
+#include "../common/Exception.h"
+#include "../ds/Khash.h"
+#include "../ds/Twiddler.h"
+#include "../unix/SystemException.h"
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <pthread.h>
+#include <unistd.h>
+
+namespace {
+
+//Address family preferences of the recently contacted hosts
+struct Preference {
+	int family; //Preferred address family
+	unsigned int families; //Observed address families (bitmap)
+};
+
+constexpr unsigned int MAX_HOSTS = 1024;
+pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+wanhive::Kmap<unsigned long long, Preference> preferences;
+
+unsigned long long key(const char *host) noexcept {
+	return wanhive::Twiddler::wyHash(host, strlen(host));
+}
+
+unsigned int bit(int family) noexcept {
+	return (family == AF_INET6) ? 2 : ((family == AF_INET) ? 1 : 0);
+}
+
+//Must be called with the mutex held
+Preference* find(const char *host, bool create) noexcept {
+	auto k = key(host);
+	auto i = preferences.get(k);
+	if (i != preferences.end()) {
+		return preferences.getValueReference(i);
+	} else if (!create) {
+		return nullptr;
+	}
+
+	if (preferences.size() >= MAX_HOSTS) {
+		preferences.clear();
+	}
+
+	int ret = 0;
+	i = preferences.put(k, ret);
+	if (i == preferences.end()) {
+		return nullptr;
+	}
+
+	auto p = preferences.getValueReference(i);
+	*p = { AF_INET6, 0 };
+	return p;
+}
+
+}  // namespace
+
+namespace wanhive {
+
+void Connector::order(const char *host, SocketAddress addresses[],
+		unsigned int count) noexcept {
+	if (!host || !addresses || !count) {
+		return;
+	}
+
+	auto n = Twiddler::min(count, MAX_ADDRESSES);
+	int preferred = AF_INET6;
+	pthread_mutex_lock(&mutex);
+	if (auto p = find(host, true); p) {
+		for (unsigned int i = 0; i < n; ++i) {
+			p->families |= bit(addresses[i].address.ss_family);
+		}
+		preferred = p->family;
+	}
+	pthread_mutex_unlock(&mutex);
+	//-----------------------------------------------------------------
+	//Alternate the families, starting with the preferred one
+	SocketAddress first[MAX_ADDRESSES];
+	SocketAddress second[MAX_ADDRESSES];
+	unsigned int x = 0;
+	unsigned int y = 0;
+	for (unsigned int i = 0; i < n; ++i) {
+		if (addresses[i].address.ss_family == preferred) {
+			first[x++] = addresses[i];
+		} else {
+			second[y++] = addresses[i];
+		}
+	}
+
+	for (unsigned int i = 0, j = 0, k = 0; k < n; ++k) {
+		if (i < x && (j == y || (k & 1) == 0)) {
+			addresses[k] = first[i++];
+		} else {
+			addresses[k] = second[j++];
+		}
+	}
+}
+
+int Connector::connect(const char *host, const SocketAddress addresses[],
+		unsigned int count, SocketAddress &sa, unsigned int delay,
+		int timeout) {
+	if (!addresses || !count) {
+		throw Exception(EX_ARGUMENT);
+	}
+
+	count = Twiddler::min(count, MAX_ADDRESSES);
+	pollfd fds[MAX_ADDRESSES];
+	unsigned int index[MAX_ADDRESSES]; //Attempt to address mapping
+	unsigned int active = 0;
+	unsigned int next = 0;
+	int error = ETIMEDOUT;
+	int winner = -1;
+	bool hurry = false; //Previous attempt failed
+	Timer timer;
+	Timer stagger;
+	//-----------------------------------------------------------------
+	while (winner == -1) {
+		//Start the next attempt
+		if (next < count && (!active || hurry || stagger.hasTimedOut(delay))) {
+			auto &a = addresses[next];
+			auto sfd = ::socket(a.address.ss_family,
+					SOCK_STREAM | SOCK_NONBLOCK, 0);
+			if (sfd == -1) {
+				error = errno;
+			} else if (::connect(sfd, (const sockaddr*) &a.address, a.length)
+					== 0) {
+				fds[active] = { sfd, POLLOUT, 0 };
+				index[active++] = next;
+				winner = active - 1;
+				break;
+			} else if (errno == EINPROGRESS) {
+				fds[active] = { sfd, POLLOUT, 0 };
+				index[active++] = next;
+			} else {
+				error = errno;
+				::close(sfd);
+			}
+			++next;
+			hurry = false;
+			stagger.now();
+			continue;
+		} else if (!active && next == count) {
+			break;
+		}
+		//-----------------------------------------------------------------
+		int wait = -1;
+		if (next < count) {
+			wait = delay;
+		}
+		if (timeout >= 0) {
+			auto left = timeout - (int) (timer.elapsed() * Timer::MILS_IN_SEC);
+			if (left <= 0) {
+				error = ETIMEDOUT;
+				break;
+			}
+			wait = (wait == -1 || left < wait) ? left : wait;
+		}
+
+		auto ready = ::poll(fds, active, wait);
+		if (ready == -1 && errno != EINTR) {
+			error = errno;
+			break;
+		}
+
+		for (unsigned int i = 0; ready > 0 && i < active; ++i) {
+			if (!fds[i].revents) {
+				continue;
+			}
+
+			int e = 0;
+			socklen_t length = sizeof(e);
+			if (::getsockopt(fds[i].fd, SOL_SOCKET, SO_ERROR, &e, &length)
+					== -1) {
+				e = errno;
+			}
+
+			if (!e) {
+				winner = i;
+				break;
+			}
+			//Failed attempt, the next one starts right away
+			error = e;
+			failed(host, addresses[index[i]].address.ss_family);
+			::close(fds[i].fd);
+			fds[i] = fds[active - 1];
+			index[i] = index[active - 1];
+			--active;
+			--i;
+			hurry = true;
+		}
+	}
+	//-----------------------------------------------------------------
+	for (unsigned int i = 0; i < active; ++i) {
+		if ((int) i != winner) {
+			::close(fds[i].fd);
+		}
+	}
+
+	if (winner == -1) {
+		throw SystemException(error);
+	}
+
+	auto sfd = fds[winner].fd;
+	try {
+		Network::setBlocking(sfd, true);
+	} catch (const BaseException &e) {
+		::close(sfd);
+		throw;
+	}
+	sa = addresses[index[winner]];
+	succeeded(host, sa.address.ss_family);
+	return sfd;
+}
+
+void Connector::succeeded(const char *host, int family) noexcept {
+	if (!host || !bit(family)) {
+		return;
+	}
+
+	pthread_mutex_lock(&mutex);
+	if (auto p = find(host, true); p) {
+		p->family = family;
+		p->families |= bit(family);
+	}
+	pthread_mutex_unlock(&mutex);
+}
+
+void Connector::failed(const char *host, int family) noexcept {
+	if (!host || !bit(family)) {
+		return;
+	}
+
+	pthread_mutex_lock(&mutex);
+	if (auto p = find(host, true); p && p->family == family) {
+		p->family = (family == AF_INET6) ? AF_INET : AF_INET6;
+	}
+	pthread_mutex_unlock(&mutex);
+}
+
+bool Connector::hasAlternative(const char *host, int family) noexcept {
+	if (!host) {
+		return false;
+	}
+
+	pthread_mutex_lock(&mutex);
+	auto p = find(host, false);
+	auto ret = p && (p->families & ~bit(family));
+	pthread_mutex_unlock(&mutex);
+	return ret;
+}
+
+int Connector::family(int sfd) noexcept {
+	int domain = AF_UNSPEC;
+	socklen_t length = sizeof(domain);
+	if (::getsockopt(sfd, SOL_SOCKET, SO_DOMAIN, &domain, &length) == -1) {
+		return AF_UNSPEC;
+	} else {
+		return domain;
+	}
+}
+
+} /* namespace wanhive */
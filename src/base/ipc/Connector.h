@@ -0,0 +1,91 @@
+/*
+ * Connector.h
+ *
+ * Dual-stack connection establishment (happy eyeballs)
+ *
+ *
+ * Copyright (C) 2025 Wanhive Systems Private Limited (info@wanhive.com)
+ * This program is part of the Wanhive IoT Platform.
+ * Check the COPYING file for the license.
+ *
+ */
+
+#ifndef WH_BASE_IPC_CONNECTOR_H_
+#define WH_BASE_IPC_CONNECTOR_H_
+#include "inet.h"
+
+namespace wanhive {
+/**
+ * Dual-stack connection establishment: interleaves the address families and
+ * races the connection attempts with staggered starts, remembering the
+ * address family which won for each host.
+ * Ref: RFC 8305 (Happy Eyeballs Version 2)
+ * Thread safe at class level
+ */
+class Connector {
+public:
+	/** Default delay in milliseconds between the connection attempts */
+	static constexpr unsigned int ATTEMPT_DELAY = 250;
+	/** Maximum number of addresses tried per connection */
+	static constexpr unsigned int MAX_ADDRESSES = 8;
+	//-----------------------------------------------------------------
+	/**
+	 * Sorts the addresses of a host for the connection attempts: the families
+	 * alternate, starting with the host's preferred family (IPv6 unless the
+	 * other family has won recently).
+	 * @param host host's name
+	 * @param addresses the socket addresses, sorted in place
+	 * @param count number of addresses
+	 */
+	static void order(const char *host, SocketAddress addresses[],
+			unsigned int count) noexcept;
+	/**
+	 * Races the connection attempts to the given addresses (see
+	 * Connector::order()), starting a new attempt after the given delay or
+	 * after the failure of the previous one. The first connection to succeed
+	 * wins and the others are abandoned.
+	 * @param host host's name
+	 * @param addresses the socket addresses in the order of preference
+	 * @param count number of addresses
+	 * @param sa stores the winning socket address
+	 * @param delay delay in milliseconds between the connection attempts
+	 * @param timeout overall timeout in milliseconds, negative value to wait
+	 * until each attempt fails.
+	 * @return connected socket's file descriptor in blocking mode
+	 */
+	static int connect(const char *host, const SocketAddress addresses[],
+			unsigned int count, SocketAddress &sa, unsigned int delay =
+					ATTEMPT_DELAY, int timeout = -1);
+	//-----------------------------------------------------------------
+	/**
+	 * Records a successful connection to a host.
+	 * @param host host's name
+	 * @param family the address family of the connection
+	 */
+	static void succeeded(const char *host, int family) noexcept;
+	/**
+	 * Records a failed (or abandoned) connection attempt to a host, the next
+	 * attempts will prefer the other address family if it is available.
+	 * @param host host's name
+	 * @param family the address family of the failed attempt
+	 */
+	static void failed(const char *host, int family) noexcept;
+	/**
+	 * Checks whether a host has addresses of a family other than the given
+	 * one (as observed by Connector::order()).
+	 * @param host host's name
+	 * @param family the address family
+	 * @return true if an alternative address family is known, false otherwise
+	 */
+	static bool hasAlternative(const char *host, int family) noexcept;
+	/**
+	 * Returns the address family of a socket.
+	 * @param sfd socket descriptor
+	 * @return the address family, AF_UNSPEC on error
+	 */
+	static int family(int sfd) noexcept;
+};
+
+} /* namespace wanhive */
+
+#endif /* WH_BASE_IPC_CONNECTOR_H_ */
@@ -0,0 +1,300 @@
+/*
+ * Resolver.cpp
+ *
+ * Asynchronous name resolution with caching
+ *
+ *
+ * Copyright (C) 2025 Wanhive Systems Private Limited (info@wanhive.com)
+ * This program is part of the Wanhive IoT Platform.
+ * Check the COPYING file for the license.
+ *
+ */
+
+#include "Resolver.h"
+#include "DNS.h"
+#include "../common/Atomic.h"
+#include "../common/BaseException.h"
+#include "../common/Exception.h"
+#include "../ds/Twiddler.h"
+#include <cstring>
+
+namespace {
+
+//Serializes the access to the cache and the queue
+class Lock {
+public:
+	Lock(pthread_mutex_t &mutex) noexcept :
+			mutex(mutex) {
+		pthread_mutex_lock(&mutex);
+	}
+
+	~Lock() {
+		pthread_mutex_unlock(&mutex);
+	}
+private:
+	pthread_mutex_t &mutex;
+};
+
+}  // namespace
+
+namespace wanhive {
+
+Resolver::Resolver() noexcept {
+	pthread_mutex_init(&mutex, nullptr);
+	queue.head = 0;
+	queue.count = 0;
+}
+
+Resolver::~Resolver() {
+	stop();
+	pthread_mutex_destroy(&mutex);
+}
+
+void Resolver::start(unsigned int ttl, unsigned int negativeTtl,
+		void (*notify)(void *arg), void *arg) {
+	if (thread) {
+		throw Exception(EX_STATE);
+	}
+
+	this->ttl = ttl;
+	this->negativeTtl = negativeTtl;
+	this->notify = notify;
+	this->arg = arg;
+	Atomic<bool>::store(&running, true, MO_RELEASE);
+	try {
+		thread = new Thread(*this);
+	} catch (...) {
+		Atomic<bool>::store(&running, false, MO_RELEASE);
+		throw;
+	}
+}
+
+void Resolver::stop() noexcept {
+	if (thread) {
+		Atomic<bool>::store(&running, false, MO_RELEASE);
+		gate.signal();
+		try {
+			thread->join();
+		} catch (const BaseException &e) {
+			//Nothing to do
+		}
+		delete thread;
+		thread = nullptr;
+	}
+
+	Lock lock(mutex);
+	cache.clear();
+	queue.head = 0;
+	queue.count = 0;
+}
+
+int Resolver::lookup(const NameInfo &ni, SocketAddress addresses[],
+		unsigned int &count) noexcept {
+	auto capacity = count;
+	if (!addresses || !capacity) {
+		count = 0;
+		return -1;
+	} else if (translate(ni.host, ni.service, AI_NUMERICHOST, addresses,
+			count) == 0) {
+		//Numeric address, nothing to resolve
+		return 0;
+	} else if (!thread) {
+		//Synchronous mode
+		count = capacity;
+		return translate(ni.host, ni.service, 0, addresses, count);
+	}
+	//-----------------------------------------------------------------
+	Lock lock(mutex);
+	auto now = clock.elapsed();
+	auto k = key(ni);
+	auto index = cache.get(k);
+	if (index != cache.end()) {
+		auto &e = *cache.getValueReference(index);
+		if (!matches(e, ni)) {
+			//Hash collision, the latest name takes over the slot
+			cache.remove(index);
+		} else if (e.status == FAILED && e.expiry > now) {
+			count = 0;
+			return -1;
+		} else if (e.status == FAILED) {
+			count = 0;
+			if (enqueue(k)) {
+				e.status = PENDING;
+				return 1;
+			} else {
+				return -1;
+			}
+		} else {
+			if (e.status == RESOLVED && e.expiry <= now && enqueue(k)) {
+				//Serve the stale addresses while refreshing
+				e.status = PENDING;
+			}
+			count = copy(e, addresses, capacity);
+			return count ? 0 : 1;
+		}
+	}
+	//-----------------------------------------------------------------
+	if (cache.size() >= CACHE_SIZE) {
+		evict();
+	}
+
+	count = 0;
+	int ret = 0;
+	if (cache.size() < CACHE_SIZE && (index = cache.put(k, ret)) != cache.end()
+			&& enqueue(k)) {
+		auto &e = *cache.getValueReference(index);
+		memset(&e, 0, sizeof(e));
+		memcpy(e.host, ni.host, strnlen(ni.host, sizeof(e.host) - 1));
+		memcpy(e.service, ni.service,
+				strnlen(ni.service, sizeof(e.service) - 1));
+		e.status = PENDING;
+		return 1;
+	} else {
+		//Try again later
+		cache.removeKey(k);
+		return 1;
+	}
+}
+
+void Resolver::run(void *arg) noexcept {
+	while (isRunning()) {
+		unsigned long long k = 0;
+		Entry e;
+		{
+			Lock lock(mutex);
+			if (!dequeue(k) || !cache.hmGet(k, e)) {
+				k = 0;
+			}
+		}
+
+		if (!k) {
+			gate.wait(1000);
+			continue;
+		}
+		//-----------------------------------------------------------------
+		SocketAddress addresses[MAX_ADDRESSES];
+		unsigned int count = MAX_ADDRESSES;
+		auto ret = translate(e.host, e.service, 0, addresses, count);
+		{
+			Lock lock(mutex);
+			auto index = cache.get(k);
+			auto x = (index != cache.end()) ?
+					cache.getValueReference(index) : nullptr;
+			if (x && !strcmp(x->host, e.host)
+					&& !strcmp(x->service, e.service)) {
+				auto now = clock.elapsed();
+				if (ret == 0) {
+					memcpy(x->addresses, addresses, sizeof(addresses));
+					x->count = count;
+					x->status = RESOLVED;
+					x->expiry = now + ttl;
+				} else if (x->count) {
+					//Keep the stale addresses for a while
+					x->status = RESOLVED;
+					x->expiry = now + negativeTtl;
+				} else {
+					x->status = FAILED;
+					x->expiry = now + negativeTtl;
+				}
+			}
+		}
+
+		if (notify) {
+			notify(this->arg);
+		}
+	}
+}
+
+int Resolver::getStatus() const noexcept {
+	return status;
+}
+
+void Resolver::setStatus(int status) noexcept {
+	this->status = status;
+}
+
+unsigned long long Resolver::key(const NameInfo &ni) noexcept {
+	char name[sizeof(ni.host) + sizeof(ni.service)];
+	auto n = strnlen(ni.host, sizeof(ni.host) - 1);
+	auto m = strnlen(ni.service, sizeof(ni.service) - 1);
+	memcpy(name, ni.host, n);
+	name[n] = '\0';
+	memcpy(name + n + 1, ni.service, m);
+	return Twiddler::wyHash(name, n + m + 1);
+}
+
+bool Resolver::matches(const Entry &e, const NameInfo &ni) noexcept {
+	return !strncmp(e.host, ni.host, sizeof(e.host) - 1)
+			&& !strncmp(e.service, ni.service, sizeof(e.service) - 1);
+}
+
+int Resolver::translate(const char *host, const char *service, int flags,
+		SocketAddress addresses[], unsigned int &count) noexcept {
+	try {
+		SocketTraits traits = { AF_UNSPEC, SOCK_STREAM, 0, flags };
+		DNS dns(host, service, &traits);
+		unsigned int n = 0;
+		const addrinfo *rp;
+		while (n < count && (rp = dns.next())) {
+			DNS::getAddress(rp, addresses[n++]);
+		}
+		count = n;
+		return n ? 0 : -1;
+	} catch (const BaseException &e) {
+		count = 0;
+		return -1;
+	}
+}
+
+unsigned int Resolver::copy(const Entry &e, SocketAddress addresses[],
+		unsigned int count) noexcept {
+	auto n = Twiddler::min(e.count, count);
+	memcpy(addresses, e.addresses, n * sizeof(SocketAddress));
+	return n;
+}
+
+bool Resolver::enqueue(unsigned long long k) noexcept {
+	if (queue.count == QUEUE_SIZE) {
+		return false;
+	} else {
+		queue.keys[(queue.head + queue.count) % QUEUE_SIZE] = k;
+		++queue.count;
+		gate.signal();
+		return true;
+	}
+}
+
+bool Resolver::dequeue(unsigned long long &k) noexcept {
+	if (queue.count == 0) {
+		return false;
+	} else {
+		k = queue.keys[queue.head];
+		queue.head = (queue.head + 1) % QUEUE_SIZE;
+		--queue.count;
+		return true;
+	}
+}
+
+void Resolver::evict() noexcept {
+	//Expired results first, everything except the pending lookups next
+	auto now = clock.elapsed();
+	for (unsigned int pass = 0; pass < 2 && cache.size() >= CACHE_SIZE;
+			++pass) {
+		for (auto i = cache.begin(); i < cache.end(); ++i) {
+			if (!cache.exists(i)) {
+				continue;
+			}
+
+			auto &e = *cache.getValueReference(i);
+			if (e.status != PENDING && (pass || e.expiry <= now)) {
+				cache.remove(i, false);
+			}
+		}
+	}
+}
+
+bool Resolver::isRunning() const noexcept {
+	return Atomic<bool>::load(&running, MO_ACQUIRE);
+}
+
+} /* namespace wanhive */
@@ -0,0 +1,128 @@
+/*
+ * Resolver.h
+ *
+ * Asynchronous name resolution with caching
+ *
+ *
+ * Copyright (C) 2025 Wanhive Systems Private Limited (info@wanhive.com)
+ * This program is part of the Wanhive IoT Platform.
+ * Check the COPYING file for the license.
+ *
+ */
+
+#ifndef WH_BASE_IPC_RESOLVER_H_
+#define WH_BASE_IPC_RESOLVER_H_
+#include "inet.h"
+#include "../Thread.h"
+#include "../Timer.h"
+#include "../TurnGate.h"
+#include "../common/NonCopyable.h"
+#include "../common/Task.h"
+#include "../ds/Khash.h"
+#include <pthread.h>
+
+namespace wanhive {
+/**
+ * Asynchronous name resolution: a dedicated thread performs the blocking
+ * getaddrinfo(3) calls and stores the results in a cache with positive and
+ * negative expiry times. Numeric addresses are translated in place.
+ * Thread safe at class level.
+ */
+class Resolver: public Task, private NonCopyable {
+public:
+	/** Maximum number of addresses cached per name */
+	static constexpr unsigned int MAX_ADDRESSES = 4;
+	/** Maximum number of pending lookups */
+	static constexpr unsigned int QUEUE_SIZE = 64;
+	/** Maximum number of cached names */
+	static constexpr unsigned int CACHE_SIZE = 1024;
+	//-----------------------------------------------------------------
+	/**
+	 * Default constructor: the lookups are synchronous until the resolver
+	 * thread is started.
+	 */
+	Resolver() noexcept;
+	/**
+	 * Destructor: stops the resolver thread.
+	 */
+	~Resolver();
+	//-----------------------------------------------------------------
+	/**
+	 * Starts the resolver thread.
+	 * @param ttl the positive results' lifetime in seconds
+	 * @param negativeTtl the negative results' lifetime in seconds
+	 * @param notify callback function which gets invoked by the resolver
+	 * thread after completing a lookup (can be nullptr).
+	 * @param arg additional argument for the callback function
+	 */
+	void start(unsigned int ttl, unsigned int negativeTtl,
+			void (*notify)(void *arg) = nullptr, void *arg = nullptr);
+	/**
+	 * Stops the resolver thread and clears the cache.
+	 */
+	void stop() noexcept;
+	/**
+	 * Translates a resource name into a list of socket addresses without
+	 * blocking the caller (except for the synchronous mode). An expired
+	 * result is served while it gets refreshed in the background.
+	 * @param ni the resource name
+	 * @param addresses the output array for storing the socket addresses
+	 * @param count before the call it's value should be set to the output
+	 * array's capacity. The actual number of addresses is written to this
+	 * argument.
+	 * @return 0 on success, 1 if the lookup is in progress, -1 on error
+	 */
+	int lookup(const NameInfo &ni, SocketAddress addresses[],
+			unsigned int &count) noexcept;
+	//-----------------------------------------------------------------
+	void run(void *arg) noexcept override;
+	int getStatus() const noexcept override;
+	void setStatus(int status) noexcept override;
+private:
+	struct Entry {
+		char host[NI_MAXHOST];
+		char service[NI_MAXSERV];
+		SocketAddress addresses[MAX_ADDRESSES];
+		unsigned int count;
+		int status;
+		double expiry; //In seconds
+	};
+
+	static unsigned long long key(const NameInfo &ni) noexcept;
+	static bool matches(const Entry &e, const NameInfo &ni) noexcept;
+	static int translate(const char *host, const char *service, int flags,
+			SocketAddress addresses[], unsigned int &count) noexcept;
+	static unsigned int copy(const Entry &e, SocketAddress addresses[],
+			unsigned int count) noexcept;
+	bool enqueue(unsigned long long k) noexcept;
+	bool dequeue(unsigned long long &k) noexcept;
+	void evict() noexcept;
+	bool isRunning() const noexcept;
+
+	enum : int {
+		PENDING, RESOLVED, FAILED
+	};
+private:
+	pthread_mutex_t mutex;
+	TurnGate gate;
+	Timer clock;
+	Thread *thread { nullptr };
+	bool running { false };
+	int status { 0 };
+
+	Kmap<unsigned long long, Entry> cache;
+	struct {
+		unsigned long long keys[QUEUE_SIZE];
+		unsigned int head;
+		unsigned int count;
+	} queue;
+
+	unsigned int ttl { 0 };
+	unsigned int negativeTtl { 0 };
+	void (*notify)(void *arg) { nullptr };
+	void *arg { nullptr };
+};
+
+} /* namespace wanhive */
+
+#endif /* WH_BASE_IPC_RESOLVER_H_ */
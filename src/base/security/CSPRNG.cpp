@@ -12,8 +12,43 @@
 
 #include "CSPRNG.h"
 #include "../Storage.h"
+#include "../common/Atomic.h"
 #include "../common/Exception.h"
+#include <openssl/crypto.h>
 #include <openssl/rand.h>
+#include <cstring>
+#include <pthread.h>
+
+namespace {
+
+//Per-thread buffer of random bytes
+struct Pool {
+	static constexpr unsigned int SIZE = 4096;
+	unsigned char data[SIZE];
+	unsigned int offset { SIZE };
+	unsigned int generation { 0 };
+
+	~Pool() {
+		OPENSSL_cleanse(data, sizeof(data));
+	}
+
+	void discard() noexcept {
+		OPENSSL_cleanse(data + offset, SIZE - offset);
+		offset = SIZE;
+	}
+};
+
+thread_local Pool pool;
+//Incremented in the child process after fork(2)
+unsigned int forks = 0;
+
+void onFork() noexcept {
+	wanhive::Atomic<unsigned int>::fetchAndAdd(&forks, 1);
+}
+
+const int atFork = pthread_atfork(nullptr, nullptr, onFork);
+
+}  // namespace
 
 namespace wanhive {
 class CSPRNG::RandomDevice {
@@ -52,6 +87,35 @@ bool CSPRNG::bytes(void *buffer, unsigned int count) noexcept {
 	return (RAND_bytes((unsigned char*) buffer, count) == 1);
 }
 
+bool CSPRNG::buffered(void *buffer, unsigned int count) noexcept {
+	if (!buffer) {
+		return false;
+	} else if (count > Pool::SIZE / 4) {
+		return bytes(buffer, count);
+	}
+
+	auto &p = pool;
+	auto generation = Atomic<unsigned int>::load(&forks);
+	if (p.generation != generation) {
+		//Inherited from the parent process
+		p.discard();
+		p.generation = generation;
+	}
+
+	if (Pool::SIZE - p.offset < count) {
+		p.discard();
+		if (!bytes(p.data, Pool::SIZE)) {
+			return false;
+		}
+		p.offset = 0;
+	}
+
+	memcpy(buffer, p.data + p.offset, count);
+	OPENSSL_cleanse(p.data + p.offset, count);
+	p.offset += count;
+	return true;
+}
+
 bool CSPRNG::seed(const void *data, int count) noexcept {
 	RAND_seed(data, count);
 	return (RAND_status() == 1);
@@ -27,6 +27,16 @@ public:
 	 * @return true on success, false on failure
 	 */
 	static bool bytes(void *buffer, unsigned int count) noexcept;
+	/**
+	 * Serves the given bytes of randomness from a per-thread buffer which is
+	 * refilled from libcrypto's CSPRNG in large blocks. The served bytes are
+	 * erased from the buffer, and a child process discards the buffer
+	 * inherited from its parent. Large requests bypass the buffer.
+	 * @param buffer output buffer
+	 * @param count random bytes count
+	 * @return true on success, false on failure
+	 */
+	static bool buffered(void *buffer, unsigned int count) noexcept;
 	/**
 	 * Seeds libcrypto's CSPRNG with the given bytes of random data.
 	 * @param data data for seeding the generator
@@ -0,0 +1,123 @@
+/*
+ * Mac.cpp
+ *
+ * Keyed message authentication code
+ *
+ *
+ * Copyright (C) 2025 Wanhive Systems Private Limited (info@wanhive.com)
+ * This program is part of the Wanhive IoT Platform.
+ * Check the COPYING file for the license.
+ *
+ */
+
+#include "Mac.h"
+#include <openssl/crypto.h>
+#include <cstring>
+#if OPENSSL_VERSION_MAJOR >= 3
+#include <openssl/core_names.h>
+#include <openssl/params.h>
+#endif
+
+namespace wanhive {
+
+Mac::Mac(MacType type) noexcept :
+		type(type) {
+	memset(key, 0, sizeof(key));
+}
+
+Mac::~Mac() {
+#if OPENSSL_VERSION_MAJOR >= 3
+	EVP_MAC_CTX_free(ctx);
+#else
+	HMAC_CTX_free(ctx);
+#endif
+	OPENSSL_cleanse(key, sizeof(key));
+}
+
+bool Mac::setKey(const void *key, size_t keyLength) noexcept {
+	if (!key || !keyLength || keyLength > MAX_KEY_LENGTH) {
+		return false;
+	} else if (keyed && keyLength == this->keyLength
+			&& !CRYPTO_memcmp(key, this->key, keyLength)) {
+		return true;
+	} else if (setup(key, keyLength)) {
+		memcpy(this->key, key, keyLength);
+		this->keyLength = keyLength;
+		keyed = true;
+		return true;
+	} else {
+		OPENSSL_cleanse(this->key, sizeof(this->key));
+		this->keyLength = 0;
+		keyed = false;
+		return false;
+	}
+}
+
+bool Mac::create(const void *data, size_t dataLength,
+		unsigned char *mac) noexcept {
+	if (!keyed || !mac || (dataLength && !data)) {
+		return false;
+	}
+
+#if OPENSSL_VERSION_MAJOR >= 3
+	//Re-initialization restores the keyed state without any allocation
+	size_t length = 0;
+	return EVP_MAC_init(ctx, nullptr, 0, nullptr) > 0
+			&& EVP_MAC_update(ctx, (const unsigned char*) data, dataLength) > 0
+			&& EVP_MAC_final(ctx, mac, &length, SIZE) > 0 && length == SIZE;
+#else
+	unsigned int length = 0;
+	return HMAC_Init_ex(ctx, nullptr, 0, nullptr, nullptr)
+			&& HMAC_Update(ctx, (const unsigned char*) data, dataLength)
+			&& HMAC_Final(ctx, mac, &length) && length == SIZE;
+#endif
+}
+
+bool Mac::verify(const void *data, size_t dataLength,
+		const unsigned char *mac) noexcept {
+	unsigned char md[SIZE];
+	auto ret = mac && create(data, dataLength, md)
+			&& !CRYPTO_memcmp(md, mac, SIZE);
+	OPENSSL_cleanse(md, sizeof(md));
+	return ret;
+}
+
+MacType Mac::getType() const noexcept {
+	return type;
+}
+
+bool Mac::setup(const void *key, size_t keyLength) noexcept {
+#if OPENSSL_VERSION_MAJOR >= 3
+	if (!ctx) {
+		auto name = (type == WH_HMAC_SHA512) ? "HMAC" : "BLAKE2BMAC";
+		auto mac = EVP_MAC_fetch(nullptr, name, nullptr);
+		ctx = mac ? EVP_MAC_CTX_new(mac) : nullptr;
+		EVP_MAC_free(mac); //The context holds a reference
+		if (!ctx) {
+			return false;
+		}
+	}
+
+	size_t size = SIZE;
+	OSSL_PARAM params[2];
+	if (type == WH_HMAC_SHA512) {
+		params[0] = OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST,
+				(char*) "SHA512", 0);
+	} else {
+		params[0] = OSSL_PARAM_construct_size_t(OSSL_MAC_PARAM_SIZE, &size);
+	}
+	params[1] = OSSL_PARAM_construct_end();
+	return EVP_MAC_init(ctx, (const unsigned char*) key, keyLength, params)
+			> 0;
+#else
+	if (type != WH_HMAC_SHA512) {
+		return false;
+	} else if (!ctx && !(ctx = HMAC_CTX_new())) {
+		return false;
+	} else {
+		return HMAC_Init_ex(ctx, key, keyLength, EVP_sha512(), nullptr);
+	}
+#endif
+}
+
+} /* namespace wanhive */
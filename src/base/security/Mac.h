@@ -0,0 +1,99 @@
+/*
+ * Mac.h
+ *
+ * Keyed message authentication code
+ *
+ *
+ * Copyright (C) 2025 Wanhive Systems Private Limited (info@wanhive.com)
+ * This program is part of the Wanhive IoT Platform.
+ * Check the COPYING file for the license.
+ *
+ */
+
+#ifndef WH_BASE_SECURITY_MAC_H_
+#define WH_BASE_SECURITY_MAC_H_
+#include "../common/NonCopyable.h"
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <openssl/opensslv.h>
+
+namespace wanhive {
+//-----------------------------------------------------------------
+/**
+ * Supported message authentication code types
+ */
+enum MacType {
+	WH_HMAC_SHA512, /**< HMAC-SHA-512 */
+	WH_BLAKE2B512 /**< Keyed BLAKE2b-512 (requires OpenSSL 3) */
+};
+//-----------------------------------------------------------------
+/**
+ * Keyed message authentication code with a reusable context: the key is set
+ * up once and each MAC computation only re-initializes the keyed state.
+ */
+class Mac: private NonCopyable {
+public:
+	/**
+	 * Constructor: assigns a message authentication code type.
+	 * @param type the message authentication code type
+	 */
+	Mac(MacType type) noexcept;
+	/**
+	 * Destructor: clears the key.
+	 */
+	~Mac();
+	//-----------------------------------------------------------------
+	/**
+	 * Sets up the key, does nothing if the same key has already been set up.
+	 * @param key the secret key
+	 * @param keyLength key's size in bytes (at most Mac::MAX_KEY_LENGTH)
+	 * @return true on success, false on error
+	 */
+	bool setKey(const void *key, size_t keyLength) noexcept;
+	/**
+	 * Computes the message authentication code of the given data using the
+	 * current key (see Mac::setKey()).
+	 * @param data input data
+	 * @param dataLength input data's size in bytes
+	 * @param mac buffer for storing the MAC (Mac::SIZE bytes)
+	 * @return true on success, false on error
+	 */
+	bool create(const void *data, size_t dataLength,
+			unsigned char *mac) noexcept;
+	/**
+	 * Compares the given MAC with the MAC of the given data in constant time.
+	 * @param data input data
+	 * @param dataLength input data's size in bytes
+	 * @param mac the MAC for comparison (Mac::SIZE bytes)
+	 * @return true on successful match, false otherwise
+	 */
+	bool verify(const void *data, size_t dataLength,
+			const unsigned char *mac) noexcept;
+	/**
+	 * Returns the message authentication code type.
+	 * @return MAC type
+	 */
+	MacType getType() const noexcept;
+public:
+	/** MAC size in bytes */
+	static constexpr unsigned int SIZE = 64;
+	/** Maximum key size in bytes (HMAC-SHA-512's block size, BLAKE2b accepts
+	 * at most 64 bytes) */
+	static constexpr unsigned int MAX_KEY_LENGTH = 128;
+private:
+	bool setup(const void *key, size_t keyLength) noexcept;
+private:
+#if OPENSSL_VERSION_MAJOR >= 3
+	EVP_MAC_CTX *ctx { nullptr };
+#else
+	HMAC_CTX *ctx { nullptr };
+#endif
+	const MacType type;
+	bool keyed { false };
+	size_t keyLength { 0 };
+	unsigned char key[MAX_KEY_LENGTH];
+};
+
+} /* namespace wanhive */
+
+#endif /* WH_BASE_SECURITY_MAC_H_ */
@@ -22,6 +22,7 @@ Sha::Sha(DigestType type) noexcept :
 
 Sha::~Sha() {
 	EVP_MD_CTX_free(ctx);
+	EVP_MD_CTX_free(oneShot);
 }
 
 bool Sha::init() noexcept {
@@ -51,12 +52,24 @@ bool Sha::final(unsigned char *messageDigest, unsigned int *size) noexcept {
 
 bool Sha::create(const unsigned char *data, size_t dataLength,
 		unsigned char *messageDigest, unsigned int *size) noexcept {
-	if (!dataLength || (data && messageDigest)) {
-		return (EVP_Digest(data, dataLength, messageDigest, size, selectType(),
-				nullptr) > 0);
-	} else {
+	if (dataLength && !(data && messageDigest)) {
 		return false;
 	}
+
+	//Reinitialization skips the costly algorithm lookup
+	if (!oneShot) {
+		if (!(oneShot = EVP_MD_CTX_new())
+				|| EVP_DigestInit_ex(oneShot, selectType(), nullptr) <= 0) {
+			EVP_MD_CTX_free(oneShot);
+			oneShot = nullptr;
+			return false;
+		}
+	} else if (EVP_DigestInit_ex(oneShot, nullptr, nullptr) <= 0) {
+		return false;
+	}
+
+	return (EVP_DigestUpdate(oneShot, data, dataLength) > 0)
+			&& (EVP_DigestFinal_ex(oneShot, messageDigest, size) > 0);
 }
 
 bool Sha::verify(const unsigned char *data, size_t dataLength,
@@ -63,7 +63,9 @@ public:
 	bool final(unsigned char *messageDigest,
 			unsigned int *size = nullptr) noexcept;
 	/**
-	 * Hashes the given data and returns the hash value.
+	 * Hashes the given data and returns the hash value. Uses a separate
+	 * context which is reused across the calls, doesn't interfere with the
+	 * Sha::init(), Sha::update(), and Sha::final() sequence.
 	 * @param data input data for hashing
 	 * @param dataLength input data's size in bytes
 	 * @param messageDigest buffer for storing the digest value
@@ -105,6 +107,7 @@ private:
 	const EVP_MD* selectType() const noexcept;
 private:
 	EVP_MD_CTX *ctx;
+	EVP_MD_CTX *oneShot { nullptr }; //For Sha::create()
 	const DigestType type;
 	const unsigned int _length; //Digest length in bytes
 };
@@ -298,9 +298,27 @@ void Hub::configure(void *arg) {
 		ctx.verbosity = conf.getNumber("HUB", "verbosity", WH_LOGLEVEL_DEBUG);
 		Logger::getDefault().setLevel(ctx.verbosity);
 		ctx.verbosity = Logger::getDefault().getLevel();
+		ctx.logQueue = conf.getNumber("HUB", "logQueue");
+		ctx.logOverflow = Twiddler::min(
+				conf.getNumber("HUB", "logOverflow", WH_LOG_COUNT),
+				(unsigned int) WH_LOG_BLOCK);
+		if (ctx.logQueue && !Logger::getDefault().isAsynchronous()
+				&& !Logger::getDefault().start(ctx.logQueue,
+						(LogOverflow) ctx.logOverflow)) {
+			throw Exception(EX_RESOURCE);
+		}
+
+		//Structured (binary) logs are disabled if the path is not set
+		auto structuredLog = conf.getPathName("HUB", "structuredLog");
+		auto opened = !structuredLog
+				|| Logger::getDefault().openStructured(structuredLog);
+		free(structuredLog);
+		if (!opened) {
+			throw Exception(EX_RESOURCE);
+		}
 		//-----------------------------------------------------------------
 		WH_LOG_DEBUG(
-				"Hub setings:\n" "LISTEN=%s, BACKLOG=%d, SERVICE_NAME='%s', SERVICE_TYPE='%s',\n" "MAX_IO_EVENTS=%u, TIMER_EXPIRATION=%ums, TIMER_INTERVAL=%ums, SEMAPHORE=%s,\n" "SYNCHRONOUS_SIGNAL=%s, CONNECTION_POOL_SIZE=%u, MESSAGE_POOL_SIZE=%u,\n" "MAX_NEW_CONNECTIONS=%u, TMP_CONNECTION_TIMEOUT=%ums, CYCLE_IN_LIMIT=%u,\n" "OUT_QUEUE_LIMIT=%u, THROTTLE=%s, RESERVED_MESSAGES=%u, ALLOW_PACKET_DROP=%s,\n" "MESSAGE_TTL=%u, ANSWER_RATIO=%f, FORWARD_RATIO=%f, LOG_LEVEL=%s\n",
+				"Hub setings:\n" "LISTEN=%s, BACKLOG=%d, SERVICE_NAME='%s', SERVICE_TYPE='%s',\n" "MAX_IO_EVENTS=%u, TIMER_EXPIRATION=%ums, TIMER_INTERVAL=%ums, SEMAPHORE=%s,\n" "SYNCHRONOUS_SIGNAL=%s, CONNECTION_POOL_SIZE=%u, MESSAGE_POOL_SIZE=%u,\n" "MAX_NEW_CONNECTIONS=%u, TMP_CONNECTION_TIMEOUT=%ums, CYCLE_IN_LIMIT=%u,\n" "OUT_QUEUE_LIMIT=%u, THROTTLE=%s, RESERVED_MESSAGES=%u, ALLOW_PACKET_DROP=%s,\n" "MESSAGE_TTL=%u, ANSWER_RATIO=%f, FORWARD_RATIO=%f, LOG_LEVEL=%s,\n" "LOG_QUEUE=%u, LOG_OVERFLOW=%s\n",
 				WH_BOOLF(ctx.listen), ctx.backlog, ctx.serviceName,
 				ctx.serviceType, ctx.maxIOEvents, ctx.timerExpiration,
 				ctx.timerInterval, WH_BOOLF(ctx.semaphore),
@@ -310,7 +328,9 @@ void Hub::configure(void *arg) {
 				ctx.outputQueueLimit, WH_BOOLF(ctx.throttle),
 				ctx.reservedMessages, WH_BOOLF(ctx.allowPacketDrop),
 				ctx.messageTTL, ctx.answerRatio, ctx.forwardRatio,
-				Logger::levelString(Logger::getDefault().getLevel()));
+				Logger::levelString(Logger::getDefault().getLevel()),
+				ctx.logQueue,
+				Logger::overflowString((LogOverflow) ctx.logOverflow));
 		//-----------------------------------------------------------------
 		/*
 		 * Initialization of the core data structures
@@ -361,6 +381,9 @@ void Hub::cleanup() noexcept {
 		//-----------------------------------------------------------------
 		//6. Print goodbye message
 		WH_LOG_INFO("Shutdown completed.\n\n");
+		//7. Write out the buffered logs
+		Logger::getDefault().stop();
+		Logger::getDefault().closeStructured();
 	} catch (const BaseException &e) {
 		//Memory leak, do not try to recover
 		WH_LOG_EXCEPTION(e);
@@ -382,6 +405,10 @@ bool Hub::trap(Message *message) noexcept {
 	return false;
 }
 
+void Hub::defer(Message *message) noexcept {
+
+}
+
 void Hub::route(Message *message) noexcept {
 
 }
@@ -792,10 +819,17 @@ void Hub::publish() noexcept {
 		}
 
 		//Verify the destination
-		if (msg->getDestination() == getUid()
-				|| !(w = find(msg->getDestination()))
-				|| w->testGroup(msg->getGroup())) {
-			//Destination is sink or not found or group conflict
+		if (msg->getDestination() == getUid()) {
+			//Destination is sink
+			Message::recycle(msg);
+			continue;
+		} else if (!(w = find(msg->getDestination()))) {
+			//Destination not found
+			defer(msg);
+			Message::recycle(msg);
+			continue;
+		} else if (w->testGroup(msg->getGroup())) {
+			//Group conflict
 			Message::recycle(msg);
 			continue;
 		}
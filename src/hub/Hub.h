@@ -205,6 +205,12 @@ private:
 	 * @return true to discard (recycle) the message, false otherwise
 	 */
 	virtual bool trap(Message *message) noexcept;
+	/**
+	 * Adapter: processes a message whose destination is not connected to this
+	 * hub. The message is recycled after the call.
+	 * @param message the undeliverable message
+	 */
+	virtual void defer(Message *message) noexcept;
 	/**
 	 * Adapter: processes an incoming message and creates a route for it.
 	 * @param message the message to process
@@ -421,6 +427,10 @@ private:
 		double forwardRatio;	//Reserved for routing
 		//Log verbosity
 		unsigned int verbosity;
+		//Asynchronous logger's capacity in records (0 for synchronous logs)
+		unsigned int logQueue;
+		//Asynchronous logger's overflow policy (DROP=0;COUNT=1;BLOCK=2)
+		unsigned int logOverflow;
 	} ctx;
 	//-----------------------------------------------------------------
 	/*
@@ -11,14 +11,16 @@
  */
 
 #include "HubInfo.h"
-#include "../base/ds/Serializer.h"
+#include "../base/ds/Layout.h"
 #include <cstdio>
 
 namespace {
 
-constexpr unsigned int infoBytes() noexcept {
-	return (6 * sizeof(uint64_t)) + (5 * sizeof(uint32_t));
-}
+//Wire format: "QgQQQQLLLLL"
+using Info = wanhive::Layout<wanhive::WireU64, wanhive::WireF64,
+		wanhive::WireU64, wanhive::WireU64, wanhive::WireU64, wanhive::WireU64,
+		wanhive::WireU32, wanhive::WireU32, wanhive::WireU32, wanhive::WireU32,
+		wanhive::WireU32>;
 
 }  // namespace
 
@@ -100,44 +102,17 @@ void HubInfo::setMTU(unsigned int mtu) noexcept {
 
 unsigned int HubInfo::pack(unsigned char *buffer,
 		unsigned int size) const noexcept {
-	return Serializer::pack(buffer, size, "QgQQQQLLLLL", uid, uptime,
-			received.units, received.bytes, dropped.units, dropped.bytes,
-			connections.max, connections.used, messages.max, messages.used, mtu);
+	static_assert(Info::SIZE == BYTES, "Invalid layout");
+	return Info::pack(buffer, size, uid, uptime, received.units,
+			received.bytes, dropped.units, dropped.bytes, connections.max,
+			connections.used, messages.max, messages.used, mtu);
 }
 
 unsigned int HubInfo::unpack(const unsigned char *buffer,
 		unsigned int size) noexcept {
-	if (!buffer || size < infoBytes()) {
-		return 0;
-	}
-
-	unsigned int index = 0;
-	uid = Serializer::unpacku64(buffer + index);
-	index += sizeof(uint64_t);
-	uptime = Serializer::unpackf64(buffer + index);
-	index += sizeof(uint64_t);
-
-	received.units = Serializer::unpacku64(buffer + index);
-	index += sizeof(uint64_t);
-	received.bytes = Serializer::unpacku64(buffer + index);
-	index += sizeof(uint64_t);
-	dropped.units = Serializer::unpacku64(buffer + index);
-	index += sizeof(uint64_t);
-	dropped.bytes = Serializer::unpacku64(buffer + index);
-	index += sizeof(uint64_t);
-
-	connections.max = Serializer::unpacku32(buffer + index);
-	index += sizeof(uint32_t);
-	connections.used = Serializer::unpacku32(buffer + index);
-	index += sizeof(uint32_t);
-	messages.max = Serializer::unpacku32(buffer + index);
-	index += sizeof(uint32_t);
-	messages.used = Serializer::unpacku32(buffer + index);
-	index += sizeof(uint32_t);
-
-	mtu = Serializer::unpacku32(buffer + index);
-	index += sizeof(uint32_t);
-	return index;
+	return Info::unpack(buffer, size, uid, uptime, received.units,
+			received.bytes, dropped.units, dropped.bytes, connections.max,
+			connections.used, messages.max, messages.used, mtu);
 }
 
 void HubInfo::print() const noexcept {
@@ -15,9 +15,10 @@
 #include "../base/Timer.h"
 #include "../base/common/Exception.h"
 #include "../base/common/Logger.h"
-#include "../base/ds/MersenneTwister.h"
+#include "../base/ds/Xoshiro.h"
 #include <cstdlib>
 #include <cstring>
+#include <strings.h>
 
 #ifndef WH_CONF_BASE
 #define WH_CONF_BASE "~/.config/wanhive"
@@ -51,6 +52,7 @@ Identity::~Identity() {
 	free(paths.configurationFile);
 	free(paths.hostsDB);
 	free(paths.hostsFile);
+	free(paths.hostsSnapshot);
 	free(paths.privateKey);
 	free(paths.publicKey);
 	free(paths.sslRoot);
@@ -98,7 +100,7 @@ SSLContext* Identity::getSSLContext() noexcept {
 bool Identity::generateNonce(Hash &hash, uint64_t salt, uint64_t id,
 		Digest *nonce) const noexcept {
 	if (instanceId) {
-		instanceId->generateNonce(hash, salt, id, nonce);
+		instanceId->generateNonce(hash, salt, id, nonce, auth.nonce);
 		return true;
 	} else {
 		return false;
@@ -108,14 +110,20 @@ bool Identity::generateNonce(Hash &hash, uint64_t salt, uint64_t id,
 bool Identity::verifyNonce(Hash &hash, uint64_t salt, uint64_t id,
 		const Digest *nonce) const noexcept {
 	if (instanceId) {
-		return instanceId->verifyNonce(hash, salt, id, nonce);
+		return instanceId->verifyNonce(hash, salt, id, nonce, auth.nonce);
 	} else {
 		return false;
 	}
 }
 
 void Identity::getAddress(uint64_t uid, NameInfo &ni) {
-	if (hosts.get(uid, ni) == 0) {
+	if (snapshot.isOpen()) {
+		if (snapshot.get(uid, ni) == 0) {
+			return;
+		} else {
+			throw Exception(EX_OPERATION);
+		}
+	} else if (hosts.get(uid, ni) == 0) {
 		return;
 	} else {
 		throw Exception(EX_OPERATION);
@@ -125,7 +133,9 @@ void Identity::getAddress(uint64_t uid, NameInfo &ni) {
 unsigned int Identity::getIdentifiers(unsigned long long nodes[],
 		unsigned int count, int type) noexcept {
 	auto n = count;
-	if (hosts.list(nodes, n, type) == 0) {
+	if (snapshot.isOpen()) {
+		return (snapshot.list(nodes, n, type) == 0) ? n : 0;
+	} else if (hosts.list(nodes, n, type) == 0) {
 		return n;
 	} else {
 		return 0;
@@ -160,9 +170,9 @@ unsigned int Identity::getIdentifiers(const char *section, const char *option,
 	Storage::closeStream(fp);
 	//--------------------------------------------------------------------------
 	//Apply Fisher–Yates shuffle algorithm
-	MersenneTwister mt(Timer::timeSeed());
+	Xoshiro prng(Timer::timeSeed());
 	for (unsigned int x = 0; x < i; ++x) {
-		auto j = mt.next() % (x + 1);
+		auto j = prng.next(x + 1);
 		auto tmp = nodes[j];
 		nodes[j] = nodes[x];
 		nodes[x] = tmp;
@@ -188,6 +198,8 @@ const char* Identity::dataPathName(int context) const noexcept {
 		return paths.sslCertificate;
 	case CTX_SSL_PRIVATE:
 		return paths.sslHostKey;
+	case CTX_HOSTS_SNAPSHOT:
+		return paths.hostsSnapshot;
 	default:
 		return nullptr;
 	}
@@ -219,6 +231,9 @@ void Identity::reload(int context) {
 	case CTX_SSL_PRIVATE:
 		loadSSLHostKey();
 		break;
+	case CTX_HOSTS_SNAPSHOT:
+		loadHostsSnapshot();
+		break;
 	default:
 		throw Exception(EX_ARGUMENT);
 		break;
@@ -267,16 +282,30 @@ void Identity::loadConfiguration() {
 void Identity::loadHosts() {
 	free(paths.hostsDB);
 	free(paths.hostsFile);
-	paths.hostsDB = properties.getPathName("HOSTS", "hostsDb");
-	if (!paths.hostsDB) {
-		paths.hostsFile = properties.getPathName("HOSTS", "hostsFile");
+	free(paths.hostsSnapshot);
+	paths.hostsSnapshot = properties.getPathName("HOSTS", "hostsSnapshot");
+	if (paths.hostsSnapshot) {
+		paths.hostsDB = nullptr;
 	} else {
+		paths.hostsDB = properties.getPathName("HOSTS", "hostsDb");
+	}
+
+	if (paths.hostsSnapshot || paths.hostsDB) {
 		paths.hostsFile = nullptr;
+	} else {
+		paths.hostsFile = properties.getPathName("HOSTS", "hostsFile");
 	}
 	//-----------------------------------------------------------------
 	try {
-		if (!paths.hostsDB && !paths.hostsFile) {
+		if (!paths.hostsSnapshot) {
+			//Fall back to the database
+			snapshot.close();
+		}
+
+		if (!paths.hostsSnapshot && !paths.hostsDB && !paths.hostsFile) {
 			WH_LOG_WARNING("No hosts file or database");
+		} else if (paths.hostsSnapshot) {
+			loadHostsSnapshot();
 		} else if (paths.hostsDB) {
 			loadHostsDatabase();
 		} else {
@@ -289,6 +318,8 @@ void Identity::loadHosts() {
 		paths.hostsDB = nullptr;
 		free(paths.hostsFile);
 		paths.hostsFile = nullptr;
+		free(paths.hostsSnapshot);
+		paths.hostsSnapshot = nullptr;
 		throw;
 	}
 }
@@ -308,6 +339,19 @@ void Identity::loadKeys() {
 	} else {
 		WH_LOG_INFO("Host verification enabled");
 	}
+
+	auto nonceHash = properties.getString("KEYS", "nonceHash", "SHA512");
+	if (!strcasecmp(nonceHash, "HMAC-SHA512")) {
+		auth.nonce = WH_NONCE_HMAC;
+		nonceHash = "HMAC-SHA512";
+	} else if (!strcasecmp(nonceHash, "BLAKE2B")) {
+		auth.nonce = WH_NONCE_BLAKE2B;
+		nonceHash = "BLAKE2B";
+	} else {
+		auth.nonce = WH_NONCE_SHA512;
+		nonceHash = "SHA512";
+	}
+	WH_LOG_INFO("Nonce algorithm: %s", nonceHash);
 	//-----------------------------------------------------------------
 	try {
 		if (!paths.publicKey && !paths.privateKey) {
@@ -396,6 +440,22 @@ void Identity::loadHostsFile() {
 	}
 }
 
+void Identity::loadHostsSnapshot() {
+	try {
+		if (!paths.hostsSnapshot) {
+			WH_LOG_WARNING("No hosts snapshot");
+		} else {
+			//Atomically replaces the mapping, in-flight lookups are safe
+			snapshot.open(paths.hostsSnapshot);
+			WH_LOG_DEBUG("Hosts loaded from %s (%u records)",
+					paths.hostsSnapshot, snapshot.count());
+		}
+	} catch (const BaseException &e) {
+		WH_LOG_EXCEPTION(e);
+		throw;
+	}
+}
+
 void Identity::loadPrivateKey() {
 	try {
 		if (!paths.privateKey) {
@@ -13,6 +13,7 @@
 #ifndef WH_HUB_IDENTITY_H_
 #define WH_HUB_IDENTITY_H_
 #include "../util/Hosts.h"
+#include "../util/HostsSnapshot.h"
 #include "../util/InstanceID.h"
 #include "../util/PKI.h"
 #include "../base/Configuration.h"
@@ -129,6 +130,7 @@ private:
 	void loadSSL();
 	void loadHostsDatabase();
 	void loadHostsFile();
+	void loadHostsSnapshot();
 	void loadPrivateKey();
 	void loadPublicKey();
 	void loadSSLCertificate();
@@ -153,7 +155,8 @@ public:
 		CTX_PKI_PUBLIC, /**< Public key */
 		CTX_SSL_ROOT, /**< Root CA certificate */
 		CTX_SSL_CERTIFICATE, /**< SSL certificate */
-		CTX_SSL_PRIVATE /**< SSL private key */
+		CTX_SSL_PRIVATE, /**< SSL private key */
+		CTX_HOSTS_SNAPSHOT /**< Compiled hosts snapshot */
 	};
 private:
 	//Unique ID of the currently running instance
@@ -162,12 +165,15 @@ private:
 	Configuration properties;
 	//The hosts database
 	Hosts hosts;
+	//Memory-mapped hosts directory, preferred over the database
+	HostsSnapshot snapshot;
 
 	//For authentication
 	struct {
 		PKI pki;
 		bool enabled { false };
 		bool verify { false };
+		NonceType nonce { WH_NONCE_SHA512 };
 	} auth;
 
 	//For SSL/TLS
@@ -185,6 +191,8 @@ private:
 		char *hostsDB { nullptr };
 		//Clear text hosts file's pathname
 		char *hostsFile { nullptr };
+		//Compiled hosts snapshot's pathname
+		char *hostsSnapshot { nullptr };
 		//Private key file's pathname
 		char *privateKey { nullptr };
 		//Public key file's pathname
@@ -11,8 +11,10 @@
  */
 
 #include "Protocol.h"
+#include "../base/ds/Layout.h"
 #include "../base/ds/Serializer.h"
 #include "../util/commands.h"
+#include <cstring>
 
 namespace wanhive {
 
@@ -177,6 +179,45 @@ bool Protocol::bootstrapRequest(uint64_t host, uint64_t keys[],
 			&& processBootstrapResponse(keys, limit);
 }
 
+unsigned int Protocol::createAuthorizeRequest(uint64_t host, uint64_t expiry,
+		const Digest *tag) noexcept {
+	if (!tag) {
+		return 0;
+	} else {
+		clear();
+		header().setAddress(getSource(), host);
+		header().setControl(HEADER_SIZE + sizeof(uint64_t) + Hash::SIZE,
+				nextSequenceNumber(), 0);
+		header().setContext(WH_CMD_BASIC, WH_QLF_AUTHORIZE, WH_AQLF_REQUEST);
+		packHeader();
+		Serializer::packi64(payload(), expiry);
+		memcpy(payload(sizeof(uint64_t)), tag, Hash::SIZE);
+		return header().getLength();
+	}
+}
+
+unsigned int Protocol::processAuthorizeResponse() const noexcept {
+	if (!validate()) {
+		return 0;
+	} else if (!checkContext(WH_CMD_BASIC, WH_QLF_AUTHORIZE, WH_AQLF_ACCEPTED)) {
+		return 0;
+	} else {
+		return header().getLength();
+	}
+}
+
+bool Protocol::authorizeRequest(uint64_t host, uint64_t expiry,
+		const Digest *tag) {
+	/*
+	 * HEADER: SRC=0, DEST=X, ....CMD=1, QLF=4, AQLF=0/1/127
+	 * BODY: 8 bytes as <expiry> and 64 bytes as <tag> in Request; 0 bytes in
+	 * Response
+	 * TOTAL: 32+8+64=104 bytes in Request; 32 bytes in Response
+	 */
+	return createAuthorizeRequest(host, expiry, tag) && executeRequest()
+			&& processAuthorizeResponse();
+}
+
 unsigned int Protocol::createPublishRequest(uint64_t host, uint8_t topic,
 		const Data &data) noexcept {
 	if ((data.length && !data.base) || data.length > PAYLOAD_SIZE) {
@@ -270,7 +311,223 @@ bool Protocol::unsubscribeRequest(uint64_t host, uint8_t topic) {
 			&& processUnsubscribeResponse(topic);
 }
 
+unsigned int Protocol::createExtendedPublishRequest(uint64_t host,
+		uint64_t topic, const Data &data) noexcept {
+	if ((data.length && !data.base)
+			|| data.length > (PAYLOAD_SIZE - sizeof(uint64_t))) {
+		return 0;
+	} else {
+		clear();
+		header().setAddress(getSource(), host);
+		header().setControl(HEADER_SIZE + sizeof(uint64_t) + data.length,
+				nextSequenceNumber(), 0);
+		header().setContext(WH_CMD_MULTICAST, WH_QLF_XPUBLISH, WH_AQLF_REQUEST);
+		packHeader();
+		Serializer::packi64(payload(), topic);
+		if (data.base) {
+			Serializer::packib(payload(sizeof(uint64_t)), data.base,
+					data.length);
+		}
+		return header().getLength();
+	}
+}
+
+bool Protocol::extendedPublishRequest(uint64_t host, uint64_t topic,
+		const Data &data) {
+	/*
+	 * HEADER: SRC=0, DEST=X, ....CMD=2, QLF=3, AQLF=0/1/127
+	 * BODY: 8 bytes as <topic> + variable in Request; no Response
+	 * TOTAL: at least 32+8=40 bytes in Request; no Response
+	 */
+	return createExtendedPublishRequest(host, topic, data) && (send(), true);
+}
+
+unsigned int Protocol::createExtendedSubscribeRequest(uint64_t host,
+		uint64_t topic, const Data &filter) noexcept {
+	if ((filter.length && !filter.base)
+			|| filter.length > (PAYLOAD_SIZE - sizeof(uint64_t))) {
+		return 0;
+	} else {
+		clear();
+		header().setAddress(getSource(), host);
+		header().setControl(HEADER_SIZE + sizeof(uint64_t) + filter.length,
+				nextSequenceNumber(), 0);
+		header().setContext(WH_CMD_MULTICAST, WH_QLF_XSUBSCRIBE,
+				WH_AQLF_REQUEST);
+		packHeader();
+		Serializer::packi64(payload(), topic);
+		if (filter.base) {
+			Serializer::packib(payload(sizeof(uint64_t)), filter.base,
+					filter.length);
+		}
+		return header().getLength();
+	}
+}
+
+unsigned int Protocol::processExtendedSubscribeResponse(
+		uint64_t topic) const noexcept {
+	if (!validate()) {
+		return 0;
+	} else if (!checkContext(WH_CMD_MULTICAST, WH_QLF_XSUBSCRIBE)) {
+		return 0;
+	} else if (header().getLength() >= HEADER_SIZE + sizeof(uint64_t)
+			&& Serializer::unpacku64(payload()) == topic) {
+		return header().getLength();
+	} else {
+		return 0;
+	}
+}
+
+bool Protocol::extendedSubscribeRequest(uint64_t host, uint64_t topic,
+		const Data &filter) {
+	/*
+	 * HEADER: SRC=0, DEST=X, ....CMD=2, QLF=4, AQLF=0/1/127
+	 * BODY: 8 bytes as <topic> + optional content filter (N*12 bytes) in
+	 * Request; same in Response
+	 * TOTAL: 32+8+N*12 bytes in Request; same in Response
+	 */
+	return createExtendedSubscribeRequest(host, topic, filter)
+			&& executeRequest()
+			&& processExtendedSubscribeResponse(topic);
+}
+
+unsigned int Protocol::createExtendedUnsubscribeRequest(uint64_t host,
+		uint64_t topic) noexcept {
+	clear();
+	header().setAddress(getSource(), host);
+	header().setControl(HEADER_SIZE + sizeof(uint64_t), nextSequenceNumber(),
+			0);
+	header().setContext(WH_CMD_MULTICAST, WH_QLF_XUNSUBSCRIBE,
+			WH_AQLF_REQUEST);
+	packHeader();
+	Serializer::packi64(payload(), topic);
+	return header().getLength();
+}
+
+unsigned int Protocol::processExtendedUnsubscribeResponse(
+		uint64_t topic) const noexcept {
+	if (!validate()) {
+		return 0;
+	} else if (!checkContext(WH_CMD_MULTICAST, WH_QLF_XUNSUBSCRIBE)) {
+		return 0;
+	} else if (header().getLength() == HEADER_SIZE + sizeof(uint64_t)
+			&& Serializer::unpacku64(payload()) == topic) {
+		return header().getLength();
+	} else {
+		return 0;
+	}
+}
+
+bool Protocol::extendedUnsubscribeRequest(uint64_t host, uint64_t topic) {
+	/*
+	 * HEADER: SRC=0, DEST=X, ....CMD=2, QLF=5, AQLF=0/1/127
+	 * BODY: 8 bytes as <topic> in Request; 8 bytes as <topic> in Response
+	 * TOTAL: 32+8=40 bytes in Request; 32+8=40 bytes in Response
+	 */
+	return createExtendedUnsubscribeRequest(host, topic) && executeRequest()
+			&& processExtendedUnsubscribeResponse(topic);
+}
+
+unsigned int Protocol::createNamedPublishRequest(uint64_t host,
+		const char *name, const Data &data) noexcept {
+	return createNamedRequest(host, WH_QLF_NPUBLISH, name, data);
+}
+
+bool Protocol::namedPublishRequest(uint64_t host, const char *name,
+		const Data &data) {
+	/*
+	 * HEADER: SRC=0, DEST=X, ....CMD=2, QLF=6, AQLF=0/1/127
+	 * BODY: 1 byte as <length> + <length> bytes as <name> + variable in
+	 * Request; no Response
+	 * TOTAL: at least 32+1+1=34 bytes in Request; no Response
+	 */
+	return createNamedPublishRequest(host, name, data) && (send(), true);
+}
+
+unsigned int Protocol::createNamedSubscribeRequest(uint64_t host,
+		const char *filter, const Data &content) noexcept {
+	return createNamedRequest(host, WH_QLF_NSUBSCRIBE, filter, content);
+}
+
+unsigned int Protocol::processNamedSubscribeResponse(
+		const char *filter) const noexcept {
+	return processNamedResponse(WH_QLF_NSUBSCRIBE, filter);
+}
+
+bool Protocol::namedSubscribeRequest(uint64_t host, const char *filter,
+		const Data &content) {
+	/*
+	 * HEADER: SRC=0, DEST=X, ....CMD=2, QLF=7, AQLF=0/1/127
+	 * BODY: 1 byte as <length> + <length> bytes as <filter> + optional
+	 * content filter (N*12 bytes) in Request; same in Response
+	 * TOTAL: at least 32+1+1=34 bytes in Request; same in Response
+	 */
+	return createNamedSubscribeRequest(host, filter, content)
+			&& executeRequest()
+			&& processNamedSubscribeResponse(filter);
+}
+
+unsigned int Protocol::createNamedUnsubscribeRequest(uint64_t host,
+		const char *filter) noexcept {
+	return createNamedRequest(host, WH_QLF_NUNSUBSCRIBE, filter,
+			{ nullptr, 0 });
+}
+
+unsigned int Protocol::processNamedUnsubscribeResponse(
+		const char *filter) const noexcept {
+	return processNamedResponse(WH_QLF_NUNSUBSCRIBE, filter);
+}
+
+bool Protocol::namedUnsubscribeRequest(uint64_t host, const char *filter) {
+	/*
+	 * HEADER: SRC=0, DEST=X, ....CMD=2, QLF=8, AQLF=0/1/127
+	 * BODY: 1 byte as <length> + <length> bytes as <filter> in Request;
+	 * same in Response
+	 * TOTAL: at least 32+1+1=34 bytes in Request; same in Response
+	 */
+	return createNamedUnsubscribeRequest(host, filter) && executeRequest()
+			&& processNamedUnsubscribeResponse(filter);
+}
+
 //-----------------------------------------------------------------
+unsigned int Protocol::createNamedRequest(uint64_t host, uint8_t qualifier,
+		const char *name, const Data &data) noexcept {
+	auto length = name ? strlen(name) : 0;
+	if (!length || length > UINT8_MAX || (data.length && !data.base)
+			|| data.length > (PAYLOAD_SIZE - 1 - length)) {
+		return 0;
+	} else {
+		clear();
+		header().setAddress(getSource(), host);
+		header().setControl(HEADER_SIZE + 1 + length + data.length,
+				nextSequenceNumber(), 0);
+		header().setContext(WH_CMD_MULTICAST, qualifier, WH_AQLF_REQUEST);
+		packHeader();
+		Serializer::packi8(payload(), length);
+		Serializer::packib(payload(1), (const unsigned char*) name, length);
+		if (data.base) {
+			Serializer::packib(payload(1 + length), data.base, data.length);
+		}
+		return header().getLength();
+	}
+}
+
+unsigned int Protocol::processNamedResponse(uint8_t qualifier,
+		const char *name) const noexcept {
+	auto length = name ? strlen(name) : 0;
+	if (!length || !validate()) {
+		return 0;
+	} else if (!checkContext(WH_CMD_MULTICAST, qualifier)) {
+		return 0;
+	} else if (header().getLength() >= HEADER_SIZE + 1 + length
+			&& Serializer::unpacku8(payload()) == length
+			&& !memcmp(payload(1), name, length)) {
+		return header().getLength();
+	} else {
+		return 0;
+	}
+}
+
 Message* Protocol::createIdentificationRequest(const MessageAddress &address,
 		const Data &nonce, uint16_t sequenceNumber) noexcept {
 	auto msg = Message::create();
@@ -349,6 +606,25 @@ unsigned int Protocol::processFindRootResponse(const Message *msg,
 	return msg && processFindRootResponse(*msg, identity, root);
 }
 
+bool Protocol::createCapability(uint64_t uid, uint64_t expiry,
+		const char *key, Digest *tag) noexcept {
+	Hash hash;
+	return createCapability(uid, expiry, key, hash, tag);
+}
+
+bool Protocol::createCapability(uint64_t uid, uint64_t expiry,
+		const char *key, Hash &hash, Digest *tag) noexcept {
+	if (!key || !key[0] || !tag) {
+		return false;
+	} else {
+		unsigned char data[2 * sizeof(uint64_t)];
+		Serializer::packi64(data, uid);
+		Serializer::packi64(data + sizeof(uint64_t), expiry);
+		return hash.create(WH_HMAC_SHA512, key, strlen(key), data,
+				sizeof(data), tag);
+	}
+}
+
 //-----------------------------------------------------------------
 
 unsigned int Protocol::createIdentificationRequest(
@@ -493,7 +769,7 @@ unsigned int Protocol::createFindRootRequest(const MessageAddress &address,
 	packet.header().setControl(len, sequenceNumber, 0);
 	packet.header().setContext(WH_CMD_BASIC, WH_QLF_FINDROOT, WH_AQLF_REQUEST);
 	packet.packHeader();
-	Serializer::pack(packet.payload(), "Q", identity);
+	Layout<WireU64>::pack(packet.payload(), identity);
 	return len;
 }
 
@@ -505,7 +781,7 @@ unsigned int Protocol::processFindRootResponse(const Packet &packet,
 		return 0;
 	} else {
 		uint64_t v[2] = { 0, 0 };
-		Serializer::unpack(packet.payload(), "QQ", &v[0], &v[1]);
+		Layout<WireU64, WireU64>::unpack(packet.payload(), v[0], v[1]);
 		if (v[0] == identity) {
 			root = v[1];
 			return packet.header().getLength();
@@ -181,6 +181,30 @@ public:
 	 * @return true on success, false on error (request denied by the host)
 	 */
 	bool bootstrapRequest(uint64_t host, uint64_t keys[], uint32_t &limit);
+	/**
+	 * Creates an authorization request which presents a capability to the
+	 * host. A capability permits the client to communicate with the overlay
+	 * hubs directly (see Protocol::createCapability()).
+	 * @param host recipient's identifier (can be set to zero)
+	 * @param expiry capability's expiration time (seconds since the epoch)
+	 * @param tag capability's authentication code
+	 * @return message length on success, 0 on error (invalid request)
+	 */
+	unsigned int createAuthorizeRequest(uint64_t host, uint64_t expiry,
+			const Digest *tag) noexcept;
+	/**
+	 * Processes the response to an authorization request.
+	 * @return message length on success, 0 if request denied or invalid response
+	 */
+	unsigned int processAuthorizeResponse() const noexcept;
+	/**
+	 * Executes and processes an authorization request.
+	 * @param host recipient's identifier (can be set to zero)
+	 * @param expiry capability's expiration time (seconds since the epoch)
+	 * @param tag capability's authentication code
+	 * @return true on success, false on error (request denied by the host)
+	 */
+	bool authorizeRequest(uint64_t host, uint64_t expiry, const Digest *tag);
 	//-----------------------------------------------------------------
 	/**
 	 * Creates a publish request for writing data to the given topic.
@@ -244,6 +268,151 @@ public:
 	 * @return true on success, false on error (request denied by the host)
 	 */
 	bool unsubscribeRequest(uint64_t host, uint8_t topic);
+
+	/**
+	 * Creates a publish request for writing data to the given topic inside
+	 * the 64-bit topic namespace. The topics [0-255] are reserved for the
+	 * classic requests, the hubs reject them.
+	 * @param host host's identifier (can be set to zero)
+	 * @param topic topic identifier
+	 * @param data data to write on the given topic
+	 * @return message length on success, 0 on error (invalid request)
+	 */
+	unsigned int createExtendedPublishRequest(uint64_t host, uint64_t topic,
+			const Data &data) noexcept;
+	/**
+	 * Executes a publish request inside the 64-bit topic namespace.
+	 * @param host host's identifier (can be set to zero)
+	 * @param topic topic identifier
+	 * @param data data to write on the given topic
+	 * @return true on success, false on error (request denied by the host)
+	 */
+	bool extendedPublishRequest(uint64_t host, uint64_t topic,
+			const Data &data);
+
+	/**
+	 * Creates a subscription request for subscribing to a given topic inside
+	 * the 64-bit topic namespace.
+	 * @param host host's identifier (can be set to zero)
+	 * @param topic topic identifier
+	 * @param filter optional content filter (see WhpFilterField)
+	 * @return message length on success, 0 on error (invalid request)
+	 */
+	unsigned int createExtendedSubscribeRequest(uint64_t host, uint64_t topic,
+			const Data &filter = { nullptr, 0 }) noexcept;
+	/**
+	 * Processes the response to a subscription request inside the 64-bit
+	 * topic namespace.
+	 * @param topic topic identifier (to validate the response)
+	 * @return message length on success, 0 if request denied or invalid response
+	 */
+	unsigned int processExtendedSubscribeResponse(
+			uint64_t topic) const noexcept;
+	/**
+	 * Executes and processes a subscription request inside the 64-bit topic
+	 * namespace.
+	 * @param host host's identifier (can be set to zero)
+	 * @param topic topic identifier
+	 * @param filter optional content filter (see WhpFilterField)
+	 * @return true on success, false on error (request denied by the host)
+	 */
+	bool extendedSubscribeRequest(uint64_t host, uint64_t topic,
+			const Data &filter = { nullptr, 0 });
+
+	/**
+	 * Creates an un-subscription request inside the 64-bit topic namespace.
+	 * @param host host's identifier (can be set to zero)
+	 * @param topic topic identifier
+	 * @return message length on success, 0 on error (invalid request)
+	 */
+	unsigned int createExtendedUnsubscribeRequest(uint64_t host,
+			uint64_t topic) noexcept;
+	/**
+	 * Processes the response to an un-subscription request inside the 64-bit
+	 * topic namespace.
+	 * @param topic topic identifier
+	 * @return message length on success, 0 if request denied or invalid response
+	 */
+	unsigned int processExtendedUnsubscribeResponse(
+			uint64_t topic) const noexcept;
+	/**
+	 * Executes and processes an un-subscription request inside the 64-bit
+	 * topic namespace.
+	 * @param host host's identifier (can be set to zero)
+	 * @param topic topic identifier
+	 * @return true on success, false on error (request denied by the host)
+	 */
+	bool extendedUnsubscribeRequest(uint64_t host, uint64_t topic);
+
+	/**
+	 * Creates a publish request for writing data to a hierarchical topic
+	 * name (levels separated by '/', without the wildcards).
+	 * @param host host's identifier (can be set to zero)
+	 * @param name nul-terminated topic name (at most 255 bytes long)
+	 * @param data data to write on the given topic
+	 * @return message length on success, 0 on error (invalid request)
+	 */
+	unsigned int createNamedPublishRequest(uint64_t host, const char *name,
+			const Data &data) noexcept;
+	/**
+	 * Executes a publish request for a hierarchical topic name.
+	 * @param host host's identifier (can be set to zero)
+	 * @param name nul-terminated topic name (at most 255 bytes long)
+	 * @param data data to write on the given topic
+	 * @return true on success, false on error (request denied by the host)
+	 */
+	bool namedPublishRequest(uint64_t host, const char *name, const Data &data);
+
+	/**
+	 * Creates a subscription request for a hierarchical topic filter. The
+	 * filter can contain the single-level ('+') and the multi-level ('#')
+	 * wildcards, for example "site/+/temperature" and "fleet/42/#".
+	 * @param host host's identifier (can be set to zero)
+	 * @param filter nul-terminated topic filter (at most 255 bytes long)
+	 * @param content optional content filter (see WhpFilterField)
+	 * @return message length on success, 0 on error (invalid request)
+	 */
+	unsigned int createNamedSubscribeRequest(uint64_t host, const char *filter,
+			const Data &content = { nullptr, 0 }) noexcept;
+	/**
+	 * Processes the response to a subscription request for a topic filter.
+	 * @param filter nul-terminated topic filter (to validate the response)
+	 * @return message length on success, 0 if request denied or invalid response
+	 */
+	unsigned int processNamedSubscribeResponse(
+			const char *filter) const noexcept;
+	/**
+	 * Executes and processes a subscription request for a topic filter.
+	 * @param host host's identifier (can be set to zero)
+	 * @param filter nul-terminated topic filter (at most 255 bytes long)
+	 * @param content optional content filter (see WhpFilterField)
+	 * @return true on success, false on error (request denied by the host)
+	 */
+	bool namedSubscribeRequest(uint64_t host, const char *filter,
+			const Data &content = { nullptr, 0 });
+
+	/**
+	 * Creates an un-subscription request for a topic filter.
+	 * @param host host's identifier (can be set to zero)
+	 * @param filter nul-terminated topic filter (at most 255 bytes long)
+	 * @return message length on success, 0 on error (invalid request)
+	 */
+	unsigned int createNamedUnsubscribeRequest(uint64_t host,
+			const char *filter) noexcept;
+	/**
+	 * Processes the response to an un-subscription request for a topic filter.
+	 * @param filter nul-terminated topic filter
+	 * @return message length on success, 0 if request denied or invalid response
+	 */
+	unsigned int processNamedUnsubscribeResponse(
+			const char *filter) const noexcept;
+	/**
+	 * Executes and processes an un-subscription request for a topic filter.
+	 * @param host host's identifier (can be set to zero)
+	 * @param filter nul-terminated topic filter (at most 255 bytes long)
+	 * @return true on success, false on error (request denied by the host)
+	 */
+	bool namedUnsubscribeRequest(uint64_t host, const char *filter);
 	//-----------------------------------------------------------------
 	/**
 	 * Creates message containing an identification request.
@@ -335,8 +504,39 @@ public:
 	 */
 	static unsigned int processFindRootResponse(const Message *msg,
 			uint64_t identity, uint64_t &root) noexcept;
+	//-----------------------------------------------------------------
+	/**
+	 * Creates a capability which permits a client to communicate with the
+	 * overlay hubs directly. The capability is issued by the overlay network's
+	 * operator and verified by the hubs using a shared key.
+	 * @param uid client's identifier
+	 * @param expiry capability's expiration time (seconds since the epoch)
+	 * @param key the shared key (nul-terminated string)
+	 * @param tag object for storing the capability's authentication code
+	 * @return true on success, false on error
+	 */
+	static bool createCapability(uint64_t uid, uint64_t expiry,
+			const char *key, Digest *tag) noexcept;
+	/**
+	 * Creates a capability (see Protocol::createCapability()) reusing the
+	 * given object's keyed state.
+	 * @param uid client's identifier
+	 * @param expiry capability's expiration time (seconds since the epoch)
+	 * @param key the shared key (nul-terminated string)
+	 * @param hash caches the keyed state while the key doesn't change
+	 * @param tag object for storing the capability's authentication code
+	 * @return true on success, false on error
+	 */
+	static bool createCapability(uint64_t uid, uint64_t expiry,
+			const char *key, Hash &hash, Digest *tag) noexcept;
 private:
 	//Returns message length on success, 0 on failure
+	unsigned int createNamedRequest(uint64_t host, uint8_t qualifier,
+			const char *name, const Data &data) noexcept;
+	//Returns message length on success, 0 on failure
+	unsigned int processNamedResponse(uint8_t qualifier,
+			const char *name) const noexcept;
+	//Returns message length on success, 0 on failure
 	static unsigned int createIdentificationRequest(
 			const MessageAddress &address, uint16_t sequenceNumber,
 			const Data &nonce, Packet &packet) noexcept;
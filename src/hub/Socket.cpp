@@ -13,6 +13,7 @@
 #include "Socket.h"
 #include "Hub.h"
 #include "../base/Selector.h"
+#include "../base/ipc/Connector.h"
 #include "../base/ds/Twiddler.h"
 #include "../base/security/CryptoUtils.h"
 #include "../base/unix/SystemException.h"
@@ -48,6 +49,7 @@ Socket::Socket(const NameInfo &ni, bool blocking, int timeout) :
 			setFlags(SOCKET_LOCAL);
 		} else {
 			Descriptor::setHandle(Network::connectedSocket(ni, sa, blocking));
+			setFlags(blocking ? 0 : SOCKET_CONNECTING);
 		}
 		if (blocking) {
 			Network::setSocketTimeout(Descriptor::getHandle(), timeout,
@@ -60,6 +62,19 @@ Socket::Socket(const NameInfo &ni, bool blocking, int timeout) :
 	}
 }
 
+Socket::Socket(const SocketAddress &sa, bool blocking) :
+		Pooled(0) {
+	try {
+		clear();
+		Descriptor::setHandle(Network::connectedSocket(sa, blocking));
+		setFlags(blocking ? 0 : SOCKET_CONNECTING);
+		setType(SOCKET_PROXY);
+	} catch (const BaseException &e) {
+		Descriptor::closeHandle();
+		throw;
+	}
+}
+
 Socket::Socket(const char *service, int backlog, bool isUnix, bool blocking) :
 		Pooled(0) {
 	try {
@@ -158,6 +173,10 @@ unsigned long long Socket::getOption(int name) const noexcept {
 		return READ_BUFFER_SIZE;
 	case WATCHER_WRITE_BUFFER_MAX:
 		return outQueueLimit;
+	case WATCHER_ADDRESS_FAMILY:
+		return Connector::family(Descriptor::getHandle());
+	case WATCHER_PRIVILEGE_EXPIRY:
+		return privilegeExpiry;
 	default:
 		return 0;
 	}
@@ -168,6 +187,9 @@ void Socket::setOption(int name, unsigned long long value) noexcept {
 	case WATCHER_WRITE_BUFFER_MAX:
 		outQueueLimit = Twiddler::min(value, (OUT_QUEUE_SIZE - 1));
 		break;
+	case WATCHER_PRIVILEGE_EXPIRY:
+		privilegeExpiry = value;
+		break;
 	default:
 		break;
 	}
@@ -202,6 +224,14 @@ ssize_t Socket::read() {
 }
 
 ssize_t Socket::write() {
+	if (testFlags(SOCKET_CONNECTING)) {
+		//Non-blocking connection has completed (the socket is writable)
+		if (auto error = Network::socketError(Descriptor::getHandle()); error) {
+			throw SystemException(error);
+		}
+		clearFlags(SOCKET_CONNECTING);
+	}
+
 	if (!sslCtx || testFlags(SOCKET_LOCAL)) {
 		return socketWrite();
 	} else {
@@ -499,6 +529,7 @@ void Socket::clear() noexcept {
 	totalIncomingMessages = 0;
 	totalOutgoingMessages = 0;
 	outQueueLimit = 0;
+	privilegeExpiry = 0;
 	outgoingMessages.rewind();
 }
 
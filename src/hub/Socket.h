@@ -30,7 +30,9 @@ namespace wanhive {
 enum SocketFlag : uint32_t {
 	SOCKET_PRIORITY = 1024, /**< Priority connection */
 	SOCKET_OVERLAY = 2048, /**< Overlay connection */
-	SOCKET_LOCAL = 4096 /**< Unix domain socket connection */
+	SOCKET_LOCAL = 4096, /**< Unix domain socket connection */
+	SOCKET_PRIVILEGED = 8192, /**< Client connection with a capability */
+	SOCKET_CONNECTING = 16384 /**< Non-blocking connection in progress */
 };
 
 /**
@@ -68,6 +70,13 @@ public:
 	 * forever, -1 to ignore (default).
 	 */
 	Socket(const NameInfo &ni, bool blocking = false, int timeout = -1);
+	/**
+	 * Constructor: connects to a resolved address (see Resolver). The outcome
+	 * of a non-blocking connection is checked at the first write.
+	 * @param sa host's socket address
+	 * @param blocking true for blocking IO, false for non-blocking IO (default)
+	 */
+	Socket(const SocketAddress &sa, bool blocking = false);
 	/**
 	 * Constructor: creates a host which can accept incoming connections.
 	 * @param service service's name (usually a port number for TCP/IP socket,
@@ -202,6 +211,8 @@ private:
 	unsigned long long totalOutgoingMessages;
 	//Maximum number of outgoing messages this object is allowed to hold
 	unsigned int outQueueLimit;
+	//Expiration time of the privileges (seconds since the epoch)
+	unsigned long long privilegeExpiry;
 	//Serialized I/P
 	Message *incomingMessage;
 	//This buffer stores the incoming raw bytes
@@ -37,7 +37,9 @@ enum WatcherFlag : uint32_t {
  */
 enum WatcherOption {
 	WATCHER_READ_BUFFER_MAX, /**< Read buffer's maximum size */
-	WATCHER_WRITE_BUFFER_MAX /**< Write buffer's maximum size */
+	WATCHER_WRITE_BUFFER_MAX, /**< Write buffer's maximum size */
+	WATCHER_ADDRESS_FAMILY, /**< Address family of the socket (read only) */
+	WATCHER_PRIVILEGE_EXPIRY /**< Expiration time of the privileges (seconds) */
 };
 //-----------------------------------------------------------------
 //Reactor-specific file handle
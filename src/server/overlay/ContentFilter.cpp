@@ -0,0 +1,162 @@
+/*
+ * ContentFilter.cpp
+ *
+ * Content filters of the subscriptions
+ *
+ *
+ * Copyright (C) 2025 Wanhive Systems Private Limited (info@wanhive.com)
+ * This program is part of the Wanhive IoT Platform.
+ * Check the COPYING file for the license.
+ *
+ */
+
+#include "ContentFilter.h"
+#include "../../base/ds/Serializer.h"
+#include "../../util/commands.h"
+
+namespace wanhive {
+
+ContentFilter::ContentFilter() noexcept :
+		count { 0 } {
+
+}
+
+ContentFilter::~ContentFilter() {
+
+}
+
+bool ContentFilter::compile(const unsigned char *terms,
+		unsigned int length) noexcept {
+	count = 0;
+	if (!terms || !length || (length % TERM_SIZE)
+			|| length > (MAX_TERMS * TERM_SIZE)) {
+		return false;
+	}
+	//-----------------------------------------------------------------
+	//Decode and validate the terms, remember where each group starts
+	unsigned char starts[MAX_TERMS];
+	unsigned int groups = 0;
+	auto separated = true;
+	for (unsigned int i = 0; i < length; i += TERM_SIZE) {
+		auto field = Serializer::unpacku8(terms + i);
+		auto op = Serializer::unpacku8(terms + i + 1);
+		if (op == WH_FLT_OR) {
+			if (separated) { //Empty group
+				count = 0;
+				return false;
+			}
+			separated = true;
+			continue;
+		} else if (field > WH_FLT_I64 || op > WH_FLT_ANY) {
+			count = 0;
+			return false;
+		} else if (separated) {
+			starts[groups++] = count;
+			separated = false;
+		}
+
+		auto &in = code[count++];
+		in.field = field;
+		in.op = op;
+		in.sign = (field == WH_FLT_I32 || field == WH_FLT_I64);
+		in.offset = Serializer::unpacku16(terms + i + 2);
+		in.operand = Serializer::unpacku64(terms + i + 4);
+	}
+
+	if (separated) { //Empty trailing group
+		count = 0;
+		return false;
+	}
+	//-----------------------------------------------------------------
+	//Terms of a group are combined with AND, the groups with OR
+	for (unsigned int g = 0; g < groups; ++g) {
+		auto end = (g + 1 < groups) ? starts[g + 1] : count;
+		auto fail = (g + 1 < groups) ? starts[g + 1] : REJECT;
+		for (unsigned int i = starts[g]; i < end; ++i) {
+			code[i].pass = (i + 1 < end) ? (i + 1) : ACCEPT;
+			code[i].fail = fail;
+		}
+	}
+	return true;
+}
+
+bool ContentFilter::evaluate(const Message *msg,
+		unsigned int offset) const noexcept {
+	unsigned int pc = 0;
+	while (pc < count) {
+		auto &in = code[pc];
+		uint64_t value;
+		if (load(in.field, offset + in.offset, msg, value)
+				&& test(in.op, in.sign, value, in.operand)) {
+			pc = in.pass;
+		} else {
+			pc = in.fail;
+		}
+	}
+	return pc == ACCEPT;
+}
+
+unsigned int ContentFilter::size() const noexcept {
+	return count;
+}
+
+bool ContentFilter::load(unsigned int field, unsigned int index,
+		const Message *msg, uint64_t &value) noexcept {
+	auto length = msg->getPayloadLength();
+	switch (field) {
+	case WH_FLT_SOURCE:
+		value = msg->getSource();
+		return true;
+	case WH_FLT_LENGTH:
+		value = msg->getLength();
+		return true;
+	case WH_FLT_U8:
+		value = msg->getData8(index);
+		return index + sizeof(uint8_t) <= length;
+	case WH_FLT_U16:
+		value = msg->getData16(index);
+		return index + sizeof(uint16_t) <= length;
+	case WH_FLT_U32:
+		value = msg->getData32(index);
+		return index + sizeof(uint32_t) <= length;
+	case WH_FLT_U64:
+		value = msg->getData64(index);
+		return index + sizeof(uint64_t) <= length;
+	case WH_FLT_I32:
+		value = (int64_t) (int32_t) msg->getData32(index);
+		return index + sizeof(uint32_t) <= length;
+	case WH_FLT_I64:
+		value = msg->getData64(index);
+		return index + sizeof(uint64_t) <= length;
+	default:
+		return false;
+	}
+}
+
+bool ContentFilter::test(unsigned int op, bool sign, uint64_t value,
+		uint64_t operand) noexcept {
+	auto x = (int64_t) value;
+	auto y = (int64_t) operand;
+	switch (op) {
+	case WH_FLT_EQ:
+		return value == operand;
+	case WH_FLT_NE:
+		return value != operand;
+	case WH_FLT_LT:
+		return sign ? (x < y) : (value < operand);
+	case WH_FLT_LE:
+		return sign ? (x <= y) : (value <= operand);
+	case WH_FLT_GT:
+		return sign ? (x > y) : (value > operand);
+	case WH_FLT_GE:
+		return sign ? (x >= y) : (value >= operand);
+	case WH_FLT_ALL:
+		return (value & operand) == operand;
+	case WH_FLT_ANY:
+		return (value & operand) != 0;
+	default:
+		return false;
+	}
+}
+
+} /* namespace wanhive */
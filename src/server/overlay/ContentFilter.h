@@ -0,0 +1,88 @@
+/*
+ * ContentFilter.h
+ *
+ * Content filters of the subscriptions
+ *
+ *
+ * Copyright (C) 2025 Wanhive Systems Private Limited (info@wanhive.com)
+ * This program is part of the Wanhive IoT Platform.
+ * Check the COPYING file for the license.
+ *
+ */
+
+#ifndef WH_SERVER_OVERLAY_CONTENTFILTER_H_
+#define WH_SERVER_OVERLAY_CONTENTFILTER_H_
+#include "../../util/Message.h"
+
+namespace wanhive {
+/**
+ * Compiled content filter of a subscription. The filter expression (see
+ * WhpFilterField and WhpFilterOperator) is translated into a short program
+ * with precomputed jumps which is evaluated before a publication is
+ * delivered to the subscriber.
+ */
+class ContentFilter {
+public:
+	/** Size of a term of the filter expression in bytes */
+	static constexpr unsigned int TERM_SIZE = 12;
+	/** Maximum number of terms in a filter expression */
+	static constexpr unsigned int MAX_TERMS = 16;
+	//-----------------------------------------------------------------
+	/**
+	 * Default constructor: creates an empty filter which rejects everything.
+	 */
+	ContentFilter() noexcept;
+	/**
+	 * Destructor
+	 */
+	~ContentFilter();
+	//-----------------------------------------------------------------
+	/**
+	 * Compiles a filter expression, replaces the existing program.
+	 * @param terms filter expression (sequence of the serialized terms)
+	 * @param length expression's length in bytes
+	 * @return true on success, false on error (invalid expression)
+	 */
+	bool compile(const unsigned char *terms, unsigned int length) noexcept;
+	/**
+	 * Evaluates the filter against a publication.
+	 * @param msg the publication
+	 * @param offset data's offset inside the publication's payload
+	 * @return true if the publication passes the filter, false otherwise
+	 */
+	bool evaluate(const Message *msg, unsigned int offset) const noexcept;
+	/**
+	 * Returns the number of instructions of the compiled program.
+	 * @return instructions count
+	 */
+	unsigned int size() const noexcept;
+private:
+	//Reads the tested value
+	static bool load(unsigned int field, unsigned int index, const Message *msg,
+			uint64_t &value) noexcept;
+	//Applies the operator
+	static bool test(unsigned int op, bool sign, uint64_t value,
+			uint64_t operand) noexcept;
+private:
+	//Jump targets which terminate the program
+	static constexpr unsigned char ACCEPT = 0xff;
+	static constexpr unsigned char REJECT = 0xfe;
+
+	struct Instruction {
+		unsigned char field;
+		unsigned char op;
+		bool sign;
+		//Next instruction if the test passes or fails
+		unsigned char pass;
+		unsigned char fail;
+		uint16_t offset;
+		uint64_t operand;
+	};
+
+	unsigned int count;
+	Instruction code[MAX_TERMS];
+};
+
+} /* namespace wanhive */
+
+#endif /* WH_SERVER_OVERLAY_CONTENTFILTER_H_ */
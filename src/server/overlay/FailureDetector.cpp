@@ -0,0 +1,120 @@
+/*
+ * FailureDetector.cpp
+ *
+ * Phi-accrual failure detector
+ *
+ *
+ * Copyright (C) 2025 Wanhive Systems Private Limited (info@wanhive.com)
+ * This program is part of the Wanhive IoT Platform.
+ * Check the COPYING file for the license.
+ *
+ */
+
+#include "FailureDetector.h"
+#include <cmath>
+
+namespace wanhive {
+
+FailureDetector::FailureDetector() noexcept :
+		threshold { 0 }, pause { 0 }, period { 1000 } {
+
+}
+
+FailureDetector::~FailureDetector() {
+
+}
+
+void FailureDetector::setThreshold(double threshold,
+		unsigned int pause) noexcept {
+	this->threshold = threshold > 0 ? threshold : 0;
+	this->pause = pause;
+}
+
+double FailureDetector::getThreshold() const noexcept {
+	return threshold;
+}
+
+void FailureDetector::setPeriod(unsigned int period) noexcept {
+	this->period = period ? period : 1;
+}
+
+void FailureDetector::heartbeat(uint64_t id) noexcept {
+	auto t = now();
+	int ret = 0;
+	auto i = nodes.put(id, ret);
+	if (i == nodes.end()) {
+		return;
+	}
+
+	auto &h = *nodes.getValueReference(i);
+	if (ret) {
+		//One period apart, with a wide distribution
+		h = { t, 0, 1, 0.25, 0 };
+		return;
+	}
+	//-----------------------------------------------------------------
+	auto interval = (t - h.last - h.waited) / period;
+	h.last = t;
+	h.waited = 0;
+	if (h.samples++ == 0) {
+		//Bootstrap the estimates with a wide distribution
+		h.mean = interval;
+		h.variance = (interval * interval) / 4;
+	} else {
+		//mean = 7/8 * mean + 1/8 * sample (same weight for the variance)
+		auto delta = interval - h.mean;
+		h.mean += delta / 8;
+		h.variance = (7 * (h.variance + (delta * delta) / 8)) / 8;
+	}
+}
+
+void FailureDetector::miss(uint64_t id, double wait) noexcept {
+	auto i = nodes.get(id);
+	if (i != nodes.end() && wait > 0) {
+		nodes.getValueReference(i)->waited += wait;
+	}
+}
+
+double FailureDetector::phi(uint64_t id) const noexcept {
+	History h;
+	if (!nodes.hmGet(id, h)) {
+		return MAX_PHI;
+	}
+	//-----------------------------------------------------------------
+	auto elapsed = (now() - h.last - h.waited) / period;
+	auto deviation = sqrt(h.variance);
+	auto floor = MIN_DEVIATION / period;
+	deviation = (deviation < floor) ? floor : deviation;
+	auto mean = h.mean + pause / period;
+	/*
+	 * Logistic approximation of the normal distribution's CDF, accurate to
+	 * within 0.0002 (Bowling et al., 2009).
+	 */
+	auto y = (elapsed - mean) / deviation;
+	auto e = exp(-y * (1.5976 + 0.070566 * y * y));
+	auto p = (elapsed > mean) ? (e / (1 + e)) : (1 - 1 / (1 + e));
+	if (p <= 0) {
+		return MAX_PHI;
+	}
+
+	auto value = -log10(p);
+	return (value < MAX_PHI) ? value : MAX_PHI;
+}
+
+bool FailureDetector::isSuspected(uint64_t id) const noexcept {
+	return threshold == 0 || phi(id) >= threshold;
+}
+
+void FailureDetector::remove(uint64_t id) noexcept {
+	nodes.removeKey(id);
+}
+
+void FailureDetector::clear() noexcept {
+	nodes.clear();
+}
+
+double FailureDetector::now() const noexcept {
+	return clock.elapsed() * Timer::MILS_IN_SEC;
+}
+
+} /* namespace wanhive */
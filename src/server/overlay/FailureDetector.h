@@ -0,0 +1,124 @@
+/*
+ * FailureDetector.h
+ *
+ * Phi-accrual failure detector
+ *
+ *
+ * Copyright (C) 2025 Wanhive Systems Private Limited (info@wanhive.com)
+ * This program is part of the Wanhive IoT Platform.
+ * Check the COPYING file for the license.
+ *
+ */
+
+#ifndef WH_SERVER_OVERLAY_FAILUREDETECTOR_H_
+#define WH_SERVER_OVERLAY_FAILUREDETECTOR_H_
+#include "../../base/Timer.h"
+#include "../../base/ds/Khash.h"
+#include <cstdint>
+
+namespace wanhive {
+/**
+ * Phi-accrual failure detector: tracks the distribution of the heartbeats'
+ * inter-arrival times of each monitored node, and expresses the suspicion
+ * level as phi = -log10(P), where P is the probability that the next
+ * heartbeat arrives later than the time elapsed since the last one.
+ * The inter-arrival times are measured in the units of the probing period,
+ * hence the estimates remain valid when the period changes, and the time
+ * spent waiting for the failed responses is excluded from them.
+ * Ref: "The phi Accrual Failure Detector" (Hayashibara et al., 2004)
+ */
+class FailureDetector {
+public:
+	/** Lower bound of the inter-arrival time's standard deviation (ms) */
+	static constexpr double MIN_DEVIATION = 100;
+	/** Upper bound of the suspicion level */
+	static constexpr double MAX_PHI = 100;
+	//-----------------------------------------------------------------
+	/**
+	 * Default constructor: every missed heartbeat is a failure (see
+	 * FailureDetector::setThreshold()).
+	 */
+	FailureDetector() noexcept;
+	/**
+	 * Destructor
+	 */
+	~FailureDetector();
+	//-----------------------------------------------------------------
+	/**
+	 * Sets the suspicion threshold and the acceptable pause.
+	 * @param threshold suspicion level at which a node is declared failed,
+	 * zero (0) declares a node failed at the first missed heartbeat.
+	 * @param pause additional period in milliseconds by which a heartbeat
+	 * can be late without raising the suspicion.
+	 */
+	void setThreshold(double threshold, unsigned int pause = 0) noexcept;
+	/**
+	 * Returns the suspicion threshold.
+	 * @return suspicion threshold
+	 */
+	double getThreshold() const noexcept;
+	/**
+	 * Sets the current probing period.
+	 * @param period the period in milliseconds
+	 */
+	void setPeriod(unsigned int period) noexcept;
+	//-----------------------------------------------------------------
+	/**
+	 * Records a heartbeat from a node.
+	 * @param id node's identifier
+	 */
+	void heartbeat(uint64_t id) noexcept;
+	/**
+	 * Records a missed heartbeat, the time spent waiting for it doesn't
+	 * count towards the suspicion.
+	 * @param id node's identifier
+	 * @param wait the time in milliseconds spent waiting for the heartbeat
+	 */
+	void miss(uint64_t id, double wait) noexcept;
+	/**
+	 * Returns the current suspicion level of a node. Until the second
+	 * heartbeat the inter-arrival time is assumed to be one period.
+	 * @param id node's identifier
+	 * @return suspicion level, MAX_PHI if no heartbeat was recorded
+	 */
+	double phi(uint64_t id) const noexcept;
+	/**
+	 * Checks whether a node which has missed a heartbeat should be declared
+	 * failed.
+	 * @param id node's identifier
+	 * @return true if the suspicion level has reached the threshold (or the
+	 * threshold is zero), false otherwise.
+	 */
+	bool isSuspected(uint64_t id) const noexcept;
+	/**
+	 * Stops monitoring a node.
+	 * @param id node's identifier
+	 */
+	void remove(uint64_t id) noexcept;
+	/**
+	 * Stops monitoring all the nodes.
+	 */
+	void clear() noexcept;
+private:
+	//Milliseconds elapsed since the detector's creation
+	double now() const noexcept;
+private:
+	//Smoothed estimates of the inter-arrival time's mean and variance
+	struct History {
+		double last;
+		//Time spent waiting for the missed heartbeats since the last one
+		double waited;
+		double mean;
+		double variance;
+		unsigned int samples;
+	};
+	Kmap<uint64_t, History> nodes;
+	Timer clock;
+	double threshold;
+	double pause;
+	double period;
+};
+
+} /* namespace wanhive */
+
+#endif /* WH_SERVER_OVERLAY_FAILUREDETECTOR_H_ */
@@ -0,0 +1,157 @@
+/*
+ * LastValues.cpp
+ *
+ * Retained publications
+ *
+ *
+ * Copyright (C) 2025 Wanhive Systems Private Limited (info@wanhive.com)
+ * This program is part of the Wanhive IoT Platform.
+ * Check the COPYING file for the license.
+ *
+ */
+
+#include "LastValues.h"
+#include "../../base/common/Memory.h"
+
+namespace wanhive {
+
+LastValues::LastValues() noexcept :
+		slots { nullptr }, limit { 0 }, used { 0 }, spare { 0 } {
+
+}
+
+LastValues::~LastValues() {
+	clear();
+	Memory<Slot>::free(slots);
+}
+
+void LastValues::setLimit(unsigned int limit) {
+	clear();
+	Memory<Slot>::resize(slots, limit + 1);
+	this->limit = limit;
+	clear();
+}
+
+unsigned int LastValues::getLimit() const noexcept {
+	return limit;
+}
+
+unsigned int LastValues::count() const noexcept {
+	return used;
+}
+
+size_t LastValues::size() const noexcept {
+	return used * sizeof(Message);
+}
+
+bool LastValues::put(uint64_t topic, uint64_t source, Message *msg) noexcept {
+	if (!limit || !msg) {
+		return false;
+	}
+
+	unsigned int index = 0;
+	if (keys.hmGet( { topic, source }, index)) {
+		//Replace the existing value
+		unlink(index);
+		if (slots[index].msg == msg) {
+			link(index);
+			return true;
+		}
+		Message::recycle(slots[index].msg);
+	} else {
+		if (!spare) {
+			evict();
+		}
+
+		index = spare;
+		spare = slots[index].next;
+		slots[index].key = { topic, source };
+		keys.hmPut( { topic, source }, index);
+		++used;
+	}
+
+	msg->addReferenceCount();
+	slots[index].msg = msg;
+	link(index);
+	return true;
+}
+
+unsigned int LastValues::get(uint64_t topic, Message *values[],
+		unsigned int count) const noexcept {
+	unsigned int index = 0;
+	unsigned int n = 0;
+	topics.hmGet(topic, index);
+	for (; index && n < count; index = slots[index].down) {
+		values[n++] = slots[index].msg;
+	}
+	return n;
+}
+
+void LastValues::clear() noexcept {
+	if (!slots) {
+		return;
+	}
+
+	for (auto i = slots[0].next; used && i; i = slots[i].next) {
+		Message::recycle(slots[i].msg);
+	}
+
+	slots[0] = { { 0, 0 }, nullptr, 0, 0, 0, 0 };
+	spare = 0;
+	for (unsigned int i = limit; i > 0; --i) {
+		slots[i] = { { 0, 0 }, nullptr, 0, spare, 0, 0 };
+		spare = i;
+	}
+	used = 0;
+	keys.clear();
+	topics.clear();
+}
+
+void LastValues::evict() noexcept {
+	auto index = slots[0].prev;
+	unlink(index);
+	keys.removeKey(slots[index].key);
+	Message::recycle(slots[index].msg);
+	slots[index].msg = nullptr;
+	slots[index].next = spare;
+	spare = index;
+	--used;
+}
+
+void LastValues::unlink(unsigned int index) noexcept {
+	auto &s = slots[index];
+	slots[s.prev].next = s.next;
+	slots[s.next].prev = s.prev;
+
+	if (s.up) {
+		slots[s.up].down = s.down;
+	} else if (s.down) {
+		unsigned int tmp;
+		topics.hmReplace(s.key.topic, s.down, tmp);
+	} else {
+		topics.removeKey(s.key.topic);
+	}
+
+	if (s.down) {
+		slots[s.down].up = s.up;
+	}
+	s.prev = s.next = s.up = s.down = 0;
+}
+
+void LastValues::link(unsigned int index) noexcept {
+	auto &s = slots[index];
+	s.prev = 0;
+	s.next = slots[0].next;
+	slots[s.next].prev = index;
+	slots[0].next = index;
+
+	unsigned int head = 0;
+	topics.hmReplace(s.key.topic, index, head);
+	s.up = 0;
+	s.down = head;
+	if (head) {
+		slots[head].up = index;
+	}
+}
+
+} /* namespace wanhive */
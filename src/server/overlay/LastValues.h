@@ -0,0 +1,134 @@
+/*
+ * LastValues.h
+ *
+ * Retained publications
+ *
+ *
+ * Copyright (C) 2025 Wanhive Systems Private Limited (info@wanhive.com)
+ * This program is part of the Wanhive IoT Platform.
+ * Check the COPYING file for the license.
+ *
+ */
+
+#ifndef WH_SERVER_OVERLAY_LASTVALUES_H_
+#define WH_SERVER_OVERLAY_LASTVALUES_H_
+#include "../../base/ds/Khash.h"
+#include "../../base/ds/Twiddler.h"
+#include "../../util/Message.h"
+
+namespace wanhive {
+/**
+ * Bounded store of the most recent publication of each topic (optionally of
+ * each topic and publisher pair). The publications are shared through the
+ * messages' reference counts. The least recently updated value is evicted
+ * when the store is full.
+ */
+class LastValues {
+public:
+	/**
+	 * Default constructor: creates a disabled store (zero capacity).
+	 */
+	LastValues() noexcept;
+	/**
+	 * Destructor
+	 */
+	~LastValues();
+	//-----------------------------------------------------------------
+	/**
+	 * Sets the store's capacity, releases the existing values.
+	 * @param limit maximum number of retained publications (0 to disable)
+	 */
+	void setLimit(unsigned int limit);
+	/**
+	 * Returns the store's capacity.
+	 * @return maximum number of retained publications
+	 */
+	unsigned int getLimit() const noexcept;
+	/**
+	 * Returns the number of retained publications.
+	 * @return retained publications count
+	 */
+	unsigned int count() const noexcept;
+	/**
+	 * Returns the amount of memory held by the retained publications.
+	 * @return memory usage in bytes
+	 */
+	size_t size() const noexcept;
+	//-----------------------------------------------------------------
+	/**
+	 * Retains a publication, replaces the existing value of the given topic
+	 * and source pair.
+	 * @param topic topic's identifier
+	 * @param source publisher's identifier (zero (0) to retain only one value
+	 * per topic)
+	 * @param msg the publication
+	 * @return true on success, false on error (disabled store)
+	 */
+	bool put(uint64_t topic, uint64_t source, Message *msg) noexcept;
+	/**
+	 * Returns the retained values of a topic, the most recent first.
+	 * @param topic topic's identifier
+	 * @param values stores the retained publications
+	 * @param count maximum number of values to return
+	 * @return number of returned values
+	 */
+	unsigned int get(uint64_t topic, Message *values[],
+			unsigned int count) const noexcept;
+	/**
+	 * Releases all the retained publications.
+	 */
+	void clear() noexcept;
+private:
+	//Evicts the least recently updated value
+	void evict() noexcept;
+	//Removes a slot from the recency list and the topic's list
+	void unlink(unsigned int index) noexcept;
+	//Inserts a slot at the head of the recency list and the topic's list
+	void link(unsigned int index) noexcept;
+private:
+	struct Key {
+		uint64_t topic;
+		uint64_t source;
+	};
+
+	struct HFN {
+		unsigned int operator()(const Key &key) const noexcept {
+			return Twiddler::mix((unsigned long long) key.topic)
+					+ Twiddler::mix((unsigned long long) key.source);
+		}
+	};
+
+	struct EQFN {
+		bool operator()(const Key &k1, const Key &k2) const noexcept {
+			return k1.topic == k2.topic && k1.source == k2.source;
+		}
+	};
+
+	/*
+	 * The slot zero (0) is the sentinel of the recency list and terminates
+	 * the topics' lists.
+	 */
+	struct Slot {
+		Key key;
+		Message *msg;
+		//Recency list (circular, the most recent first)
+		unsigned int prev;
+		unsigned int next;
+		//Topic's list
+		unsigned int up;
+		unsigned int down;
+	};
+
+	Slot *slots;
+	unsigned int limit;
+	unsigned int used;
+	//Head of the free slots' list (0 if empty)
+	unsigned int spare;
+	Kmap<Key, unsigned int, HFN, EQFN> keys;
+	//Heads of the topics' lists
+	Kmap<uint64_t, unsigned int> topics;
+};
+
+} /* namespace wanhive */
+
+#endif /* WH_SERVER_OVERLAY_LASTVALUES_H_ */
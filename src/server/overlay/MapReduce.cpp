@@ -0,0 +1,81 @@
+/*
+ * MapReduce.cpp
+ *
+ * Registry of the distributed aggregation functions
+ *
+ *
+ * Copyright (C) 2025 Wanhive Systems Private Limited (info@wanhive.com)
+ * This program is part of the Wanhive IoT Platform.
+ * Check the COPYING file for the license.
+ *
+ */
+
+#include "MapReduce.h"
+
+namespace wanhive {
+
+MapReduce::MapReduce() noexcept {
+	for (auto &f : functions) {
+		f.map = nullptr;
+		f.combine = nullptr;
+	}
+}
+
+MapReduce::~MapReduce() {
+
+}
+
+bool MapReduce::set(unsigned int id, Mapper map, Combiner combine) noexcept {
+	if (id < SIZE && map && combine) {
+		functions[id].map = map;
+		functions[id].combine = combine;
+		return true;
+	} else {
+		return false;
+	}
+}
+
+void MapReduce::remove(unsigned int id) noexcept {
+	if (id < SIZE) {
+		functions[id].map = nullptr;
+		functions[id].combine = nullptr;
+	}
+}
+
+bool MapReduce::contains(unsigned int id) const noexcept {
+	return (id < SIZE) && functions[id].map;
+}
+
+bool MapReduce::map(unsigned int id, void *context, uint64_t arg,
+		uint64_t &result) const noexcept {
+	if (contains(id)) {
+		result = functions[id].map(context, arg);
+		return true;
+	} else {
+		return false;
+	}
+}
+
+bool MapReduce::combine(unsigned int id, uint64_t x, uint64_t y,
+		uint64_t &result) const noexcept {
+	if (contains(id)) {
+		result = functions[id].combine(x, y);
+		return true;
+	} else {
+		return false;
+	}
+}
+
+uint64_t MapReduce::sum(uint64_t x, uint64_t y) noexcept {
+	return x + y;
+}
+
+uint64_t MapReduce::min(uint64_t x, uint64_t y) noexcept {
+	return (x < y) ? x : y;
+}
+
+uint64_t MapReduce::max(uint64_t x, uint64_t y) noexcept {
+	return (x > y) ? x : y;
+}
+
+} /* namespace wanhive */
@@ -0,0 +1,122 @@
+/*
+ * MapReduce.h
+ *
+ * Registry of the distributed aggregation functions
+ *
+ *
+ * Copyright (C) 2025 Wanhive Systems Private Limited (info@wanhive.com)
+ * This program is part of the Wanhive IoT Platform.
+ * Check the COPYING file for the license.
+ *
+ */
+
+#ifndef WH_SERVER_OVERLAY_MAPREDUCE_H_
+#define WH_SERVER_OVERLAY_MAPREDUCE_H_
+#include <cstdint>
+
+namespace wanhive {
+/**
+ * Registry of the map functions and their combiners used by the overlay hubs
+ * for the ring-wide aggregation.
+ */
+class MapReduce {
+public:
+	/**
+	 * Map function: calculates a node's local value.
+	 * @param context additional argument supplied by the caller
+	 * @param arg request's argument
+	 * @return local value
+	 */
+	using Mapper = uint64_t (*)(void *context, uint64_t arg);
+	/**
+	 * Combiner: merges two partial results. Must be commutative and associative
+	 * because the order of partial results is not defined.
+	 * @param x first partial result
+	 * @param y second partial result
+	 * @return merged result
+	 */
+	using Combiner = uint64_t (*)(uint64_t x, uint64_t y);
+	//-----------------------------------------------------------------
+	/**
+	 * Default constructor: creates an empty registry.
+	 */
+	MapReduce() noexcept;
+	/**
+	 * Destructor
+	 */
+	~MapReduce();
+	//-----------------------------------------------------------------
+	/**
+	 * Registers a map function and it's combiner, replaces the existing entry.
+	 * @param id function's identifier (should be less than MapReduce::SIZE)
+	 * @param map map function
+	 * @param combine combiner
+	 * @return true on success, false on error (invalid arguments)
+	 */
+	bool set(unsigned int id, Mapper map, Combiner combine) noexcept;
+	/**
+	 * Removes a registered function.
+	 * @param id function's identifier
+	 */
+	void remove(unsigned int id) noexcept;
+	/**
+	 * Checks whether a function is registered.
+	 * @param id function's identifier
+	 * @return true if the function exists, false otherwise
+	 */
+	bool contains(unsigned int id) const noexcept;
+	/**
+	 * Executes a map function.
+	 * @param id function's identifier
+	 * @param context additional argument for the map function
+	 * @param arg request's argument
+	 * @param result stores the local value
+	 * @return true on success, false if the function doesn't exist
+	 */
+	bool map(unsigned int id, void *context, uint64_t arg,
+			uint64_t &result) const noexcept;
+	/**
+	 * Merges two partial results using a function's combiner.
+	 * @param id function's identifier
+	 * @param x first partial result
+	 * @param y second partial result
+	 * @param result stores the merged result
+	 * @return true on success, false if the function doesn't exist
+	 */
+	bool combine(unsigned int id, uint64_t x, uint64_t y,
+			uint64_t &result) const noexcept;
+	//-----------------------------------------------------------------
+	/**
+	 * Combiner: returns the sum of two values.
+	 * @param x first value
+	 * @param y second value
+	 * @return sum
+	 */
+	static uint64_t sum(uint64_t x, uint64_t y) noexcept;
+	/**
+	 * Combiner: returns the smaller of two values.
+	 * @param x first value
+	 * @param y second value
+	 * @return minimum
+	 */
+	static uint64_t min(uint64_t x, uint64_t y) noexcept;
+	/**
+	 * Combiner: returns the larger of two values.
+	 * @param x first value
+	 * @param y second value
+	 * @return maximum
+	 */
+	static uint64_t max(uint64_t x, uint64_t y) noexcept;
+public:
+	/** Maximum number of registered functions */
+	static constexpr unsigned int SIZE = 32;
+private:
+	struct {
+		Mapper map;
+		Combiner combine;
+	} functions[SIZE];
+};
+
+} /* namespace wanhive */
+
+#endif /* WH_SERVER_OVERLAY_MAPREDUCE_H_ */
@@ -0,0 +1,710 @@
+/*
+ * MessageLog.cpp
+ *
+ * Durable store-and-forward queues
+ *
+ *
+ * Copyright (C) 2025 Wanhive Systems Private Limited (info@wanhive.com)
+ * This program is part of the Wanhive IoT Platform.
+ * Check the COPYING file for the license.
+ *
+ */
+
+#include "MessageLog.h"
+#include "../../base/Storage.h"
+#include "../../base/common/Atomic.h"
+#include "../../base/common/BaseException.h"
+#include "../../base/common/Exception.h"
+#include "../../base/common/Memory.h"
+#include "../../base/ds/Twiddler.h"
+#include "../../base/unix/SystemException.h"
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr uint32_t MAGIC = 0x57484c47; //"WHLG"
+constexpr uint32_t VERSION = 2;
+constexpr unsigned int ALIGNMENT = 8;
+
+unsigned int align(unsigned int size) noexcept {
+	return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+}
+
+uint32_t checksum(const unsigned char *data, unsigned int length) noexcept {
+	return (uint32_t) wanhive::Twiddler::FVN1aHash(data, length);
+}
+
+//Serializes the access to the writer's state
+class Lock {
+public:
+	Lock(pthread_mutex_t &mutex) noexcept :
+			mutex(mutex) {
+		pthread_mutex_lock(&mutex);
+	}
+
+	~Lock() {
+		pthread_mutex_unlock(&mutex);
+	}
+private:
+	pthread_mutex_t &mutex;
+};
+
+}  // namespace
+
+namespace wanhive {
+
+MessageLog::MessageLog() noexcept :
+		nSegments { 0 }, segmentSize { 0 }, active { 0 }, sequence { 0 }, serial {
+				0 }, entries { nullptr }, size { 0 }, limit { 0 }, spare { 0 }, messages {
+				0 }, compaction { 0, MAX_SEGMENTS, 0, 0, false, 0, false }, ttl {
+				0 }, depth { 0 }, quota { 0 } {
+	memset(segments, 0, sizeof(segments));
+	Memory<Entry>::append(entries, size, limit, { 0, 0, 0 }); //Sentinel
+	pthread_mutex_init(&writer.mutex, nullptr);
+	writer.thread = nullptr;
+	writer.running = false;
+	writer.status = 0;
+	writer.requested = 0;
+	writer.completed = 0;
+}
+
+MessageLog::~MessageLog() {
+	close();
+	Memory<Entry>::free(entries);
+	pthread_mutex_destroy(&writer.mutex);
+}
+
+void MessageLog::open(const char *path, unsigned int segmentSize,
+		unsigned int segments) {
+	if (isOpen()) {
+		throw Exception(EX_STATE);
+	} else if (!path || !path[0] || segments < MIN_SEGMENTS
+			|| segments > MAX_SEGMENTS) {
+		throw Exception(EX_ARGUMENT);
+	}
+
+	auto page = (unsigned int) sysconf(_SC_PAGESIZE);
+	segmentSize = segmentSize < MIN_SEGMENT_SIZE ? MIN_SEGMENT_SIZE : segmentSize;
+	segmentSize = ((segmentSize + page - 1) / page) * page;
+
+	try {
+		this->segmentSize = segmentSize;
+		for (unsigned int i = 0; i < segments; ++i) {
+			char name[PATH_MAX];
+			if (snprintf(name, sizeof(name), "%s/%02u.log", path, i)
+					>= (int) sizeof(name)) {
+				throw Exception(EX_ARGUMENT);
+			}
+
+			auto &s = this->segments[i];
+			s.fd = Storage::open(name, O_RDWR | O_CREAT, S_IRUSR | S_IWUSR);
+			++nSegments;
+			if (ftruncate(s.fd, segmentSize) == -1) {
+				throw SystemException();
+			}
+
+			auto p = mmap(nullptr, segmentSize, PROT_READ | PROT_WRITE,
+					MAP_SHARED, s.fd, 0);
+			if (p == MAP_FAILED) {
+				throw SystemException();
+			}
+			s.base = static_cast<unsigned char*>(p);
+		}
+
+		recover();
+		start();
+	} catch (...) {
+		close();
+		throw;
+	}
+}
+
+void MessageLog::close() noexcept {
+	stop();
+	for (unsigned int i = 0; i < nSegments; ++i) {
+		auto &s = segments[i];
+		if (s.base) {
+			msync(s.base, segmentSize, MS_SYNC);
+			munmap(s.base, segmentSize);
+		}
+		Storage::close(s.fd);
+	}
+
+	memset(segments, 0, sizeof(segments));
+	nSegments = 0;
+	segmentSize = 0;
+	active = 0;
+	sequence = 0;
+	serial = 0;
+	limit = 1; //Keep the sentinel
+	spare = 0;
+	queues.clear();
+	messages = 0;
+	sources.clear();
+	compaction = { 0, MAX_SEGMENTS, 0, 0, false, 0, false };
+}
+
+bool MessageLog::isOpen() const noexcept {
+	return nSegments != 0;
+}
+
+void MessageLog::setLimits(unsigned int ttl, unsigned int depth,
+		unsigned int quota) noexcept {
+	this->ttl = ttl;
+	this->depth = depth;
+	this->quota = quota;
+}
+
+bool MessageLog::put(unsigned long long uid, unsigned long long source,
+		const unsigned char *frame, unsigned int length) noexcept {
+	if (!isOpen() || !frame || !length || length > UINT16_MAX
+			|| (depth && count(uid) >= depth)
+			|| (quota && usage(source) >= quota)) {
+		return false;
+	} else {
+		return append(uid, source, ttl ? now() + ttl : 0, frame, length);
+	}
+}
+
+const unsigned char* MessageLog::peek(unsigned long long uid,
+		unsigned int &length) noexcept {
+	auto t = now();
+	unsigned int i;
+	while ((i = queues.get(uid)) != queues.end()) {
+		auto r = record(queues.getValueReference(i)->first);
+		if (r->expiry && r->expiry <= t) {
+			dequeue(uid);
+		} else {
+			length = r->length;
+			return (const unsigned char*) (r + 1);
+		}
+	}
+	return nullptr;
+}
+
+void MessageLog::pop(unsigned long long uid) noexcept {
+	dequeue(uid);
+}
+
+unsigned int MessageLog::count(unsigned long long uid) const noexcept {
+	auto i = queues.get(uid);
+	return (i != queues.end()) ? queues.getValueReference(i)->count : 0;
+}
+
+unsigned int MessageLog::count() const noexcept {
+	return messages;
+}
+
+unsigned int MessageLog::usage(unsigned long long source) const noexcept {
+	auto i = sources.get(source);
+	return (i != sources.end()) ? *sources.getValueReference(i) : 0;
+}
+
+void MessageLog::commit() noexcept {
+	bool modified = false;
+	{
+		Lock lock(writer.mutex);
+		for (unsigned int i = 0; i < nSegments; ++i) {
+			auto &s = segments[i];
+			if (s.dirty < segmentSize) {
+				auto &start = writer.pending[i];
+				start = s.dirty < start ? s.dirty : start;
+				s.dirty = segmentSize;
+				modified = true;
+			}
+		}
+		writer.requested += modified ? 1 : 0;
+	}
+
+	if (modified) {
+		writer.gate.signal();
+	}
+}
+
+void MessageLog::run(void *arg) noexcept {
+	auto page = (unsigned int) sysconf(_SC_PAGESIZE);
+	while (Atomic<bool>::load(&writer.running, MO_ACQUIRE)) {
+		unsigned int pending[MAX_SEGMENTS];
+		unsigned long long requested;
+		{
+			Lock lock(writer.mutex);
+			memcpy(pending, writer.pending, sizeof(pending));
+			for (auto &start : writer.pending) {
+				start = segmentSize;
+			}
+			requested = writer.requested;
+		}
+
+		if (requested == Atomic<unsigned long long>::load(&writer.completed,
+				MO_RELAXED)) {
+			writer.gate.wait(1000);
+			continue;
+		}
+
+		for (unsigned int i = 0; i < nSegments; ++i) {
+			if (pending[i] < segmentSize) {
+				auto start = (pending[i] / page) * page;
+				msync(segments[i].base + start, segmentSize - start, MS_SYNC);
+			}
+		}
+		Atomic<unsigned long long>::store(&writer.completed, requested,
+				MO_RELEASE);
+	}
+}
+
+int MessageLog::getStatus() const noexcept {
+	return writer.status;
+}
+
+void MessageLog::setStatus(int status) noexcept {
+	writer.status = status;
+}
+
+unsigned int MessageLog::compact() noexcept {
+	if (!isOpen()) {
+		return 0;
+	}
+
+	auto expired = expire(COMPACTION_STEPS);
+	if (compaction.victim != MAX_SEGMENTS || schedule()) {
+		relocate(COMPACTION_STEPS);
+	}
+	return expired;
+}
+
+bool MessageLog::append(unsigned long long uid, unsigned long long source,
+		uint64_t expiry, const unsigned char *frame,
+		unsigned int length) noexcept {
+	auto bytes = align(sizeof(Record) + length);
+	if (bytes > (segmentSize - sizeof(Header))) {
+		return false;
+	} else if ((segments[active].offset + bytes) > segmentSize && !rotate()) {
+		return false;
+	}
+
+	auto &s = segments[active];
+	auto r = (Record*) (s.base + s.offset);
+	memcpy(r + 1, frame, length);
+	r->uid = uid;
+	r->source = source;
+	r->expiry = expiry;
+	r->serial = serial++;
+	r->checksum = checksum(frame, length);
+	r->length = length;
+	r->reserved = 0;
+	r->live = 1; //Validates the record
+
+	s.dirty = s.offset < s.dirty ? s.offset : s.dirty;
+	s.live += 1;
+	s.bytes += bytes;
+	enqueue(uid, active, s.offset);
+	charge(source, true);
+	s.offset += bytes;
+	return true;
+}
+
+bool MessageLog::rotate() noexcept {
+	unsigned int next = nSegments;
+	unsigned int free = 0;
+	for (unsigned int i = 0; i < nSegments; ++i) {
+		if (isFree(i)) {
+			next = (next == nSegments) ? i : next;
+			++free;
+		}
+	}
+	//-----------------------------------------------------------------
+	//The reserve is in use while a relocation is running, it's victim
+	//becomes the reserve once all of it's records have been moved.
+	auto reserve = (compaction.victim == MAX_SEGMENTS) ? 1U : 0U;
+	if (free > reserve) {
+		reset(next, ++sequence);
+		active = next;
+		return true;
+	} else {
+		compaction.stalled = true;
+		return false;
+	}
+}
+
+bool MessageLog::isFree(unsigned int segment) const noexcept {
+	if (segment == active || segments[segment].live) {
+		return false;
+	} else if (compaction.victim == MAX_SEGMENTS) {
+		return true;
+	} else {
+		return segment != compaction.victim && segment != compaction.target;
+	}
+}
+
+unsigned int MessageLog::expire(unsigned int steps) noexcept {
+	//The queues are ordered by arrival, the expired records are at the front
+	auto before = messages;
+	auto t = now();
+	for (; steps && queues.size(); --steps) {
+		if (compaction.cursor >= queues.end()) {
+			compaction.cursor = queues.begin();
+		}
+
+		auto i = compaction.cursor++;
+		unsigned long long uid;
+		if (!queues.getKey(i, uid)) {
+			continue;
+		}
+
+		Record *r;
+		while (queues.exists(i)
+				&& (r = record(queues.getValueReference(i)->first))->expiry
+				&& r->expiry <= t) {
+			dequeue(uid);
+		}
+	}
+	return before - messages;
+}
+
+bool MessageLog::schedule() noexcept {
+	unsigned int target = 0;
+	while (target < nSegments && !isFree(target)) {
+		++target;
+	}
+
+	if (target == nSegments) {
+		return false;
+	}
+	//-----------------------------------------------------------------
+	//Pick the sparsest segment, if the log has run out of free segments
+	//then even the active one is eligible.
+	auto capacity = segmentSize - sizeof(Header);
+	unsigned int victim = nSegments;
+	for (unsigned int i = 0; i < nSegments; ++i) {
+		auto &s = segments[i];
+		if (!s.live || s.bytes >= capacity) {
+			continue;
+		} else if (!compaction.stalled
+				&& (i == active || (s.bytes * 4) > capacity)) {
+			continue;
+		} else if (victim == nSegments || s.bytes < segments[victim].bytes) {
+			victim = i;
+		}
+	}
+
+	if (victim == nSegments) {
+		return false;
+	}
+
+	reset(target, ++sequence);
+	compaction.victim = victim;
+	compaction.target = target;
+	compaction.offset = sizeof(Header);
+	compaction.copied = false;
+	compaction.stalled = false;
+	return true;
+}
+
+void MessageLog::relocate(unsigned int steps) noexcept {
+	auto &source = segments[compaction.victim];
+	auto &target = segments[compaction.target];
+	for (; steps && compaction.offset < source.offset; --steps) {
+		auto offset = compaction.offset;
+		auto r = (Record*) (source.base + offset);
+		auto bytes = align(sizeof(Record) + r->length);
+		compaction.offset += bytes;
+		if (!r->live) {
+			continue;
+		}
+
+		auto e = find(r->uid, compaction.victim, offset);
+		if (!e || (target.offset + bytes) > segmentSize) {
+			//Inconsistent state, abandon the relocation
+			compaction.offset = source.offset;
+			break;
+		}
+
+		memcpy(target.base + target.offset, r, bytes);
+		target.dirty =
+				target.offset < target.dirty ? target.offset : target.dirty;
+		target.live += 1;
+		target.bytes += bytes;
+
+		//The original stays valid until the victim gets reset
+		source.live -= 1;
+		source.bytes -= bytes;
+
+		entries[e].segment = compaction.target;
+		entries[e].offset = target.offset;
+		target.offset += bytes;
+	}
+
+	if (compaction.offset < source.offset) {
+		return;
+	}
+	//-----------------------------------------------------------------
+	//Append to the segment with more room
+	if (!compaction.copied) {
+		if (compaction.victim == active
+				|| target.offset < segments[active].offset) {
+			active = compaction.target;
+		}
+		commit();
+		compaction.copied = true;
+		compaction.barrier = writer.requested;
+	}
+	//-----------------------------------------------------------------
+	//The victim becomes the reserve once the copies are on the disk
+	if (Atomic<unsigned long long>::load(&writer.completed, MO_ACQUIRE)
+			>= compaction.barrier) {
+		if (!source.live) {
+			reset(compaction.victim, source.sequence);
+		}
+		compaction.victim = MAX_SEGMENTS;
+	}
+}
+
+unsigned int MessageLog::find(unsigned long long uid, unsigned int segment,
+		unsigned int offset) const noexcept {
+	auto i = queues.get(uid);
+	if (i == queues.end()) {
+		return 0;
+	}
+
+	//The relocated records are old, usually found near the head
+	for (auto e = queues.getValueReference(i)->first; e; e = entries[e].next) {
+		if (entries[e].segment == segment && entries[e].offset == offset) {
+			return e;
+		}
+	}
+	return 0;
+}
+
+void MessageLog::recover() noexcept {
+	for (unsigned int i = 0; i < nSegments; ++i) {
+		auto &s = segments[i];
+		auto h = (const Header*) s.base;
+		if (h->magic == MAGIC && h->version == VERSION) {
+			s.sequence = h->sequence;
+		} else {
+			//Zero-out the damaged segment, a new one is already empty
+			s.offset = h->magic ? segmentSize : 0;
+			reset(i, 0);
+		}
+	}
+	//-----------------------------------------------------------------
+	//Visit the segments in the order of their creation
+	bool visited[MAX_SEGMENTS] = { };
+	for (unsigned int n = 0; n < nSegments; ++n) {
+		unsigned int next = nSegments;
+		for (unsigned int i = 0; i < nSegments; ++i) {
+			if (!visited[i]
+					&& (next == nSegments
+							|| segments[i].sequence < segments[next].sequence)) {
+				next = i;
+			}
+		}
+
+		visited[next] = true;
+		scan(next);
+		if (segments[next].sequence >= sequence) {
+			sequence = segments[next].sequence;
+			active = next;
+		}
+	}
+}
+
+void MessageLog::scan(unsigned int segment) noexcept {
+	auto &s = segments[segment];
+	s.offset = sizeof(Header);
+	s.dirty = segmentSize;
+	s.live = 0;
+	s.bytes = 0;
+
+	auto t = now();
+	while ((s.offset + sizeof(Record)) <= segmentSize) {
+		auto r = (Record*) (s.base + s.offset);
+		auto bytes = align(sizeof(Record) + r->length);
+		if (!r->length || (s.offset + bytes) > segmentSize
+				|| r->checksum
+						!= checksum((const unsigned char*) (r + 1), r->length)) {
+			//End of the log or an incomplete write
+			break;
+		}
+
+		if (r->live && r->expiry && r->expiry <= t) {
+			r->live = 0;
+			s.dirty = s.offset < s.dirty ? s.offset : s.dirty;
+		} else if (r->live && enqueue(r->uid, segment, s.offset)) {
+			s.live += 1;
+			s.bytes += bytes;
+			charge(r->source, true);
+			serial = r->serial >= serial ? r->serial + 1 : serial;
+		} else if (r->live) {
+			//Copy left behind by an interrupted relocation
+			r->live = 0;
+			s.dirty = s.offset < s.dirty ? s.offset : s.dirty;
+		}
+		s.offset += bytes;
+	}
+}
+
+void MessageLog::reset(unsigned int segment, uint64_t sequence) noexcept {
+	auto &s = segments[segment];
+	//Zero-out the previously used region
+	auto used = s.offset > segmentSize ? segmentSize : s.offset;
+	if (used > sizeof(Header)) {
+		memset(s.base + sizeof(Header), 0, used - sizeof(Header));
+	}
+
+	auto h = (Header*) s.base;
+	h->magic = MAGIC;
+	h->version = VERSION;
+	h->sequence = sequence;
+
+	s.offset = sizeof(Header);
+	s.dirty = 0;
+	s.live = 0;
+	s.bytes = 0;
+	s.sequence = sequence;
+}
+
+void MessageLog::discard(unsigned int entry) noexcept {
+	auto &e = entries[entry];
+	auto &s = segments[e.segment];
+	auto r = record(entry);
+	r->live = 0;
+	s.dirty = e.offset < s.dirty ? e.offset : s.dirty;
+	s.live -= 1;
+	s.bytes -= align(sizeof(Record) + r->length);
+	charge(r->source, false);
+}
+
+void MessageLog::charge(unsigned long long source, bool add) noexcept {
+	int ret;
+	auto i = add ? sources.put(source, ret) : sources.get(source);
+	if (i == sources.end()) {
+		return;
+	}
+
+	auto n = sources.getValueReference(i);
+	if (add) {
+		*n = ret ? 1 : (*n + 1);
+	} else if (!(--(*n))) {
+		sources.remove(i, false); //Iterators remain valid
+	}
+}
+
+bool MessageLog::enqueue(unsigned long long uid, unsigned int segment,
+		unsigned int offset) noexcept {
+	int ret;
+	auto i = queues.put(uid, ret);
+	auto q = queues.getValueReference(i);
+	auto order = ((const Record*) (segments[segment].base + offset))->serial;
+	//The new entry's predecessor (0 if it becomes the head)
+	unsigned int p = 0;
+	if (ret) {
+		//New queue
+	} else if (record(q->last)->serial < order) {
+		//Common case
+		p = q->last;
+	} else if (order < record(q->first)->serial) {
+		p = 0;
+	} else if (record(q->first)->serial == order) {
+		return false;
+	} else {
+		//Relocated record found during recovery
+		p = q->first;
+		while (record(entries[p].next)->serial < order) {
+			p = entries[p].next;
+		}
+
+		if (record(entries[p].next)->serial == order) {
+			return false;
+		}
+	}
+	//-----------------------------------------------------------------
+	unsigned int id;
+	Entry entry { segment, offset, 0 };
+	if ((id = spare)) {
+		spare = entries[id].next;
+		entries[id] = entry;
+	} else {
+		id = limit;
+		Memory<Entry>::append(entries, size, limit, entry);
+	}
+	++messages;
+
+	if (ret) {
+		*q = { id, id, 1 };
+	} else if (p) {
+		q->count += 1;
+		entries[id].next = entries[p].next;
+		entries[p].next = id;
+		q->last = (p == q->last) ? id : q->last;
+	} else {
+		q->count += 1;
+		entries[id].next = q->first;
+		q->first = id;
+	}
+	return true;
+}
+
+MessageLog::Record* MessageLog::record(unsigned int entry) const noexcept {
+	return (Record*) (segments[entries[entry].segment].base
+			+ entries[entry].offset);
+}
+
+void MessageLog::dequeue(unsigned long long uid) noexcept {
+	auto i = queues.get(uid);
+	if (i == queues.end()) {
+		return;
+	}
+
+	auto q = queues.getValueReference(i);
+	auto id = q->first;
+	discard(id);
+	q->first = entries[id].next;
+	entries[id].next = spare;
+	spare = id;
+	--messages;
+
+	if (!(--q->count)) {
+		queues.remove(i, false); //Iterators remain valid
+	}
+}
+
+void MessageLog::start() {
+	for (auto &start : writer.pending) {
+		start = segmentSize;
+	}
+	writer.requested = 0;
+	writer.completed = 0;
+	Atomic<bool>::store(&writer.running, true, MO_RELEASE);
+	try {
+		writer.thread = new Thread(*this);
+	} catch (...) {
+		Atomic<bool>::store(&writer.running, false, MO_RELEASE);
+		throw;
+	}
+}
+
+void MessageLog::stop() noexcept {
+	if (writer.thread) {
+		Atomic<bool>::store(&writer.running, false, MO_RELEASE);
+		writer.gate.signal();
+		try {
+			writer.thread->join();
+		} catch (const BaseException &e) {
+			//Nothing to do
+		}
+		delete writer.thread;
+		writer.thread = nullptr;
+	}
+}
+
+uint64_t MessageLog::now() noexcept {
+	return (uint64_t) time(nullptr);
+}
+
+} /* namespace wanhive */
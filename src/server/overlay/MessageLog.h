@@ -0,0 +1,293 @@
+/*
+ * MessageLog.h
+ *
+ * Durable store-and-forward queues
+ *
+ *
+ * Copyright (C) 2025 Wanhive Systems Private Limited (info@wanhive.com)
+ * This program is part of the Wanhive IoT Platform.
+ * Check the COPYING file for the license.
+ *
+ */
+
+#ifndef WH_SERVER_OVERLAY_MESSAGELOG_H_
+#define WH_SERVER_OVERLAY_MESSAGELOG_H_
+#include "../../base/Thread.h"
+#include "../../base/TurnGate.h"
+#include "../../base/common/NonCopyable.h"
+#include "../../base/common/Task.h"
+#include "../../base/ds/Khash.h"
+#include <cstdint>
+#include <pthread.h>
+
+namespace wanhive {
+/**
+ * Durable per-destination message queues stored inside an append-only log of
+ * fixed-size memory-mapped segments. An in-memory index links the records of
+ * each destination in their arrival order, it is rebuilt from the segments on
+ * restart. The consumed and expired records are marked in place, a segment
+ * is reused after all of it's records have been consumed. One free segment
+ * is always kept in reserve, compaction moves the remaining records of a
+ * sparse segment into it a few at a time. A dedicated thread writes back the
+ * committed updates, the caller never waits for the disk.
+ */
+class MessageLog: public Task, private NonCopyable {
+public:
+	/** Minimum number of segments (one of them is kept in reserve) */
+	static constexpr unsigned int MIN_SEGMENTS = 2;
+	/** Maximum number of segments */
+	static constexpr unsigned int MAX_SEGMENTS = 64;
+	/** Minimum size of a segment in bytes */
+	static constexpr unsigned int MIN_SEGMENT_SIZE = 65536;
+	/** Maximum number of queues and records visited by a compaction step */
+	static constexpr unsigned int COMPACTION_STEPS = 256;
+	//-----------------------------------------------------------------
+	/**
+	 * Default constructor: creates a closed log.
+	 */
+	MessageLog() noexcept;
+	/**
+	 * Destructor: closes the log.
+	 */
+	~MessageLog();
+	//-----------------------------------------------------------------
+	/**
+	 * Opens the log, creates the segment files if they don't exist, recovers
+	 * the stored messages and starts the writer thread.
+	 * @param path the directory containing the segment files
+	 * @param segmentSize size of each segment in bytes (rounded up to the
+	 * page size and bounded below by MIN_SEGMENT_SIZE).
+	 * @param segments number of segments (MIN_SEGMENTS to MAX_SEGMENTS)
+	 */
+	void open(const char *path, unsigned int segmentSize,
+			unsigned int segments);
+	/**
+	 * Stops the writer thread, writes back the pending updates and closes the
+	 * log.
+	 */
+	void close() noexcept;
+	/**
+	 * Checks whether the log is open.
+	 * @return true if the log is open, false otherwise
+	 */
+	bool isOpen() const noexcept;
+	/**
+	 * Sets the retention limits.
+	 * @param ttl lifetime of a stored message in seconds (0 for no limit)
+	 * @param depth maximum number of messages stored for a destination (0 for
+	 * no limit).
+	 * @param quota maximum number of messages stored on behalf of a source (0
+	 * for no limit).
+	 */
+	void setLimits(unsigned int ttl, unsigned int depth,
+			unsigned int quota = 0) noexcept;
+	//-----------------------------------------------------------------
+	/**
+	 * Appends a message to a destination's queue.
+	 * @param uid destination's identifier
+	 * @param source message's source identifier (subject to the quota)
+	 * @param frame the serialized message
+	 * @param length message's length in bytes
+	 * @return true on success, false on error (queue or log is full, or the
+	 * source has exhausted it's quota).
+	 */
+	bool put(unsigned long long uid, unsigned long long source,
+			const unsigned char *frame, unsigned int length) noexcept;
+	/**
+	 * Returns the oldest unexpired message of a destination's queue, the
+	 * expired messages are discarded.
+	 * @param uid destination's identifier
+	 * @param length stores the message's length in bytes
+	 * @return the serialized message, nullptr if the queue is empty. The
+	 * pointer remains valid until the log is modified.
+	 */
+	const unsigned char* peek(unsigned long long uid,
+			unsigned int &length) noexcept;
+	/**
+	 * Removes the oldest message from a destination's queue.
+	 * @param uid destination's identifier
+	 */
+	void pop(unsigned long long uid) noexcept;
+	/**
+	 * Returns the number of messages stored for a destination.
+	 * @param uid destination's identifier
+	 * @return messages count
+	 */
+	unsigned int count(unsigned long long uid) const noexcept;
+	/**
+	 * Returns the total number of stored messages.
+	 * @return messages count
+	 */
+	unsigned int count() const noexcept;
+	/**
+	 * Returns the number of messages stored on behalf of a source.
+	 * @param source source's identifier
+	 * @return messages count
+	 */
+	unsigned int usage(unsigned long long source) const noexcept;
+	//-----------------------------------------------------------------
+	/**
+	 * Hands over the updates made since the last commit to the writer thread
+	 * which writes them back synchronously (group commit). The messages stored
+	 * after the last completed write-back can be lost on a system crash.
+	 */
+	void commit() noexcept;
+	/**
+	 * Performs a bounded step of compaction: discards the expired messages
+	 * and moves the records of a sparse segment into the reserved one, at
+	 * most COMPACTION_STEPS queues and records are visited per call. The
+	 * relocated records are released after their copies have been written
+	 * back.
+	 * @return number of discarded messages
+	 */
+	unsigned int compact() noexcept;
+	//-----------------------------------------------------------------
+	void run(void *arg) noexcept override;
+	int getStatus() const noexcept override;
+	void setStatus(int status) noexcept override;
+private:
+	//Persistent record's header
+	struct Record {
+		uint64_t uid;
+		uint64_t source;
+		uint64_t expiry;
+		uint64_t serial;
+		uint32_t checksum;
+		uint16_t length;
+		uint8_t live;
+		uint8_t reserved;
+	};
+
+	//Persistent segment's header
+	struct Header {
+		uint32_t magic;
+		uint32_t version;
+		uint64_t sequence;
+	};
+	//-----------------------------------------------------------------
+	//Appends a record to the active segment
+	bool append(unsigned long long uid, unsigned long long source,
+			uint64_t expiry, const unsigned char *frame,
+			unsigned int length) noexcept;
+	//Activates a free segment, the last free segment is held in reserve
+	bool rotate() noexcept;
+	//Checks whether a segment has no live records and can be reset
+	bool isFree(unsigned int segment) const noexcept;
+	//Discards the expired records of at most <steps> queues
+	unsigned int expire(unsigned int steps) noexcept;
+	//Selects a sparse segment for relocation into the reserved segment
+	bool schedule() noexcept;
+	//Moves at most <steps> records of the scheduled segment
+	void relocate(unsigned int steps) noexcept;
+	//Returns the entry of a record in the destination's queue, 0 if none
+	unsigned int find(unsigned long long uid, unsigned int segment,
+			unsigned int offset) const noexcept;
+	//Rebuilds the index from the segments
+	void recover() noexcept;
+	//Validates and indexes the records of a segment
+	void scan(unsigned int segment) noexcept;
+	//Resets a segment
+	void reset(unsigned int segment, uint64_t sequence) noexcept;
+	//Marks a record as consumed
+	void discard(unsigned int entry) noexcept;
+	//Updates the number of messages stored on behalf of a source
+	void charge(unsigned long long source, bool add) noexcept;
+	//Adds a record to a destination's queue in the order of serial numbers,
+	//returns false if the queue already contains the record's serial number.
+	bool enqueue(unsigned long long uid, unsigned int segment,
+			unsigned int offset) noexcept;
+	//Returns the record associated with an entry
+	Record* record(unsigned int entry) const noexcept;
+	//Removes the head of a destination's queue
+	void dequeue(unsigned long long uid) noexcept;
+	//Starts the writer thread
+	void start();
+	//Stops the writer thread
+	void stop() noexcept;
+	//Current time in seconds
+	static uint64_t now() noexcept;
+private:
+	struct Segment {
+		int fd;
+		unsigned char *base;
+		//Offset of the next record
+		unsigned int offset;
+		//Start of the modifications since the last commit
+		unsigned int dirty;
+		//Number and size of the records which haven't been consumed
+		unsigned int live;
+		unsigned int bytes;
+		uint64_t sequence;
+	};
+
+	//Location of a stored record
+	struct Entry {
+		unsigned int segment;
+		unsigned int offset;
+		//Next record of the destination (or next recycled entry)
+		unsigned int next;
+	};
+
+	struct Queue {
+		unsigned int first;
+		unsigned int last;
+		unsigned int count;
+	};
+
+	Segment segments[MAX_SEGMENTS];
+	unsigned int nSegments;
+	unsigned int segmentSize;
+	unsigned int active;
+	uint64_t sequence;
+	//Preserves the arrival order across relocation and recovery
+	uint64_t serial;
+	//-----------------------------------------------------------------
+	Entry *entries;
+	unsigned int size;
+	unsigned int limit;
+	//Head of the recycled entries' list (0 if empty)
+	unsigned int spare;
+	Kmap<unsigned long long, Queue> queues;
+	unsigned int messages;
+	//Number of messages stored on behalf of each source
+	Kmap<unsigned long long, unsigned int> sources;
+	//-----------------------------------------------------------------
+	//Incremental compaction
+	struct {
+		//Next queue to check for expiry
+		unsigned int cursor;
+		//Segment being relocated into <target> (MAX_SEGMENTS if none)
+		unsigned int victim;
+		unsigned int target;
+		//Next record of <victim> to relocate
+		unsigned int offset;
+		//The records have been copied, waiting for the write-back
+		bool copied;
+		//The commit which writes back the copies
+		unsigned long long barrier;
+		//An append has failed for the lack of a free segment
+		bool stalled;
+	} compaction;
+	//-----------------------------------------------------------------
+	//Group commit
+	struct {
+		pthread_mutex_t mutex;
+		TurnGate gate;
+		Thread *thread;
+		bool running;
+		int status;
+		//Start of the committed region of each segment yet to be written
+		unsigned int pending[MAX_SEGMENTS];
+		//Number of commits handed over and written back
+		unsigned long long requested;
+		unsigned long long completed;
+	} writer;
+	//-----------------------------------------------------------------
+	unsigned int ttl;
+	unsigned int depth;
+	unsigned int quota;
+};
+
+} /* namespace wanhive */
+
+#endif /* WH_SERVER_OVERLAY_MESSAGELOG_H_ */
@@ -19,7 +19,7 @@
 namespace wanhive {
 
 Node::Node(unsigned int key) :
-		_key(key) {
+		_key(key), stable(false), version(0) {
 	if (key <= MAX_ID) {
 		initialize();
 	} else {
@@ -86,6 +86,7 @@ bool Node::isConnected(unsigned int index) const noexcept {
 void Node::setConnected(unsigned int index, bool status) noexcept {
 	if (index < TABLESIZE) {
 		table[index].setConnected(status);
+		nextVersion();
 	}
 }
 
@@ -121,6 +122,10 @@ void Node::setStable(bool stable) noexcept {
 	this->stable = stable;
 }
 
+unsigned int Node::getVersion() const noexcept {
+	return version;
+}
+
 bool Node::isLocal(unsigned int key) const noexcept {
 	//(key) E (predecessor, serverId]
 	return (isBetween(key, getPredecessor(), getKey()) || (key == getKey()));
@@ -191,6 +196,10 @@ bool Node::update(unsigned int key, bool joined) noexcept {
 			found = true;
 		}
 	}
+
+	if (found) {
+		nextVersion();
+	}
 	return found;
 }
 
@@ -250,6 +259,14 @@ void Node::initialize() noexcept {
 		table[i].setConnected(false);
 	}
 	setStable(true);
+	nextVersion();
+}
+
+void Node::nextVersion() noexcept {
+	//Zero (0) is reserved for the invalid entries
+	if (++version == 0) {
+		version = 1;
+	}
 }
 
 bool Node::setFinger(Finger &f, unsigned int key, bool checkConsistent,
@@ -258,6 +275,10 @@ bool Node::setFinger(Finger &f, unsigned int key, bool checkConsistent,
 		auto old = f.getId();
 		f.setId(key);
 
+		if (old != f.getId()) {
+			nextVersion();
+		}
+
 		if (key && ((checkConnected && !f.isConnected()) || old != f.getId())) {
 			setStable(false);
 		}
@@ -123,6 +123,13 @@ public:
 	 * @param stable true for stable, false for not-stable
 	 */
 	void setStable(bool stable) noexcept;
+	/**
+	 * Returns the routing table's version number which changes on every update
+	 * of the predecessor, the finger table entries, or their "connected" status.
+	 * Routing decisions cached under an older version number are stale.
+	 * @return routing table's version number (never zero)
+	 */
+	unsigned int getVersion() const noexcept;
 	//-----------------------------------------------------------------
 	/**
 	 * Recursive routing: checks whether this node the given key's root.
@@ -232,6 +239,7 @@ public:
 			unsigned int index) noexcept;
 private:
 	void initialize() noexcept;
+	void nextVersion() noexcept;
 	bool setFinger(Finger &f, unsigned int key, bool checkConsistent = true,
 			bool checkConnected = true) noexcept;
 public:
@@ -252,6 +260,7 @@ private:
 	Finger _predecessor;
 	Finger table[TABLESIZE];
 	bool stable;
+	unsigned int version;
 };
 
 } /* namespace wanhive */
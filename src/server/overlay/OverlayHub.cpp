@@ -13,7 +13,11 @@
 #include "OverlayHub.h"
 #include "commands.h"
 #include "../../base/common/Logger.h"
+#include "../../hub/Protocol.h"
 #include <cinttypes>
+#include <ctime>
+#include <new>
+#include <strings.h>
 
 namespace {
 /**
@@ -45,6 +49,32 @@ enum MessageTrace : uint32_t {
  */
 constexpr unsigned long long DEF_TOKENS_COUNT = 200;
 
+/**
+ * Payloads of the map (ring-wide aggregation) request and response
+ */
+using MapRequest = wanhive::OverlayProtocol::MapRequest;
+using MapResult = wanhive::OverlayProtocol::MapResult;
+constexpr unsigned int MAP_REQUEST_BYTES = MapRequest::SIZE;
+constexpr unsigned int MAP_RESPONSE_BYTES = MapResult::SIZE;
+//The response carries the request's function and tag at the same offsets
+static_assert(MapRequest::offset<2>() == MapResult::offset<3>()
+		&& MapRequest::offset<3>() == MapResult::offset<4>(),
+		"Invalid map payloads");
+//Subscriptions summary: [limit(8) | summary] bytes
+constexpr unsigned int SUMMARY_HEADER_BYTES = 8;
+static_assert(SUMMARY_HEADER_BYTES + wanhive::TopicSummary::MAX_SIZE
+		<= wanhive::Message::PAYLOAD_SIZE, "Invalid summary size");
+//Forwarded publication: [limit(8) | group(4) | publication] bytes
+constexpr unsigned int MULTICAST_HEADER_BYTES = 12;
+//Summaries are refreshed after these many advertisement intervals
+constexpr unsigned int SUMMARY_REFRESH = 30;
+//Summaries expire after these many refresh periods
+constexpr unsigned int SUMMARY_EXPIRY = 3;
+//Summaries carry this topic if the hub has the topic filters
+constexpr uint64_t FILTERS_TOPIC = UINT64_MAX;
+//Retained publications can pin at most 1/RETAINED_SHARE of the message pool
+constexpr unsigned int RETAINED_SHARE = 4;
+
 //-----------------------------------------------------------------
 }// namespace
 
@@ -53,6 +83,7 @@ namespace wanhive {
 OverlayHub::OverlayHub(unsigned long long uid, const char *path) :
 		Hub(uid, path), Node(uid), stabilizer(uid) {
 	clear();
+	installMapFunctions();
 }
 
 OverlayHub::~OverlayHub() {
@@ -73,9 +104,53 @@ void OverlayHub::configure(void *arg) {
 		ctx.authenticateClient = conf.getBoolean("OVERLAY",
 				"authenticateClient");
 		ctx.connectToOverlay = conf.getBoolean("OVERLAY", "connectToOverlay");
+		ctx.oneHop = conf.getBoolean("OVERLAY", "oneHop");
 		ctx.updateCycle = conf.getNumber("OVERLAY", "updateCycle", 5000);
+		ctx.minUpdateCycle = conf.getNumber("OVERLAY", "minUpdateCycle",
+				ctx.updateCycle / 4);
+		ctx.maxUpdateCycle = conf.getNumber("OVERLAY", "maxUpdateCycle",
+				ctx.updateCycle * 4);
 		ctx.requestTimeout = conf.getNumber("OVERLAY", "timeOut", 5000);
 		ctx.retryInterval = conf.getNumber("OVERLAY", "retryInterval", 10000);
+		ctx.fingerCandidates = conf.getNumber("OVERLAY", "fingerCandidates",
+				4);
+		ctx.suspicionThreshold = conf.getDouble("OVERLAY",
+				"suspicionThreshold", 8);
+		ctx.acceptablePause = conf.getNumber("OVERLAY", "acceptablePause");
+		ctx.batchFrameSize = Twiddler::min(
+				conf.getNumber("OVERLAY", "batchFrameSize"),
+				Message::PAYLOAD_SIZE / 2);
+		ctx.batchDelay = conf.getNumber("OVERLAY", "batchDelay", 500);
+		ctx.mapTimeout = conf.getNumber("OVERLAY", "mapTimeout", 2000);
+		ctx.summaryInterval = conf.getNumber("OVERLAY", "summaryInterval",
+				1000);
+		ctx.retainedMemory = conf.getNumber("OVERLAY", "retainedMemory");
+		ctx.retainBySource = conf.getBoolean("OVERLAY", "retainBySource");
+		auto retained = ctx.retainedMemory / sizeof(Message);
+		if (retained > Message::poolSize() / RETAINED_SHARE) {
+			retained = Message::poolSize() / RETAINED_SHARE;
+			WH_LOG_WARNING("Retained publications limited to %llu messages",
+					retained);
+		}
+		values.setLimit(retained);
+		ctx.queueSegmentSize = conf.getNumber("OVERLAY", "queueSegmentSize",
+				4194304);
+		ctx.queueSegments = Twiddler::min(
+				conf.getNumber("OVERLAY", "queueSegments", 8),
+				MessageLog::MAX_SEGMENTS);
+		ctx.queueTTL = conf.getNumber("OVERLAY", "queueTTL", 86400);
+		ctx.queueDepth = conf.getNumber("OVERLAY", "queueDepth", 256);
+		ctx.queueQuota = conf.getNumber("OVERLAY", "queueQuota", 4096);
+		ctx.queueCommitInterval = conf.getNumber("OVERLAY",
+				"queueCommitInterval", 100);
+		ctx.bypassController = conf.getBoolean("OVERLAY", "bypassController");
+		memset(ctx.capabilityKey, 0, sizeof(ctx.capabilityKey));
+		strncpy(ctx.capabilityKey,
+				conf.getString("OVERLAY", "capabilityKey", ""),
+				sizeof(ctx.capabilityKey) - 1);
+		ctx.dnsTTL = conf.getNumber("OVERLAY", "dnsTTL", 300);
+		ctx.dnsNegativeTTL = conf.getNumber("OVERLAY", "dnsNegativeTTL", 30);
+		ctx.fallbackDelay = conf.getNumber("OVERLAY", "fallbackDelay", 2000);
 		auto netmaskStr = conf.getString("OVERLAY", "netMask", "0x0");
 		sscanf(netmaskStr, "%llx", &ctx.netMask);
 		ctx.groupId = conf.getNumber("OVERLAY", "groupId");
@@ -88,13 +163,57 @@ void OverlayHub::configure(void *arg) {
 		}
 		ctx.bootstrapNodes[n] = 0;
 
+		//The primary controller followed by the standby replicas
+		ctx.controllers[0] = CONTROLLER;
+		n = Identity::getIdentifiers("BOOTSTRAP", "controllers",
+				ctx.controllers + 1, ArraySize(ctx.controllers) - 1);
+		if (!n) {
+			n = Identity::getIdentifiers(ctx.controllers + 1,
+					ArraySize(ctx.controllers) - 1, Hosts::CONTROLLER);
+		}
+		ctx.replicas = n + 1;
+		ctx.failbackInterval = conf.getNumber("OVERLAY", "failbackInterval",
+				60000);
+
 		WH_LOG_DEBUG(
-				"Overlay hub settings: \n" "ENABLE_REGISTRATION=%s, AUTHENTICATE_CLIENTS=%s, CONNECT_TO_OVERLAY=%s,\n" "TABLE_UPDATE_CYCLE=%ums, BLOCKING_IO_TIMEOUT=%ums, RETRY_INTERVAL=%ums,\n" "NETMASK=%#llx, GROUP_ID=%u\n",
+				"Overlay hub settings: \n" "ENABLE_REGISTRATION=%s, AUTHENTICATE_CLIENTS=%s, CONNECT_TO_OVERLAY=%s,\n" "ONE_HOP=%s, TABLE_UPDATE_CYCLE=%ums [%ums, %ums], BLOCKING_IO_TIMEOUT=%ums,\n" "RETRY_INTERVAL=%ums, " "FINGER_CANDIDATES=%u, SUSPICION_THRESHOLD=%.2f, ACCEPTABLE_PAUSE=%ums,\n" "BATCH_FRAME_SIZE=%u, BATCH_DELAY=%uus,\n" "MAP_TIMEOUT=%ums, SUMMARY_INTERVAL=%ums, RETAINED_MEMORY=%llu, RETAIN_BY_SOURCE=%s,\n" "QUEUE_SEGMENT_SIZE=%u, QUEUE_SEGMENTS=%u, QUEUE_TTL=%us, QUEUE_DEPTH=%u, QUEUE_QUOTA=%u,\n" "QUEUE_COMMIT_INTERVAL=%ums, " "BYPASS_CONTROLLER=%s, CAPABILITIES=%s, CONTROLLER_REPLICAS=%u, FAILBACK_INTERVAL=%ums,\n" "DNS_TTL=%us, DNS_NEGATIVE_TTL=%us, FALLBACK_DELAY=%ums,\n" "NETMASK=%#llx, GROUP_ID=%u\n",
 				WH_BOOLF(ctx.enableRegistration),
 				WH_BOOLF(ctx.authenticateClient),
-				WH_BOOLF(ctx.connectToOverlay), ctx.updateCycle,
-				ctx.requestTimeout, ctx.retryInterval, ctx.netMask,
+				WH_BOOLF(ctx.connectToOverlay), WH_BOOLF(ctx.oneHop),
+				ctx.updateCycle, ctx.minUpdateCycle, ctx.maxUpdateCycle,
+				ctx.requestTimeout, ctx.retryInterval, ctx.fingerCandidates,
+				ctx.suspicionThreshold, ctx.acceptablePause, ctx.batchFrameSize, ctx.batchDelay, ctx.mapTimeout,
+				ctx.summaryInterval, ctx.retainedMemory,
+				WH_BOOLF(ctx.retainBySource), ctx.queueSegmentSize,
+				ctx.queueSegments, ctx.queueTTL, ctx.queueDepth,
+				ctx.queueQuota, ctx.queueCommitInterval, WH_BOOLF(ctx.bypassController),
+				WH_BOOLF(ctx.capabilityKey[0]), ctx.replicas, ctx.failbackInterval, ctx.dnsTTL,
+				ctx.dnsNegativeTTL, ctx.fallbackDelay, ctx.netMask,
 				ctx.groupId);
+		//Store-and-forward queues are disabled if the path is not set
+		auto queuePath = conf.getPathName("OVERLAY", "queuePath");
+		try {
+			if (queuePath && ctx.queueSegments) {
+				mailbox.log.open(queuePath, ctx.queueSegmentSize,
+						ctx.queueSegments);
+				mailbox.log.setLimits(ctx.queueTTL, ctx.queueDepth,
+						ctx.queueQuota);
+				WH_LOG_DEBUG("Store-and-forward log: %s (%u messages)",
+						queuePath, mailbox.log.count());
+			}
+			free(queuePath);
+		} catch (...) {
+			free(queuePath);
+			throw;
+		}
+		//This hub is the first known member of the overlay network
+		if (isSupernode() && updateMember(getKey(), time(nullptr), true)) {
+			indexMembers();
+		}
+		//Name lookups must not stall the stabilization
+		if (isSupernode()) {
+			resolver.start(ctx.dnsTTL, ctx.dnsNegativeTTL, onResolution, this);
+		}
 		installService();
 		installSettingsMonitor();
 	} catch (const BaseException &e) {
@@ -111,7 +230,14 @@ void OverlayHub::cleanup() noexcept {
 		stabilizer.notify();
 	}
 
+	for (auto &slot : batches.slots) {
+		Message::recycle(slot.msg);
+		slot.msg = nullptr;
+	}
+
+	resolver.stop();
 	clear();
+	mailbox.log.close();
 	//Clean up the base class
 	Hub::cleanup();
 }
@@ -120,6 +246,17 @@ bool OverlayHub::trap(Message *message) noexcept {
 	return (bool) processRegistrationRequest(message);
 }
 
+void OverlayHub::defer(Message *message) noexcept {
+	//Only the clients of this hub reach here (routing ends at the root)
+	auto destination = message->getDestination();
+	if (mailbox.log.isOpen() && isExternalNode(destination)
+			&& !isEphemeralId(destination)
+			&& !message->testFlags(MSG_INVALID)) {
+		mailbox.log.put(destination, message->getSource(), message->buffer(),
+				message->getLength());
+	}
+}
+
 void OverlayHub::route(Message *message) noexcept {
 	//-----------------------------------------------------------------
 	/*
@@ -154,12 +291,42 @@ void OverlayHub::route(Message *message) noexcept {
 	/*
 	 * [DELIVERY]: deliver to the local destination
 	 */
-	if (isExternalNode(message->getDestination())) {
+	if (isWorkerId(message->getDestination())) {
+		//Tell the stabilizer about the overlay link used by the response
+		auto origin = message->getOrigin();
+		message->writeLabel(hasDirectLink(origin) ? origin : 0);
+	} else if (isExternalNode(message->getDestination())) {
 		message->writeLabel(0); //Clean up the label
 	}
+	//-----------------------------------------------------------------
+	/*
+	 * [BATCHING]: combine the small frames bound for the same overlay node
+	 */
+	if (batch(message)) {
+		message->setDestination(getUid()); //The original will be recycled
+	}
 }
 
 void OverlayHub::maintain() noexcept {
+	//Don't hold on to the batches if the hub may go idle
+	flushBatches(!batches.active);
+	batches.active = false;
+	expireMapJobs();
+	warmUp();
+	drain();
+
+	if (ctx.oneHop && isSupernode()) {
+		fixMembers();
+	}
+
+	if (isSupernode()) {
+		advertise();
+	}
+
+	if (isSupernode()) {
+		failback();
+	}
+
 	if (!isStable()) {
 		setStable(true);
 		if (fixController()) {
@@ -173,6 +340,14 @@ void OverlayHub::processAlarm(unsigned long long uid,
 	tokens.fill(DEF_TOKENS_COUNT);
 }
 
+void OverlayHub::processEvent(unsigned long long uid,
+		unsigned long long events) noexcept {
+	if (uid == 0 && events) {
+		//Name lookups have completed, retry the pending connections
+		setStable(false);
+	}
+}
+
 void OverlayHub::processInotification(unsigned long long uid,
 		const InotifyEvent *event) noexcept {
 	if (event->wd == -1) { //overflow notification
@@ -216,7 +391,9 @@ void OverlayHub::installService() {
 	worker.id = w->getUid(); //set here
 	onRegistration(w);
 	stabilizer.configure(fd, ctx.bootstrapNodes, ctx.updateCycle,
-			ctx.retryInterval);
+			ctx.retryInterval, ctx.fingerCandidates, ctx.oneHop,
+			ctx.suspicionThreshold, ctx.acceptablePause, ctx.minUpdateCycle,
+			ctx.maxUpdateCycle);
 }
 
 void OverlayHub::installSettingsMonitor() {
@@ -263,6 +440,12 @@ void OverlayHub::installSettingsMonitor() {
 			watchlist[7].context = Identity::CTX_SSL_PRIVATE;
 		}
 
+		if (auto path = dataPathName(Identity::CTX_HOSTS_SNAPSHOT); path) {
+			watchlist[8].identifier = track(path,
+					IN_ATTRIB | IN_CLOSE_WRITE | IN_MOVE_SELF | IN_DELETE_SELF);
+			watchlist[8].context = Identity::CTX_HOSTS_SNAPSHOT;
+		}
+
 	} catch (const BaseException &e) {
 		WH_LOG_EXCEPTION(e);
 		throw;
@@ -270,6 +453,11 @@ void OverlayHub::installSettingsMonitor() {
 }
 
 void OverlayHub::updateSettings(unsigned int index) noexcept {
+	if (watchlist[index].context == Identity::CTX_HOSTS_SNAPSHOT) {
+		updateHostsSnapshot(index);
+		return;
+	}
+
 	//REF: https://github.com/guard/guard/wiki/Analysis-of-inotify-events-for-different-editors
 	if (watchlist[index].events & IN_IGNORED) {
 		//Associated file will no longer be monitored
@@ -365,17 +553,84 @@ void OverlayHub::updateSettings(unsigned int index) noexcept {
 	}
 }
 
+void OverlayHub::updateHostsSnapshot(unsigned int index) noexcept {
+	/*
+	 * A new snapshot replaces the old one by renaming, the watch must follow
+	 * the pathname rather than the (unlinked) file.
+	 */
+	auto &w = watchlist[index];
+	auto events = w.events;
+	w.events = 0;
+	if (!(events & IN_IGNORED)) {
+		untrack(w.identifier);
+	}
+	w.identifier = -1;
+
+	try {
+		auto path = dataPathName(Identity::CTX_HOSTS_SNAPSHOT);
+		w.identifier = track(path,
+				IN_ATTRIB | IN_CLOSE_WRITE | IN_MOVE_SELF | IN_DELETE_SELF);
+		Identity::reload(Identity::CTX_HOSTS_SNAPSHOT);
+		WH_LOG_DEBUG("Hosts snapshot has been replaced");
+	} catch (const BaseException &e) {
+		//Continue with the current snapshot
+		WH_LOG_EXCEPTION(e);
+	}
+}
+
 bool OverlayHub::fixController() noexcept {
 	//Establish a connection with the controller
 	return connectToRoute(CONTROLLER, &sessions[TABLESIZE]);
 }
 
+void OverlayHub::failover() noexcept {
+	if (ctx.replicas < 2) {
+		return;
+	}
+	/*
+	 * Deterministic takeover: the replicas are always probed in the order of
+	 * rank starting from the primary. Losing an established session restarts
+	 * the probe from the primary, a failed attempt moves on to the next rank.
+	 * Hence, every supernode settles on the lowest-ranked reachable replica.
+	 * The replicas are tried back-to-back until each one of them has failed
+	 * once, after that the stabilizer's maintenance requests pace the
+	 * attempts.
+	 */
+	if (controller.connected) {
+		controller.connected = false;
+		controller.rank = 0;
+	} else {
+		controller.rank = (controller.rank + 1) % ctx.replicas;
+	}
+
+	WH_LOG_INFO("Switching to the controller's replica %llu",
+			ctx.controllers[controller.rank]);
+	if (++controller.failures < ctx.replicas) {
+		setStable(false);
+	}
+}
+
+void OverlayHub::failback() noexcept {
+	if (!controller.rank || !controller.connected || !ctx.failbackInterval
+			|| !controller.timer.hasTimedOut(ctx.failbackInterval)) {
+		return;
+	}
+
+	//Drop the standby's session, the probe restarts from the primary
+	controller.timer.now();
+	auto w = find(CONTROLLER);
+	if (w) {
+		WH_LOG_INFO("Probing the primary controller");
+		disable(w);
+	}
+}
+
 bool OverlayHub::fixRoutingTable() noexcept {
 	//Fall through the routing table and fix the errors
 	for (unsigned int i = 0; i < TABLESIZE; i++) {
 		if (!isConsistent(i)) {
 			auto old = commit(i);
-			if (!isInRoute(old)) {
+			if (!isInRoute(old) && !isMember(old)) {
 				auto conn = find(old);
 				//Take care of the reference asymmetry
 				if (conn && conn->isType(SOCKET_PROXY)) {
@@ -411,9 +666,25 @@ bool OverlayHub::connectToRoute(unsigned long long id, Digest *hc) noexcept {
 
 void OverlayHub::onRegistration(Watcher *w) noexcept {
 	auto id = w->getUid();
+	if (isExternalNode(id) && mailbox.log.count(id)) {
+		//Stored messages follow the registration response
+		mailbox.pending.put(id);
+	}
+
 	if (!isSupernode()) {
 		return;
-	} else if (isController(id) || isWorkerId(id)) {
+	}
+
+	if (w->isType(SOCKET_PROXY) && isInternalNode(id)) {
+		updatePreference(w, true);
+	}
+
+	if (isController(id) || isWorkerId(id)) {
+		if (isController(id)) {
+			controller.failures = 0;
+			controller.connected = true;
+			controller.timer.now();
+		}
 		w->setFlags(SOCKET_PRIORITY);
 		w->setOption(WATCHER_WRITE_BUFFER_MAX, 0); //default
 	} else if (isInternalNode(id)) {
@@ -426,11 +697,22 @@ void OverlayHub::onRegistration(Watcher *w) noexcept {
 }
 
 void OverlayHub::onRecycle(Watcher *w) noexcept {
+	//Outgoing connection attempt failed or got abandoned
+	if (w->testFlags(SOCKET_CONNECTING) && isSupernode()
+			&& isInternalNode(w->getUid())) {
+		updatePreference(w, false);
+	}
+
 	//If the worker connection failed then initiate shutdown
 	if (isWorkerId(w->getUid())) {
 		Hub::cancel();
 	}
 
+	//Connection with the controller failed
+	if (isController(w->getUid()) && isSupernode()) {
+		failover();
+	}
+
 	//Remove from the routing table
 	if (isInternalNode(w->getUid())) {
 		Node::update(w->getUid(), false);
@@ -438,11 +720,38 @@ void OverlayHub::onRecycle(Watcher *w) noexcept {
 
 	//Remove from the topics
 	if (w->testFlags(WATCHER_MULTICAST)) {
-		for (unsigned int i = 0; i < Topic::COUNT; i++) {
-			if (w->testTopic(i)) {
-				topics.remove(i, w);
-			}
+		uint64_t filter;
+		while (patterns.get(w, 0, filter)) {
+			unsubscribe(w, filter);
 		}
+		topics.remove(w);
+		summaries.dirty = true;
+	}
+}
+
+void OverlayHub::updatePreference(Watcher *w, bool success) noexcept {
+	auto id = w->getUid();
+	NameInfo ni;
+	try {
+		Identity::getAddress(
+				isController(id) ? ctx.controllers[controller.rank] : id, ni);
+	} catch (const BaseException &e) {
+		return;
+	}
+
+	auto family = w->getOption(WATCHER_ADDRESS_FAMILY);
+	if (success) {
+		Connector::succeeded(ni.host, family);
+	} else {
+		Connector::failed(ni.host, family);
+	}
+}
+
+void OverlayHub::onResolution(void *arg) noexcept {
+	try {
+		static_cast<OverlayHub*>(arg)->alert(1);
+	} catch (const BaseException &e) {
+		WH_LOG_EXCEPTION(e);
 	}
 }
 
@@ -601,7 +910,12 @@ bool OverlayHub::createRoute(Message *message) noexcept {
 	auto origin = message->getOrigin();
 	auto destination = message->getDestination();
 	if (isWorkerId(origin)) {
-		if (!isHostId(destination)) {
+		if (isHostId(destination)) {
+			//Local request
+		} else if (ctx.bypassController && hasDirectLink(destination)) {
+			//Stabilization request sent over the overlay link
+			message->setDestination(destination);
+		} else {
 			//Stabilization request sent via controller
 			message->setDestination(CONTROLLER);
 		}
@@ -610,8 +924,14 @@ bool OverlayHub::createRoute(Message *message) noexcept {
 			//Stabilization response returned via controller
 			message->setDestination(getWorkerId());
 		}
+	} else if (ctx.bypassController && isInternalNode(origin)
+			&& isValidStabilizationResponse(message)) {
+		//Stabilization response returned over the overlay link
+		message->setDestination(getWorkerId());
 	} else if (allowCommunication(origin, destination)) {
-		message->setDestination(getNextHop(destination));
+		//Only the first hop is direct, the rest follow the finger tables
+		message->setDestination(
+				getNextHop(destination, isExternalNode(origin)));
 	} else {
 		//Highly likely a miscommunication
 		if (!(isHostId(destination) || isController(destination))) {
@@ -623,8 +943,26 @@ bool OverlayHub::createRoute(Message *message) noexcept {
 	return true;
 }
 
-unsigned long long OverlayHub::getNextHop(
-		unsigned long long destination) const noexcept {
+unsigned long long OverlayHub::getNextHop(unsigned long long destination,
+		bool direct) noexcept {
+	//One-hop route: straight to the root if it's connected
+	if (direct && ctx.oneHop && !isController(destination)) {
+		auto k = mapKey(destination);
+		auto root = members.root[k];
+		if (root && !isHostId(root) && !isLocal(k) && isConverged()) {
+			auto w = find(root);
+			if (w && w->testFlags(SOCKET_OVERLAY)
+					&& w->testFlags(WATCHER_ACTIVE)) {
+				return root;
+			}
+		}
+	}
+	//-----------------------------------------------------------------
+	//Fast path: cached route of a remote destination
+	auto &route = routes[destination & (ROUTECACHE_SIZE - 1)];
+	if (route.destination == destination && route.version == getVersion()) {
+		return route.next;
+	}
 	/*
 	 * CASE 1: destination is "local" or <destination> = <Controller>
 	 * In such case do nothing and allow the server take care of it
@@ -636,7 +974,10 @@ unsigned long long OverlayHub::getNextHop(
 	auto k = mapKey(destination);
 	if (!isLocal(k) && !isController(destination)) {
 		//Case 2
-		return nextHop(k);
+		route.destination = destination;
+		route.version = getVersion();
+		route.next = nextHop(k);
+		return route.next;
 	} else {
 		return destination;
 	}
@@ -647,14 +988,16 @@ bool OverlayHub::allowCommunication(unsigned long long source,
 	/*
 	 * 1. Both Source and Destination must be active IDs
 	 * 2. Destination cannot be controller or worker IDs
-	 * 3. Allow client -> supernode communication only via controller
+	 * 3. Allow client -> supernode communication only via controller, or
+	 * if the client has presented a capability
 	 * 4. Apply netmask over all client -> * communications
 	 */
 	auto checkActive = !isEphemeralId(source) && !isEphemeralId(destination);
 	auto checkDestinations = !(isController(destination)
 			|| isWorkerId(destination));
 	auto checkPrivilege = isController(getUid())
-			|| !(isExternalNode(source) && isInternalNode(destination));
+			|| !(isExternalNode(source) && isInternalNode(destination))
+			|| isAuthorized(source);
 
 	return checkActive && checkDestinations && checkPrivilege
 			&& checkMask(source, destination);
@@ -666,6 +1009,235 @@ bool OverlayHub::checkMask(unsigned long long source,
 			|| ((source & ctx.netMask) == (destination & ctx.netMask));
 }
 
+bool OverlayHub::isAuthorized(unsigned long long uid) const noexcept {
+	//The capability's validity ends with it's expiration time
+	auto w = find(uid);
+	return w && w->testFlags(SOCKET_PRIVILEGED)
+			&& w->getOption(WATCHER_PRIVILEGE_EXPIRY)
+					> (unsigned long long) time(nullptr);
+}
+
+bool OverlayHub::hasDirectLink(unsigned long long uid) const noexcept {
+	if (!isInternalNode(uid) || isController(uid) || isHostId(uid)) {
+		return false;
+	}
+
+	auto w = find(uid);
+	return w && w->testFlags(SOCKET_OVERLAY) && w->testFlags(WATCHER_ACTIVE);
+}
+
+bool OverlayHub::isPeerRequest(const Message *msg) const noexcept {
+	/*
+	 * The overlay links are authenticated during registration and the hubs
+	 * overwrite the source of every client's message. Hence, a request whose
+	 * source matches it's origin was created by the neighbor's stabilizer.
+	 */
+	auto origin = msg->getOrigin();
+	return ctx.bypassController && msg->getSource() == origin
+			&& hasDirectLink(origin);
+}
+
+bool OverlayHub::batch(Message *message) noexcept {
+	auto next = message->getDestination();
+	if (!ctx.batchFrameSize) {
+		return false;
+	} else if (message->getLength() > ctx.batchFrameSize
+			|| message->testFlags(MSG_PRIORITY | MSG_INVALID)
+			|| !isInternalNode(next) || isController(next) || isHostId(next)) {
+		//The frames waiting for the same hop go out first
+		flushBatch(next);
+		return false;
+	}
+
+	auto w = find(next);
+	if (!w || !w->testFlags(SOCKET_OVERLAY)
+			|| w->testGroup(message->getGroup())) {
+		//Let the hub deal with it
+		flushBatch(next);
+		return false;
+	}
+	//-----------------------------------------------------------------
+	//Find the next hop's batch, or a free slot
+	decltype(&batches.slots[0]) slot = nullptr;
+	for (auto &s : batches.slots) {
+		if (s.msg && s.id == next) {
+			slot = &s;
+			break;
+		} else if (!s.msg && !slot) {
+			slot = &s;
+		}
+	}
+
+	if (!slot) {
+		return false;
+	} else if (slot->msg
+			&& (slot->msg->getLength() + message->getLength()) > Message::MTU) {
+		//Size limit reached
+		if (!forward(slot->msg)) {
+			Message::recycle(slot->msg);
+		}
+		slot->msg = nullptr;
+	}
+	//-----------------------------------------------------------------
+	if (!slot->msg) {
+		MessageHeader header;
+		header.setAddress(getUid(), next);
+		header.setControl(Message::HEADER_SIZE, 0, 0);
+		header.setContext(WH_DHT_CMD_OVERLAY, WH_DHT_QLF_BATCH,
+				WH_DHT_AQLF_REQUEST);
+		if (!(slot->msg = Message::create(getUid()))) {
+			return false;
+		} else if (!slot->msg->putHeader(header)) {
+			Message::recycle(slot->msg);
+			slot->msg = nullptr;
+			return false;
+		} else {
+			slot->id = next;
+			slot->timer.now();
+		}
+	}
+
+	batches.active = true;
+	if (slot->msg->appendBytes(message->buffer(), message->getLength())) {
+		return true;
+	} else {
+		flushBatch(next);
+		return false;
+	}
+}
+
+void OverlayHub::flushBatches(bool force) noexcept {
+	for (auto &slot : batches.slots) {
+		if (!slot.msg) {
+			continue;
+		} else if (force
+				|| (slot.timer.elapsed() * Timer::MS_IN_SEC) >= ctx.batchDelay) {
+			if (!forward(slot.msg)) {
+				Message::recycle(slot.msg);
+			}
+			slot.msg = nullptr;
+		}
+	}
+}
+
+void OverlayHub::flushBatch(unsigned long long id) noexcept {
+	for (auto &slot : batches.slots) {
+		if (slot.msg && slot.id == id) {
+			//Goes into the outgoing queue ahead of the current message
+			if (!forward(slot.msg)) {
+				Message::recycle(slot.msg);
+			}
+			slot.msg = nullptr;
+			return;
+		}
+	}
+}
+
+bool OverlayHub::updateMember(unsigned int key, unsigned int incarnation,
+		bool alive) noexcept {
+	if (key < MIN_ID || key > MAX_ID) {
+		return false;
+	}
+
+	auto &m = members.table[key];
+	if (!incarnation) {
+		//Local failure report: applies to the latest known incarnation
+		if (alive || !m.alive) {
+			return false;
+		} else {
+			incarnation = m.incarnation;
+		}
+	}
+
+	if (incarnation < m.incarnation) {
+		return false;
+	} else if (incarnation == m.incarnation && (alive || !m.alive)) {
+		return false;
+	} else if (isHostId(key) && !alive) {
+		//Refute the rumor of this hub's failure
+		m.incarnation = incarnation + 1;
+		m.alive = true;
+	} else {
+		m.incarnation = incarnation;
+		m.alive = alive;
+	}
+
+	++members.version;
+	return true;
+}
+
+void OverlayHub::indexMembers() noexcept {
+	//Two passes over the ring take care of the wrap around
+	unsigned int root = 0;
+	unsigned int count = 0;
+	for (auto i = 2 * MAX_NODES; i-- > 0;) {
+		auto k = i & MAX_ID;
+		if (k && members.table[k].alive) {
+			root = k;
+			count += (i < MAX_NODES);
+		}
+
+		if (i < MAX_NODES) {
+			members.root[k] = root;
+		}
+	}
+
+	members.count = count;
+}
+
+bool OverlayHub::isMember(unsigned int key) const noexcept {
+	return ctx.oneHop && key >= MIN_ID && key <= MAX_ID
+			&& members.table[key].alive;
+}
+
+bool OverlayHub::isConverged() noexcept {
+	if (members.checked[0] == members.version
+			&& members.checked[1] == getVersion()) {
+		return members.converged;
+	}
+
+	members.checked[0] = members.version;
+	members.checked[1] = getVersion();
+	/*
+	 * Nothing should lie between this hub and it's neighbors, otherwise the
+	 * membership information is still spreading.
+	 */
+	auto key = getKey();
+	auto p = getPredecessor();
+	members.converged = members.table[key].alive
+			&& members.root[successor(key, 0)] == getSuccessor()
+			&& (!p || members.root[successor(p, 0)] == key);
+	return members.converged;
+}
+
+void OverlayHub::fixMembers() noexcept {
+	if (!members.timer.hasTimedOut(ctx.updateCycle)) {
+		return;
+	}
+
+	members.timer.now();
+	unsigned int attempts = 0;
+	for (unsigned int i = 0; i < MAX_ID && attempts < MEMBERS_CONNECT; ++i) {
+		members.next = (members.next % MAX_ID) + 1;
+		auto k = members.next;
+		if (!members.table[k].alive || isHostId(k) || find(k)) {
+			continue;
+		}
+
+		++attempts;
+		//Drop the stale nonce before the connection overwrites it
+		unsigned int owner;
+		auto nk = nonceKey(&members.sessions[k]);
+		if (members.nonces.hmGet(nk, owner) && owner == k) {
+			members.nonces.removeKey(nk);
+		}
+
+		if (connectToRoute(k, &members.sessions[k])) {
+			members.nonces.hmReplace(nonceKey(&members.sessions[k]), k, owner);
+		}
+	}
+}
+
 bool OverlayHub::process(Message *message) noexcept {
 	switch (message->getCommand()) {
 	case WH_DHT_CMD_NULL:
@@ -715,6 +1287,12 @@ bool OverlayHub::processBasicRequest(Message *message) noexcept {
 		} else {
 			return handleInvalidRequest(message);
 		}
+	case WH_DHT_QLF_AUTHORIZE:
+		if (message->getStatus() == WH_DHT_AQLF_REQUEST) {
+			return handleAuthorizeRequest(message);
+		} else {
+			return handleInvalidRequest(message);
+		}
 	default:
 		return handleInvalidRequest(message);
 	}
@@ -725,7 +1303,7 @@ bool OverlayHub::processMulticastRequest(Message *message) noexcept {
 		return handleInvalidRequest(message);
 	}
 
-	if (isSupernode() || isInternalNode(message->getOrigin())
+	if (isInternalNode(message->getOrigin())
 			|| isEphemeralId(message->getOrigin())
 			|| message->getStatus() != WH_DHT_AQLF_REQUEST) {
 		return handleInvalidRequest(message);
@@ -733,11 +1311,20 @@ bool OverlayHub::processMulticastRequest(Message *message) noexcept {
 
 	switch (message->getQualifier()) {
 	case WH_DHT_QLF_PUBLISH:
+	case WH_DHT_QLF_XPUBLISH:
 		return handlePublishRequest(message);
 	case WH_DHT_QLF_SUBSCRIBE:
+	case WH_DHT_QLF_XSUBSCRIBE:
 		return handleSubscribeRequest(message);
 	case WH_DHT_QLF_UNSUBSCRIBE:
+	case WH_DHT_QLF_XUNSUBSCRIBE:
 		return handleUnsubscribeRequest(message);
+	case WH_DHT_QLF_NPUBLISH:
+		return handlePublishRequest(message);
+	case WH_DHT_QLF_NSUBSCRIBE:
+		return handleNamedSubscribeRequest(message);
+	case WH_DHT_QLF_NUNSUBSCRIBE:
+		return handleNamedUnsubscribeRequest(message);
 	default:
 		return handleInvalidRequest(message);
 	}
@@ -748,7 +1335,8 @@ bool OverlayHub::processNodeRequest(Message *message) noexcept {
 		return handleInvalidRequest(message);
 	}
 
-	if (!(isController(message->getOrigin()) || isWorkerId(message->getOrigin()))
+	if (!(isController(message->getOrigin()) || isWorkerId(message->getOrigin())
+			|| isPeerRequest(message))
 			|| message->getStatus() != WH_DHT_AQLF_REQUEST) {
 		return handleInvalidRequest(message);
 	}
@@ -770,6 +1358,10 @@ bool OverlayHub::processNodeRequest(Message *message) noexcept {
 		return handleGetNeighboursRequest(message);
 	case WH_DHT_QLF_NOTIFY:
 		return handleNotifyRequest(message);
+	case WH_DHT_QLF_GETMEMBERS:
+		return handleGetMembersRequest(message);
+	case WH_DHT_QLF_SETMEMBERS:
+		return handleSetMembersRequest(message);
 	default:
 		return handleInvalidRequest(message);
 	}
@@ -780,9 +1372,16 @@ bool OverlayHub::processOverlayRequest(Message *message) noexcept {
 		return handleInvalidRequest(message);
 	}
 
-	if (!isPrivileged(message->getOrigin())
-			|| message->getStatus() != WH_DHT_AQLF_REQUEST) {
+	if (!isPrivileged(message->getOrigin())) {
 		return handleInvalidRequest(message);
+	} else if (message->getStatus() != WH_DHT_AQLF_REQUEST) {
+		//Partial results of the ring-wide aggregation
+		if (message->getQualifier() == WH_DHT_QLF_MAP
+				&& isInternalNode(message->getOrigin())) {
+			return handleMapResponse(message);
+		} else {
+			return handleInvalidRequest(message);
+		}
 	}
 
 	switch (message->getQualifier()) {
@@ -792,6 +1391,12 @@ bool OverlayHub::processOverlayRequest(Message *message) noexcept {
 		return handlePingNodeRequest(message);
 	case WH_DHT_QLF_MAP:
 		return handleMapRequest(message);
+	case WH_DHT_QLF_BATCH:
+		return handleBatchRequest(message);
+	case WH_DHT_QLF_SUMMARY:
+		return handleSummaryRequest(message);
+	case WH_DHT_QLF_MULTICAST:
+		return handleMulticastRequest(message);
 	default:
 		return handleInvalidRequest(message);
 	}
@@ -1075,54 +1680,101 @@ bool OverlayHub::handleBootstrapRequest(Message *msg) noexcept {
 	return true;
 }
 
+bool OverlayHub::handleAuthorizeRequest(Message *msg) noexcept {
+	/*
+	 * HEADER: SRC=0, DEST=X, ....CMD=1, QLF=4, AQLF=0/1/127
+	 * BODY: 8 bytes as <expiry> + 64 bytes as <tag> in Request; nothing
+	 * in Response
+	 * TOTAL: 32+8+64=104 bytes in Request; 32 bytes in Response
+	 */
+	auto origin = msg->getOrigin();
+	auto conn = find(origin);
+	uint64_t expiry = 0;
+	Digest tag;
+	//-----------------------------------------------------------------
+	auto valid = conn && isExternalNode(origin) && !isEphemeralId(origin)
+			&& ctx.capabilityKey[0]
+			&& msg->getPayloadLength() == sizeof(uint64_t) + Hash::SIZE
+			&& (expiry = msg->getData64(0)) > (uint64_t) time(nullptr)
+			&& Protocol::createCapability(origin, expiry, ctx.capabilityKey,
+					hash, &tag)
+			&& Hash::compare(
+					(const Digest*) msg->getBytes(sizeof(uint64_t)), &tag);
+	//-----------------------------------------------------------------
+	if (valid) {
+		conn->setOption(WATCHER_PRIVILEGE_EXPIRY, expiry);
+		conn->setFlags(SOCKET_PRIVILEGED);
+	}
+	buildDirectResponse(msg, Message::HEADER_SIZE);
+	msg->putStatus(valid ? WH_DHT_AQLF_ACCEPTED : WH_DHT_AQLF_REJECTED);
+	return true;
+}
+
 bool OverlayHub::handlePublishRequest(Message *msg) noexcept {
 	/*
-	 * HEADER: SRC=0, DEST=X, ....CMD=2, QLF=0, AQLF=0/1/127
-	 * BODY: variable in Request; no Response
-	 * TOTAL: at least 32 bytes in Request; no Response
+	 * HEADER: SRC=0, DEST=X, ....CMD=2, QLF=0/3/6, AQLF=0/1/127
+	 * BODY: variable in Request (QLF=3: starts with 8 bytes as <topic>,
+	 * QLF=6: starts with 1 byte as <length> + <length> bytes as <name>);
+	 * no Response
+	 * TOTAL: at least 32 bytes in Request (QLF=3: at least 32+8=40 bytes,
+	 * QLF=6: at least 32+1+1=34 bytes); no Response
 	 */
-	Watcher *sub = nullptr;
-	unsigned int index = 0;
-	auto topic = msg->getSession();
-	while ((sub = topics.get(topic, index))) {
-		if (sub->getUid() != msg->getOrigin()
-				&& checkMask(msg->getOrigin(), sub->getUid())
-				&& !sub->testGroup(msg->getGroup()) && sub->publish(msg)
-				&& sub->isReady()) {
-			retain(sub);
-		}
-		++index;
+	uint64_t topic;
+	const char *name;
+	unsigned int length;
+	if (!getTopic(msg, topic) && !getTopicName(msg, name, length)) {
+		return handleInvalidRequest(msg);
 	}
 
 	msg->writeLabel(0); //Clean up internal information
 	msg->writeDestination(0); //There are multiple destinations
 	msg->writeStatus(WH_DHT_AQLF_ACCEPTED); //Prevent rebound
+
+	deliver(msg);
+	if (isSupernode()) {
+		//Subscribers attached to the other hubs
+		disseminate(msg, getUid());
+	}
+
+	store(msg);
 	msg->addReferenceCount(); //Account for Hub::publish
 	return true;
 }
 
 bool OverlayHub::handleSubscribeRequest(Message *msg) noexcept {
 	/*
-	 * HEADER: SRC=0, DEST=X, ....CMD=2, QLF=1, AQLF=0/1/127
-	 * BODY: 0 in Request; 0 in Response
-	 * TOTAL: 32 bytes in Request; 32 bytes in Response
+	 * HEADER: SRC=0, DEST=X, ....CMD=2, QLF=1/4, AQLF=0/1/127
+	 * BODY: optional content filter (N*12 bytes) in Request; same in Response
+	 * (QLF=4: preceded by 8 bytes as <topic> in both)
+	 * TOTAL: 32+N*12 bytes in Request; same in Response (QLF=4: 32+8+N*12
+	 * bytes in both)
 	 */
-	if (msg->getLength() != Message::HEADER_SIZE) {
+	uint64_t topic;
+	ContentFilter *content = nullptr;
+	auto offset = (msg->getQualifier() == WH_DHT_QLF_XSUBSCRIBE) ?
+			sizeof(uint64_t) : 0;
+	if (!getTopic(msg, topic) || !createFilter(msg, offset, content)) {
 		return handleInvalidRequest(msg);
 	}
 
-	buildDirectResponse(msg, Message::HEADER_SIZE);
+	buildDirectResponse(msg, msg->getLength());
 	msg->writeSource(0); //Obfuscate the source (this hub)
 
-	auto topic = msg->getSession();
 	auto conn = find(msg->getOrigin());
+	auto subscribed = conn && topics.contains(topic, conn);
 
 	if (!conn) {
+		delete content;
 		return handleInvalidRequest(msg);
-	} else if (conn->testTopic(topic)) {
-		msg->putStatus(WH_DHT_AQLF_ACCEPTED);
-	} else if (topics.put(topic, conn)) {
-		conn->setTopic(topic);
+	} else if (topics.put(topic, conn, content)) { //Replaces the filter
+		if (!subscribed) {
+			conn->setFlags(WATCHER_MULTICAST);
+			summaries.dirty = true;
+		}
+
+		if (!subscribed && values.count()) {
+			warmups.pending.put( { conn->getUid(), topic });
+		}
 		msg->putStatus(WH_DHT_AQLF_ACCEPTED);
 	} else {
 		msg->putStatus(WH_DHT_AQLF_REJECTED);
@@ -1132,23 +1784,99 @@ bool OverlayHub::handleSubscribeRequest(Message *msg) noexcept {
 
 bool OverlayHub::handleUnsubscribeRequest(Message *msg) noexcept {
 	/*
-	 * HEADER: SRC=0, DEST=X, ....CMD=2, QLF=2, AQLF=0/1/127
-	 * BODY: 0 in Request; 0 in Response
-	 * TOTAL: 32 bytes in Request; 32 bytes in Response
+	 * HEADER: SRC=0, DEST=X, ....CMD=2, QLF=2/5, AQLF=0/1/127
+	 * BODY: 0 in Request; 0 in Response (QLF=5: 8 bytes as <topic> in both)
+	 * TOTAL: 32 bytes in Request; 32 bytes in Response (QLF=5: 32+8=40
+	 * bytes in both)
 	 */
-	if (msg->getLength() != Message::HEADER_SIZE) {
+	uint64_t topic;
+	auto length = msg->getLength();
+	auto expected = Message::HEADER_SIZE
+			+ ((msg->getQualifier() == WH_DHT_QLF_XUNSUBSCRIBE) ?
+					sizeof(uint64_t) : 0);
+	if (!getTopic(msg, topic) || length != expected) {
 		return handleInvalidRequest(msg);
 	}
 
-	auto topic = msg->getSession();
 	auto conn = find(msg->getOrigin());
 
-	if (conn && conn->testTopic(topic)) {
-		conn->clearTopic(topic);
+	if (conn && topics.contains(topic, conn)) {
 		topics.remove(topic, conn);
+		if (!topics.subscriptions(conn) && !patterns.subscriptions(conn)) {
+			conn->clearFlags(WATCHER_MULTICAST);
+		}
+		summaries.dirty = true;
 	}
 
-	buildDirectResponse(msg, Message::HEADER_SIZE);
+	buildDirectResponse(msg, length);
+	msg->writeSource(0); //Obfuscate the source (this hub)
+	msg->putStatus(WH_DHT_AQLF_ACCEPTED);
+	return true;
+}
+
+bool OverlayHub::handleNamedSubscribeRequest(Message *msg) noexcept {
+	/*
+	 * HEADER: SRC=0, DEST=X, ....CMD=2, QLF=7, AQLF=0/1/127
+	 * BODY: 1 byte as <length> + <length> bytes as <filter> + optional
+	 * content filter (N*12 bytes) in Request; same in Response
+	 * TOTAL: at least 32+1+1=34 bytes in Request; same in Response
+	 */
+	const char *filter;
+	unsigned int length;
+	ContentFilter *content = nullptr;
+	if (!getTopicName(msg, filter, length)
+			|| !createFilter(msg, 1 + length, content)) {
+		return handleInvalidRequest(msg);
+	}
+
+	auto conn = find(msg->getOrigin());
+	if (!conn) {
+		delete content;
+		return handleInvalidRequest(msg);
+	}
+
+	auto id = filters.insert(filter, length);
+	auto status = WH_DHT_AQLF_ACCEPTED;
+	auto subscribed = id && patterns.contains(id, conn);
+	if (!id) {
+		delete content;
+		status = WH_DHT_AQLF_REJECTED;
+	} else if (!patterns.put(id, conn, content)) { //Replaces the filter
+		unsubscribe(conn, id);
+		status = WH_DHT_AQLF_REJECTED;
+	} else if (!subscribed) {
+		conn->setFlags(WATCHER_MULTICAST);
+		summaries.dirty = true;
+	}
+
+	buildDirectResponse(msg, msg->getLength());
+	msg->writeSource(0); //Obfuscate the source (this hub)
+	msg->putStatus(status);
+	return true;
+}
+
+bool OverlayHub::handleNamedUnsubscribeRequest(Message *msg) noexcept {
+	/*
+	 * HEADER: SRC=0, DEST=X, ....CMD=2, QLF=8, AQLF=0/1/127
+	 * BODY: 1 byte as <length> + <length> bytes as <filter> in Request;
+	 * same in Response
+	 * TOTAL: at least 32+1+1=34 bytes in Request; same in Response
+	 */
+	const char *filter;
+	unsigned int length;
+	if (!getTopicName(msg, filter, length)
+			|| msg->getPayloadLength() != 1 + length) {
+		return handleInvalidRequest(msg);
+	}
+
+	auto conn = find(msg->getOrigin());
+	auto id = filters.find(filter, length);
+	if (conn && id && patterns.contains(id, conn)) {
+		unsubscribe(conn, id);
+		summaries.dirty = true;
+	}
+
+	buildDirectResponse(msg, msg->getLength());
 	msg->writeSource(0); //Obfuscate the source (this hub)
 	msg->putStatus(WH_DHT_AQLF_ACCEPTED);
 	return true;
@@ -1313,16 +2041,85 @@ bool OverlayHub::handleNotifyRequest(Message *msg) noexcept {
 	return true;
 }
 
-bool OverlayHub::handleFindSuccesssorRequest(Message *msg) noexcept {
+bool OverlayHub::handleGetMembersRequest(Message *msg) noexcept {
 	/*
-	 * HEADER: SRC=0, DEST=X, ....CMD=4, QLF=0, AQLF=0/1/127
-	 * BODY: 8 bytes as <id> in Request; 8 bytes as <id> and 8 bytes
+	 * HEADER: SRC=0, DEST=X, ....CMD=3, QLF=8, AQLF=0/1/127
+	 * BODY: 4 bytes as <start> in Request; 4 bytes as <start> + 4 bytes
+	 * as <next> + 8*N bytes as <records> in Response
+	 * TOTAL: 32+4=36 bytes in Request; 32+8+8*N bytes in Response
+	 */
+	if (msg->getPayloadLength() != sizeof(uint32_t)) {
+		return handleInvalidRequest(msg);
+	}
+
+	auto start = msg->getData32(0);
+	unsigned int count = 0;
+	unsigned int next = 0;
+	for (auto k = Twiddler::max(start, MIN_ID); k <= MAX_ID; ++k) {
+		if (!members.table[k].incarnation) {
+			continue;
+		} else if (count == OverlayProtocol::MEMBERS_PAGE) {
+			next = k;
+			break;
+		} else {
+			auto record = OverlayProtocol::toMemberRecord(k,
+					members.table[k].incarnation, members.table[k].alive);
+			msg->setData64(2 * sizeof(uint32_t) + count * sizeof(uint64_t),
+					record);
+			++count;
+		}
+	}
+
+	buildDirectResponse(msg,
+			Message::HEADER_SIZE + 2 * sizeof(uint32_t)
+					+ count * sizeof(uint64_t));
+	msg->putStatus(WH_DHT_AQLF_ACCEPTED);
+	msg->setData32(0, start);
+	msg->setData32(sizeof(uint32_t), next);
+	return true;
+}
+
+bool OverlayHub::handleSetMembersRequest(Message *msg) noexcept {
+	/*
+	 * HEADER: SRC=0, DEST=X, ....CMD=3, QLF=9, AQLF=0/1/127
+	 * BODY: 8*N bytes as <records> in Request; 0 bytes in Response
+	 * TOTAL: 32+8*N bytes in Request; 32 bytes in Response
+	 */
+	auto length = msg->getPayloadLength();
+	if (!isWorkerId(msg->getOrigin()) || (length % sizeof(uint64_t))
+			|| (length / sizeof(uint64_t)) > OverlayProtocol::MEMBERS_PAGE) {
+		return handleInvalidRequest(msg);
+	}
+
+	auto changed = false;
+	for (unsigned int i = 0; i < length; i += sizeof(uint64_t)) {
+		uint32_t key, incarnation;
+		bool alive;
+		OverlayProtocol::fromMemberRecord(msg->getData64(i), key, incarnation,
+				alive);
+		changed = updateMember(key, incarnation, alive) || changed;
+	}
+
+	if (changed) {
+		indexMembers();
+		WH_LOG_DEBUG("Membership updated: %u alive", members.count);
+	}
+
+	buildDirectResponse(msg, Message::HEADER_SIZE);
+	msg->putStatus(WH_DHT_AQLF_ACCEPTED);
+	return true;
+}
+
+bool OverlayHub::handleFindSuccesssorRequest(Message *msg) noexcept {
+	/*
+	 * HEADER: SRC=0, DEST=X, ....CMD=4, QLF=0, AQLF=0/1/127
+	 * BODY: 8 bytes as <id> in Request; 8 bytes as <id> and 8 bytes
 	 * as <successor> in Response
 	 * TOTAL: 32+8=40 bytes in Request; 32+8+8=48 bytes in Response
 	 */
 	auto origin = msg->getOrigin();
 	//-----------------------------------------------------------------
-	if (!(isController(origin) || isWorkerId(origin))) {
+	if (!(isController(origin) || isWorkerId(origin) || isPeerRequest(msg))) {
 		return handleInvalidRequest(msg);
 	}
 
@@ -1365,7 +2162,8 @@ bool OverlayHub::handlePingNodeRequest(Message *msg) noexcept {
 		buildDirectResponse(msg);
 		msg->putStatus(WH_DHT_AQLF_ACCEPTED);
 		return true;
-	} else if (isController(origin) || isController(getUid())) {
+	} else if (isController(origin) || isController(getUid())
+			|| isPeerRequest(msg)) {
 		buildDirectResponse(msg);
 		msg->putStatus(WH_DHT_AQLF_ACCEPTED);
 		return true;
@@ -1376,68 +2174,737 @@ bool OverlayHub::handlePingNodeRequest(Message *msg) noexcept {
 
 bool OverlayHub::handleMapRequest(Message *msg) noexcept {
 	/*
-	 * HEADER: SRC=0, DEST=X, ....CMD=4, QLF=2, AQLF=0/1/127
-	 * BODY: variable in Request; variable in Response
-	 * TOTAL: at least 32 bytes in Request and Response
+	 * HEADER: SRC=X, DEST=Y, ....CMD=4, QLF=2, AQLF=0/1/127
+	 * BODY: 28 bytes as <argument, limit, function, tag, timeout> in Request;
+	 * 24 bytes as <result, nodes, partial, function, tag> in Response
+	 * TOTAL: 32+28=60 bytes in Request; 32+24=56 bytes in Response
 	 */
+	uint64_t argument = 0;
+	uint64_t limit = 0;
+	uint32_t function = 0;
+	uint32_t tag = 0;
+	uint32_t timeout = 0;
+	if (msg->getPayloadLength() != MAP_REQUEST_BYTES
+			|| !msg->unpack<MapRequest>(argument, limit, function, tag,
+					timeout)) {
+		return handleInvalidRequest(msg);
+	}
+
 	auto origin = msg->getOrigin();
-	auto source = msg->getSource();
 	//-----------------------------------------------------------------
+	if (isController(origin)) {
+		//Entry point: aggregate over the whole identifier ring
+		limit = getUid();
+		msg->setData32(MapRequest::offset<3>(), 0);
+	} else if (!isInternalNode(origin) || msg->getSource() != origin || !tag
+			|| limit > MAX_ID) {
+		//Only a parent node can forward a map request
+		return handleInvalidRequest(msg);
+	}
+
+	if (!timeout || timeout > ctx.mapTimeout) {
+		timeout = ctx.mapTimeout;
+		msg->setData32(MapRequest::offset<4>(), timeout);
+	}
+	//-----------------------------------------------------------------
+	uint64_t local = 0;
+	if (!mapReduce.map(function, this, argument, local)) {
+		//Unknown function
+		buildMapResponse(msg, 0, 0, true, false);
+		return true;
+	}
+
+	switch (startMapJob(msg, local, limit)) {
+	case 1:
+		//The response will be sent after aggregation
+		msg->setDestination(getUid());
+		return true;
+	case 0:
+		//Leaf node
+		buildMapResponse(msg, local, 1, false, true);
+		return true;
+	default:
+		//Couldn't reach the subtree
+		buildMapResponse(msg, local, 1, true, true);
+		return true;
+	}
+}
+
+bool OverlayHub::handleMapResponse(Message *msg) noexcept {
+	/*
+	 * HEADER: SRC=X, DEST=Y, ....CMD=4, QLF=2, AQLF=0/1
+	 * BODY: 24 bytes as <result, nodes, partial, function, tag>
+	 * TOTAL: 32+24=56 bytes
+	 */
+	auto tag = msg->getData32(MapResult::offset<4>());
+	auto index = tag % MAPJOBS_SIZE;
+	auto &job = mapJobs.jobs[index];
+	//The response is consumed here
+	msg->setDestination(getUid());
+	if (msg->getPayloadLength() != MAP_RESPONSE_BYTES || !tag
+			|| job.tag != tag) {
+		//Late or invalid response
+		return true;
+	}
+	//-----------------------------------------------------------------
+	for (unsigned int i = 0; i < job.children; ++i) {
+		auto bit = (1U << i);
+		if (job.child[i] != msg->getSource() || (job.replies & bit)) {
+			continue;
+		}
+
+		job.replies |= bit;
+		uint64_t result = 0;
+		uint32_t nodes = 0;
+		uint32_t partial = 0;
+		uint32_t function = 0;
+		if (msg->getStatus() == WH_DHT_AQLF_ACCEPTED
+				&& msg->unpack<MapResult>(result, nodes, partial, function,
+						tag)) {
+			mapReduce.combine(job.function, job.result, result, job.result);
+			job.nodes += nodes;
+			job.partial = job.partial || partial;
+		} else {
+			job.partial = true;
+		}
+		break;
+	}
+
+	if (job.replies == ((1U << job.children) - 1)) {
+		completeMapJob(index);
+	}
+	return true;
+}
+
+bool OverlayHub::handleBatchRequest(Message *msg) noexcept {
 	/*
-	 * Message insertion: at this point we are sure that this node is the
-	 * intended recipient.
+	 * HEADER: SRC=X, DEST=Y, ....CMD=4, QLF=3, AQLF=127
+	 * BODY: variable number of complete frames in Request; no Response
+	 * TOTAL: at least 32 bytes in Request
 	 */
-	if (isExternalNode(origin)) {
+	auto origin = msg->getOrigin();
+	if (!isInternalNode(origin) || isController(origin) || isWorkerId(origin)
+			|| msg->getSource() != origin) {
 		return handleInvalidRequest(msg);
-	} else if (isController(origin)) {
-		//Cache the source ID
-		if (msg->appendData64(source)) {
-			//Record the entry point
-			msg->putSource(getUid());
+	}
+	//-----------------------------------------------------------------
+	//Unpack the frames and route them as if they arrived individually
+	auto data = msg->getBytes(0);
+	auto length = msg->getPayloadLength();
+	unsigned int offset = 0;
+	while (data && (offset + Message::HEADER_SIZE) <= length) {
+		auto frame = data + offset;
+		auto size = MessageHeader::readLength(frame);
+		if (size < Message::HEADER_SIZE || size > (length - offset)) {
+			break;
+		}
+
+		auto m = Message::create(origin);
+		if (!m) {
+			break;
+		}
+
+		m->setType(msg->getType());
+		m->putTrace(msg->getTrace());
+		m->setGroup(msg->getGroup());
+		if (!m->pack(frame) || !collect(m)) {
+			Message::recycle(m);
+			break;
+		}
+
+		offset += size;
+	}
+	//-----------------------------------------------------------------
+	//The container will be recycled
+	msg->setDestination(getUid());
+	return true;
+}
+
+unsigned int OverlayHub::getChildren(unsigned long long limit,
+		unsigned long long (&children)[TABLESIZE]) const noexcept {
+	unsigned int count = 0;
+	for (unsigned int i = 0; i < TABLESIZE; ++i) {
+		auto f = get(i);
+		if (f == getUid() || !isConnected(i) || !isBetween(f, getUid(), limit)) {
+			continue;
+		}
+
+		auto duplicate = false;
+		for (unsigned int j = 0; j < count; ++j) {
+			duplicate = duplicate || (children[j] == f);
+		}
+
+		if (duplicate) {
+			continue;
+		}
+
+		auto distance = (f - getUid()) & MAX_ID;
+		auto j = count++;
+		for (; j && ((children[j - 1] - getUid()) & MAX_ID) > distance; --j) {
+			children[j] = children[j - 1];
+		}
+		children[j] = f;
+	}
+
+	return count;
+}
+
+unsigned int OverlayHub::deliver(Message *msg) noexcept {
+	uint64_t topic;
+	const char *name;
+	unsigned int length;
+	if (getTopic(msg, topic)) {
+		return deliver(msg, getDataOffset(msg), topics, topic, false);
+	} else if (getTopicName(msg, name, length)) {
+		const unsigned int *ids = nullptr;
+		auto n = filters.match(name, length, ids);
+		unsigned int count = 0;
+		delivered.clear();
+		for (unsigned int i = 0; i < n; ++i) {
+			//A subscriber receives the publication only once
+			count += deliver(msg, getDataOffset(msg), patterns, ids[i], true);
+		}
+		return count;
+	} else {
+		return 0;
+	}
+}
+
+unsigned int OverlayHub::deliver(Message *msg, unsigned int offset,
+		const Topics &index, uint64_t topic, bool once) noexcept {
+	Watcher *sub = nullptr;
+	const ContentFilter *content = nullptr;
+	unsigned int i = 0;
+	unsigned int count = 0;
+	while ((sub = index.get(topic, i++, content))) {
+		if (accepts(sub, msg, content, offset)
+				&& (!once || delivered.hsPut(sub)) && sub->publish(msg)) {
+			++count;
+			if (sub->isReady()) {
+				retain(sub);
+			}
+		}
+	}
+
+	return count;
+}
+
+bool OverlayHub::accepts(const Watcher *sub, const Message *msg,
+		const ContentFilter *content, unsigned int offset) const noexcept {
+	auto source = msg->getSource(); //The publisher
+	return sub->getUid() != source && checkMask(source, sub->getUid())
+			&& !sub->testGroup(msg->getGroup())
+			&& (!content || content->evaluate(msg, offset));
+}
+
+void OverlayHub::unsubscribe(Watcher *w, unsigned int filter) noexcept {
+	patterns.remove(filter, w);
+	if (!patterns.count(filter)) {
+		filters.remove(filter);
+	}
+
+	if (!topics.subscriptions(w) && !patterns.subscriptions(w)) {
+		w->clearFlags(WATCHER_MULTICAST);
+	}
+}
+
+bool OverlayHub::store(Message *msg) noexcept {
+	uint64_t topic;
+	if (values.getLimit() && getTopic(msg, topic)) {
+		return values.put(topic, ctx.retainBySource ? msg->getSource() : 0,
+				msg);
+	} else {
+		return false;
+	}
+}
+
+void OverlayHub::warmUp() noexcept {
+	Warmup w;
+	while (warmups.ready.get(w)) {
+		auto sub = find(w.uid);
+		const ContentFilter *content = nullptr;
+		if (!sub || !topics.lookup(w.topic, sub, content)) {
+			continue;
+		}
+
+		Message *last[WARMUP_SIZE];
+		auto n = values.get(w.topic, last, WARMUP_SIZE);
+		for (unsigned int i = 0; i < n; ++i) {
+			if (accepts(sub, last[i], content, getDataOffset(last[i]))
+					&& sub->publish(last[i]) && sub->isReady()) {
+				retain(sub);
+			}
+		}
+	}
+	//-----------------------------------------------------------------
+	//Subscription responses of these requests have been queued by now
+	while (warmups.pending.get(w)) {
+		warmups.ready.put(w);
+	}
+}
+
+void OverlayHub::drain() noexcept {
+	if (!mailbox.log.isOpen()) {
+		return;
+	}
+
+	unsigned long long uid;
+	for (unsigned int i = 0; mailbox.ready.get(uid, i);) {
+		if (unload(uid)) {
+			++i;
 		} else {
-			//Invalid message length
-			return handleInvalidRequest(msg);
+			mailbox.ready.remove(i);
+		}
+	}
+	//-----------------------------------------------------------------
+	//Registration responses of these clients have been queued by now
+	while (mailbox.pending.get(uid)) {
+		mailbox.ready.put(uid);
+	}
+	//-----------------------------------------------------------------
+	//Group commit
+	if (mailbox.timer.hasTimedOut(ctx.queueCommitInterval)) {
+		mailbox.timer.now();
+		mailbox.log.compact();
+		mailbox.log.commit();
+	}
+}
+
+bool OverlayHub::unload(unsigned long long uid) noexcept {
+	auto w = find(uid);
+	if (!w) {
+		return false;
+	}
+
+	for (unsigned int i = 0; i < DRAIN_SIZE; ++i) {
+		unsigned int length;
+		auto frame = mailbox.log.peek(uid, length);
+		if (!frame) {
+			return false;
+		}
+
+		auto m = Message::create(getUid());
+		if (!m) {
+			return true; //Try again
+		} else if (!m->pack(frame)) {
+			//Corrupted
+			Message::recycle(m);
+			mailbox.log.pop(uid);
+		} else if (!w->publish(m)) {
+			//Connection's queue is full, try again
+			Message::recycle(m);
+			return true;
+		} else {
+			mailbox.log.pop(uid);
+			if (w->isReady()) {
+				retain(w);
+			}
+		}
+	}
+	return mailbox.log.count(uid);
+}
+
+unsigned int OverlayHub::disseminate(const Message *msg,
+		unsigned long long limit) noexcept {
+	unsigned long long children[TABLESIZE];
+	auto count = getChildren(limit, children);
+	auto length = msg->getLength();
+	uint64_t topic;
+	if (!count || (length + MULTICAST_HEADER_BYTES) > Message::PAYLOAD_SIZE) {
+		return 0;
+	} else if (msg->getQualifier() == WH_DHT_QLF_NPUBLISH) {
+		//Hubs which have the topic filters
+		topic = FILTERS_TOPIC;
+	} else if (!getTopic(msg, topic)) {
+		return 0;
+	}
+	//-----------------------------------------------------------------
+	//Hubs which (probably) have subscribers to the topic
+	unsigned short matched[MAX_NODES];
+	unsigned int n = 0;
+	for (unsigned int i = 0; i < summaries.count; ++i) {
+		auto k = summaries.keys[i];
+		if (summaries.table[k].filter.test(topic)) {
+			matched[n++] = k;
+		}
+	}
+	//-----------------------------------------------------------------
+	//Each child covers the interval up to the next child
+	unsigned int sent = 0;
+	for (unsigned int i = 0; i < count && n; ++i) {
+		auto first = children[i];
+		auto last = (i + 1 < count) ? children[i + 1] : limit;
+		auto found = false;
+		for (unsigned int j = 0; j < n && !found; ++j) {
+			found = (matched[j] == first) || isBetween(matched[j], first, last);
+		}
+
+		if (!found) {
+			continue;
+		}
+
+		MessageHeader header;
+		header.setAddress(getUid(), first);
+		header.setControl(Message::HEADER_SIZE + MULTICAST_HEADER_BYTES + length,
+				0, 0);
+		header.setContext(WH_DHT_CMD_OVERLAY, WH_DHT_QLF_MULTICAST,
+				WH_DHT_AQLF_REQUEST);
+
+		auto m = Message::create(getUid());
+		if (m && m->putHeader(header) && m->setData64(0, last)
+				&& m->setData32(8, msg->getGroup())
+				&& m->setBytes(MULTICAST_HEADER_BYTES, msg->buffer(), length)
+				&& forward(m)) {
+			++sent;
+		} else {
+			Message::recycle(m);
+		}
+	}
+
+	return sent;
+}
+
+void OverlayHub::advertise() noexcept {
+	auto interval = ctx.summaryInterval;
+	if (!summaries.timer.hasTimedOut(
+			summaries.dirty ? interval : interval * SUMMARY_REFRESH)) {
+		return;
+	}
+
+	summaries.timer.now();
+	summaries.dirty = false;
+	expireSummaries();
+	//-----------------------------------------------------------------
+	TopicSummary local;
+	if (!local.reset(topics.size() + 1)) {
+		return;
+	}
+
+	topics.iterate(summarize, &local);
+	if (filters.count()) {
+		local.insert(FILTERS_TOPIC);
+	}
+
+	//The whole ring except this hub
+	spreadSummary(getUid(), local.data(), local.size(), getUid());
+}
+
+void OverlayHub::spreadSummary(unsigned long long owner,
+		const unsigned char *summary, unsigned int size,
+		unsigned long long limit) noexcept {
+	unsigned long long children[TABLESIZE];
+	auto count = getChildren(limit, children);
+	for (unsigned int i = 0; i < count; ++i) {
+		MessageHeader header;
+		header.setAddress(owner, children[i]);
+		header.setControl(Message::HEADER_SIZE + SUMMARY_HEADER_BYTES + size,
+				0, 0);
+		header.setContext(WH_DHT_CMD_OVERLAY, WH_DHT_QLF_SUMMARY,
+				WH_DHT_AQLF_REQUEST);
+
+		auto m = Message::create(getUid());
+		if (!(m && m->putHeader(header)
+				&& m->setData64(0, (i + 1 < count) ? children[i + 1] : limit)
+				&& m->setBytes(SUMMARY_HEADER_BYTES, summary, size)
+				&& forward(m))) {
+			Message::recycle(m);
+		}
+	}
+}
+
+void OverlayHub::expireSummaries() noexcept {
+	auto expiry = ctx.summaryInterval * SUMMARY_REFRESH * SUMMARY_EXPIRY;
+	for (unsigned int i = 0; i < summaries.count;) {
+		auto k = summaries.keys[i];
+		if (summaries.table[k].timer.hasTimedOut(expiry)) {
+			summaries.table[k].valid = false;
+			summaries.keys[i] = summaries.keys[--summaries.count];
+		} else {
+			++i;
+		}
+	}
+}
+
+int OverlayHub::summarize(uint64_t topic, void *arg) noexcept {
+	static_cast<TopicSummary*>(arg)->insert(topic);
+	return 0;
+}
+
+bool OverlayHub::getTopic(const Message *msg, uint64_t &topic) noexcept {
+	switch (msg->getQualifier()) {
+	case WH_DHT_QLF_PUBLISH:
+	case WH_DHT_QLF_SUBSCRIBE:
+	case WH_DHT_QLF_UNSUBSCRIBE:
+		topic = msg->getSession();
+		return true;
+	case WH_DHT_QLF_XPUBLISH:
+	case WH_DHT_QLF_XSUBSCRIBE:
+	case WH_DHT_QLF_XUNSUBSCRIBE:
+		//The classic topics and the reserved identifiers are excluded
+		if (msg->getPayloadLength() >= sizeof(uint64_t)) {
+			topic = msg->getData64(0);
+			return topic > Topic::MAX_ID && topic != FILTERS_TOPIC;
+		} else {
+			return false;
+		}
+	default:
+		return false;
+	}
+}
+
+bool OverlayHub::createFilter(const Message *msg, unsigned int offset,
+		ContentFilter *&filter) noexcept {
+	filter = nullptr;
+	auto length = msg->getPayloadLength();
+	if (length < offset) {
+		return false;
+	} else if (length == offset) {
+		return true;
+	} else if (!(filter = new (std::nothrow) ContentFilter())) {
+		return false;
+	} else if (filter->compile(msg->getBytes(offset), length - offset)) {
+		return true;
+	} else {
+		delete filter;
+		filter = nullptr;
+		return false;
+	}
+}
+
+unsigned int OverlayHub::getDataOffset(const Message *msg) noexcept {
+	switch (msg->getQualifier()) {
+	case WH_DHT_QLF_XPUBLISH:
+		return sizeof(uint64_t);
+	case WH_DHT_QLF_NPUBLISH:
+		return 1 + msg->getData8(0);
+	default:
+		return 0;
+	}
+}
+
+bool OverlayHub::getTopicName(const Message *msg, const char *&name,
+		unsigned int &length) noexcept {
+	switch (msg->getQualifier()) {
+	case WH_DHT_QLF_NPUBLISH:
+	case WH_DHT_QLF_NSUBSCRIBE:
+	case WH_DHT_QLF_NUNSUBSCRIBE:
+		if (msg->getPayloadLength() >= 1
+				&& msg->getPayloadLength() >= 1U + msg->getData8(0)) {
+			length = msg->getData8(0);
+			name = (const char*) msg->getBytes(1);
+			return length != 0;
+		} else {
+			return false;
 		}
-	} else if (isExternalNode(source) || origin != getPredecessor()
-			|| msg->getPayloadLength() < sizeof(uint64_t)) {
-		//Routing around the ring: invalid message
+	default:
+		return false;
+	}
+}
+
+bool OverlayHub::handleSummaryRequest(Message *msg) noexcept {
+	/*
+	 * HEADER: SRC=X, DEST=Y, ....CMD=4, QLF=4, AQLF=127
+	 * BODY: 8 bytes as <limit> + N*64 bytes as <summary> in Request; no
+	 * Response
+	 * TOTAL: 32+8+N*64 bytes in Request
+	 */
+	auto origin = msg->getOrigin();
+	auto owner = msg->getSource();
+	auto size = msg->getPayloadLength() - SUMMARY_HEADER_BYTES;
+	if (!isInternalNode(origin) || isController(origin) || isWorkerId(origin)
+			|| !isInternalNode(owner) || isController(owner) || isHostId(owner)
+			|| msg->getPayloadLength() < SUMMARY_HEADER_BYTES
+			|| !TopicSummary::isValid(size) || msg->getData64(0) > MAX_ID) {
 		return handleInvalidRequest(msg);
 	}
 	//-----------------------------------------------------------------
+	auto &entry = summaries.table[owner];
+	if (!entry.valid) {
+		entry.valid = true;
+		summaries.keys[summaries.count++] = owner;
+	}
+	entry.timer.now();
+	entry.filter.load(msg->getBytes(SUMMARY_HEADER_BYTES), size);
+	spreadSummary(owner, msg->getBytes(SUMMARY_HEADER_BYTES), size,
+			msg->getData64(0));
+	//-----------------------------------------------------------------
+	//The request will be recycled
+	msg->setDestination(getUid());
+	return true;
+}
+
+bool OverlayHub::handleMulticastRequest(Message *msg) noexcept {
 	/*
-	 * Execute and forward
+	 * HEADER: SRC=X, DEST=Y, ....CMD=4, QLF=5, AQLF=127
+	 * BODY: 8 bytes as <limit> + 4 bytes as <group> + a complete publication
+	 * in Request; no Response
+	 * TOTAL: at least 32+12+32=76 bytes in Request
 	 */
-	auto result = mapFunction(msg);
-	auto successor = getSuccessor();
-	if (result == 0
-			&& (isHostId(source) || !isInRange(source, getUid(), successor))
-			&& getUid() != successor) {
-		/*
-		 * Forward the Message around the identifier ring until it reaches the
-		 * predecessor of the node where the message was originally inserted (or
-		 * a hole).
-		 */
-		msg->putDestination(successor);
-	} else {
-		//Return back to the originator, final step
-		auto index = msg->getLength()
-				- (sizeof(uint64_t) + Message::HEADER_SIZE);
-		auto destination = msg->getData64(index);
-
-		msg->setDestination(0);
-		msg->writeDestination(destination);
-		msg->putSource(getUid());
-		msg->putLength(Message::HEADER_SIZE);
-		msg->putStatus(
-				(result == 0 || result == 1) ?
-						WH_DHT_AQLF_ACCEPTED : WH_DHT_AQLF_REJECTED);
+	auto origin = msg->getOrigin();
+	auto length = msg->getPayloadLength();
+	if (!isInternalNode(origin) || isController(origin) || isWorkerId(origin)
+			|| msg->getSource() != origin || msg->getData64(0) > MAX_ID
+			|| length < (MULTICAST_HEADER_BYTES + Message::HEADER_SIZE)
+			|| MessageHeader::readLength(msg->getBytes(MULTICAST_HEADER_BYTES))
+					!= (length - MULTICAST_HEADER_BYTES)) {
+		return handleInvalidRequest(msg);
 	}
+	//-----------------------------------------------------------------
+	auto m = Message::create(origin);
+	unsigned int count = 0;
+	if (m && m->pack(msg->getBytes(MULTICAST_HEADER_BYTES))
+			&& m->getCommand() == WH_DHT_CMD_MULTICAST
+			&& (m->getQualifier() == WH_DHT_QLF_PUBLISH
+					|| m->getQualifier() == WH_DHT_QLF_XPUBLISH
+					|| m->getQualifier() == WH_DHT_QLF_NPUBLISH)) {
+		m->setGroup(msg->getData32(8));
+		disseminate(m, msg->getData64(0));
+		count = deliver(m);
+		count += store(m) ? 1 : 0;
+	}
+
+	//The subscribers' connections and the retained values own the publication
+	if (!count) {
+		Message::recycle(m);
+	}
+	//-----------------------------------------------------------------
+	//The container will be recycled
+	msg->setDestination(getUid());
 	return true;
 }
 
-int OverlayHub::mapFunction(Message *msg) noexcept {
-	WH_LOG_ALERT("~~Received a Map Request~~");
-	return 0;
+int OverlayHub::startMapJob(Message *msg, uint64_t local,
+		uint64_t limit) noexcept {
+	unsigned long long children[TABLESIZE];
+	auto count = getChildren(limit, children);
+	if (!count) {
+		return 0;
+	}
+	//-----------------------------------------------------------------
+	unsigned int index = 0;
+	while (index < MAPJOBS_SIZE && mapJobs.jobs[index].tag) {
+		++index;
+	}
+
+	if (index == MAPJOBS_SIZE) {
+		return -1;
+	}
+
+	//Tag is never zero (0)
+	mapJobs.sequence = (mapJobs.sequence % (UINT32_MAX / MAPJOBS_SIZE)) + 1;
+
+	auto &job = mapJobs.jobs[index];
+	job.tag = (mapJobs.sequence * MAPJOBS_SIZE) + index;
+	job.parent = msg->getData32(MapRequest::offset<3>());
+	msg->getHeader(job.header);
+	job.origin = msg->getOrigin();
+	job.function = msg->getData32(MapRequest::offset<2>());
+	job.timeout = msg->getData32(MapRequest::offset<4>());
+	job.timer.now();
+	job.result = local;
+	job.nodes = 1;
+	job.partial = false;
+	job.children = 0;
+	job.replies = 0;
+	//-----------------------------------------------------------------
+	/*
+	 * Each child covers the interval up to the next child. The children get a
+	 * shorter deadline so that this node receives their (partial) results.
+	 */
+	for (unsigned int i = 0; i < count; ++i) {
+		MessageHeader header;
+		header.setAddress(getUid(), children[i]);
+		header.setControl(0, 0, 0);
+		header.setContext(WH_DHT_CMD_OVERLAY, WH_DHT_QLF_MAP,
+				WH_DHT_AQLF_REQUEST);
+
+		//Zero (0) would mean the default timeout to the child
+		auto m = Message::create(getUid());
+		if (m && m->pack<MapRequest>(header,
+						msg->getData64(MapRequest::offset<0>()),
+						(i + 1 < count) ? children[i + 1] : limit,
+						job.function, job.tag,
+						Twiddler::max(job.timeout - job.timeout / 4, 1U))
+				&& forward(m)) {
+			job.child[job.children++] = children[i];
+		} else {
+			Message::recycle(m);
+			job.partial = true;
+		}
+	}
+
+	if (job.children) {
+		mapJobs.count += 1;
+		return 1;
+	} else {
+		job.tag = 0;
+		return -1;
+	}
+}
+
+void OverlayHub::completeMapJob(unsigned int index) noexcept {
+	auto &job = mapJobs.jobs[index];
+	if (!job.tag) {
+		return;
+	}
+
+	auto partial = job.partial || (job.replies != ((1U << job.children) - 1));
+	auto msg = Message::create(job.origin);
+	if (msg && msg->putHeader(job.header)) {
+		msg->setData32(MapResult::offset<3>(), job.function);
+		msg->setData32(MapResult::offset<4>(), job.parent);
+		buildMapResponse(msg, job.result, job.nodes, partial, true);
+		if (!forward(msg)) {
+			Message::recycle(msg);
+		}
+	} else {
+		Message::recycle(msg);
+	}
+
+	job.tag = 0;
+	mapJobs.count -= 1;
+}
+
+void OverlayHub::expireMapJobs() noexcept {
+	for (unsigned int i = 0; mapJobs.count && i < MAPJOBS_SIZE; ++i) {
+		auto &job = mapJobs.jobs[i];
+		if (job.tag && job.timer.hasTimedOut(job.timeout)) {
+			completeMapJob(i);
+		}
+	}
+}
+
+void OverlayHub::buildMapResponse(Message *msg, uint64_t result,
+		unsigned int nodes, bool partial, bool accepted) noexcept {
+	//Function and tag are already in place
+	buildDirectResponse(msg, Message::HEADER_SIZE + MAP_RESPONSE_BYTES);
+	msg->putStatus(accepted ? WH_DHT_AQLF_ACCEPTED : WH_DHT_AQLF_REJECTED);
+	msg->setData64(MapResult::offset<0>(), result);
+	msg->setData32(MapResult::offset<1>(), nodes);
+	msg->setData32(MapResult::offset<2>(), partial);
+}
+
+void OverlayHub::installMapFunctions() noexcept {
+	mapReduce.set(WH_DHT_MAP_NODES, mapNodes, MapReduce::sum);
+	mapReduce.set(WH_DHT_MAP_CONNECTIONS, mapConnections, MapReduce::sum);
+	mapReduce.set(WH_DHT_MAP_SUBSCRIBERS, mapSubscribers, MapReduce::sum);
+	mapReduce.set(WH_DHT_MAP_MESSAGES, mapMessages, MapReduce::max);
+}
+
+uint64_t OverlayHub::mapNodes(void *hub, uint64_t arg) noexcept {
+	return 1;
+}
+
+uint64_t OverlayHub::mapConnections(void *hub, uint64_t arg) noexcept {
+	return Socket::allocated();
+}
+
+uint64_t OverlayHub::mapSubscribers(void *hub, uint64_t arg) noexcept {
+	return ((OverlayHub*) hub)->topics.count(arg);
+}
+
+uint64_t OverlayHub::mapMessages(void *hub, uint64_t arg) noexcept {
+	return Message::allocated();
 }
 
 void OverlayHub::buildDirectResponse(Message *msg, unsigned int length) noexcept {
@@ -1475,9 +2942,22 @@ unsigned long long OverlayHub::nonceToId(const Digest *nonce) const noexcept {
 		return get(i);
 	} else if (i == TABLESIZE) {
 		return CONTROLLER;
-	} else {
-		return getUid();
 	}
+
+	unsigned int k;
+	if (ctx.oneHop && members.nonces.hmGet(nonceKey(nonce), k)
+			&& memcmp(nonce, &members.sessions[k], sizeof(Digest)) == 0) {
+		return k;
+	}
+
+	return getUid();
+}
+
+unsigned long long OverlayHub::nonceKey(const Digest *hc) noexcept {
+	//Nonces are random, their leading bytes are good enough as the key
+	unsigned long long key;
+	memcpy(&key, hc, sizeof(key));
+	return key;
 }
 
 unsigned long long OverlayHub::getWorkerId() const noexcept {
@@ -1549,12 +3029,35 @@ Watcher* OverlayHub::connect(unsigned long long id, Digest *hc) {
 	} else if (conn->hasTimedOut(ctx.requestTimeout)) {
 		disable(conn);
 		return nullptr;
+	} else if (isStalled(conn)) {
+		//Fall back to the other address family (see OverlayHub::onRecycle)
+		disable(conn);
+		setStable(false);
+		return nullptr;
 	} else {
 		//wait for registration or time-out
 		return nullptr;
 	}
 }
 
+bool OverlayHub::isStalled(const Watcher *conn) noexcept {
+	if (!ctx.fallbackDelay || !conn->testFlags(SOCKET_CONNECTING)
+			|| !conn->hasTimedOut(ctx.fallbackDelay)) {
+		return false;
+	}
+
+	NameInfo ni;
+	auto id = conn->getUid();
+	try {
+		Identity::getAddress(
+				isController(id) ? ctx.controllers[controller.rank] : id, ni);
+	} catch (const BaseException &e) {
+		return false;
+	}
+	return Connector::hasAlternative(ni.host,
+			conn->getOption(WATCHER_ADDRESS_FAMILY));
+}
+
 Watcher* OverlayHub::createProxyConnection(unsigned long long id, Digest *hc) {
 	Socket *conn = nullptr;
 	try {
@@ -1563,8 +3066,34 @@ Watcher* OverlayHub::createProxyConnection(unsigned long long id, Digest *hc) {
 		}
 
 		NameInfo ni;
-		Identity::getAddress(id, ni);
-		conn = new Socket(ni);
+		Identity::getAddress(
+				isController(id) ? ctx.controllers[controller.rank] : id, ni);
+		if (!strcasecmp(ni.service, "unix")) {
+			conn = new Socket(ni);
+		} else {
+			SocketAddress sa[Resolver::MAX_ADDRESSES];
+			unsigned int count = Resolver::MAX_ADDRESSES;
+			auto status = resolver.lookup(ni, sa, count);
+			if (status == 1) {
+				//Name resolution in progress (see OverlayHub::processEvent)
+				return nullptr;
+			} else if (status == -1) {
+				WH_LOG_DEBUG("Could not resolve %s", ni.host);
+				throw Exception(EX_OPERATION);
+			}
+
+			//Start with the address family which reached the host recently
+			Connector::order(ni.host, sa, count);
+			for (unsigned int i = 0; !conn && i < count; ++i) {
+				try {
+					conn = new Socket(sa[i]);
+				} catch (const BaseException &e) {
+					if (i + 1 == count) {
+						throw;
+					}
+				}
+			}
+		}
 		//-----------------------------------------------------------------
 		//A getKey request is automatically sent out
 		generateNonce(hash, conn->getUid(), getUid(), hc);
@@ -1580,6 +3109,9 @@ Watcher* OverlayHub::createProxyConnection(unsigned long long id, Digest *hc) {
 	} catch (const BaseException &e) {
 		WH_LOG_EXCEPTION(e);
 		delete conn;
+		if (isController(id) && isSupernode()) {
+			failover();
+		}
 		throw;
 	}
 }
@@ -1639,8 +3171,41 @@ void OverlayHub::clear() noexcept {
 
 	memset(&ctx, 0, sizeof(ctx));
 	memset(&nodes, 0, sizeof(nodes));
+	controller.rank = 0;
+	controller.failures = 0;
+	controller.connected = false;
+	memset(routes, 0, sizeof(routes));
+	batches.active = false;
+	for (auto &slot : batches.slots) {
+		slot.id = 0;
+		slot.msg = nullptr;
+	}
+
+	mapJobs.sequence = 0;
+	mapJobs.count = 0;
+	for (auto &job : mapJobs.jobs) {
+		job.tag = 0;
+	}
 	memset(sessions, 0, sizeof(sessions));
 
+	summaries.dirty = false;
+	summaries.count = 0;
+	for (auto &entry : summaries.table) {
+		entry.valid = false;
+		entry.filter.clear();
+	}
+
+	members.version = 0;
+	members.count = 0;
+	members.checked[0] = 0;
+	members.checked[1] = 0;
+	members.converged = false;
+	members.next = 0;
+	memset(members.table, 0, sizeof(members.table));
+	memset(members.root, 0, sizeof(members.root));
+	memset(members.sessions, 0, sizeof(members.sessions));
+	members.nonces.clear();
+
 	for (unsigned int i = 0; i < WATCHLIST_SIZE; ++i) {
 		watchlist[i].context = -1;
 		watchlist[i].identifier = -1;
@@ -1648,6 +3213,14 @@ void OverlayHub::clear() noexcept {
 	}
 
 	topics.clear();
+	filters.clear();
+	patterns.clear();
+	delivered.clear();
+	values.clear();
+	warmups.pending.clear();
+	warmups.ready.clear();
+	mailbox.pending.clear();
+	mailbox.ready.clear();
 }
 
 void OverlayHub::metrics(OverlayHubInfo &info) const noexcept {
@@ -1656,6 +3229,8 @@ void OverlayHub::metrics(OverlayHubInfo &info) const noexcept {
 	info.setSuccessor(getSuccessor());
 	info.setRoutes(TABLESIZE);
 	info.setStable(isStable());
+	info.setUpdateCycle(stabilizer.getUpdateCycle());
+	info.setFingerRefresh(stabilizer.getFingerRefresh());
 	for (unsigned int i = 0; i < TABLESIZE; ++i) {
 		auto f = getFinger(i);
 		RouteInfo ri = { f->getStart(), f->getId(), f->getOldId(),
@@ -12,9 +12,17 @@
 
 #ifndef WH_SERVER_OVERLAY_OVERLAYHUB_H_
 #define WH_SERVER_OVERLAY_OVERLAYHUB_H_
+#include "LastValues.h"
+#include "MapReduce.h"
+#include "MessageLog.h"
 #include "OverlayService.h"
 #include "Topics.h"
+#include "TopicTrie.h"
+#include "TopicSummary.h"
+#include "../../base/ds/Khash.h"
 #include "../../base/ds/Tokens.h"
+#include "../../base/ipc/Connector.h"
+#include "../../base/ipc/Resolver.h"
 #include "../../hub/Hub.h"
 
 namespace wanhive {
@@ -39,10 +47,13 @@ private:
 	void configure(void *arg) override;
 	void cleanup() noexcept override;
 	bool trap(Message *message) noexcept override;
+	void defer(Message *message) noexcept override;
 	void route(Message *message) noexcept override;
 	void maintain() noexcept override;
 	void processAlarm(unsigned long long uid, unsigned long long ticks) noexcept
 			override;
+	void processEvent(unsigned long long uid, unsigned long long events) noexcept
+			override;
 	void processInotification(unsigned long long uid,
 			const InotifyEvent *event) noexcept override;
 	bool enableWorker() const noexcept override;
@@ -52,7 +63,13 @@ private:
 	void installService();
 	void installSettingsMonitor();
 	void updateSettings(unsigned int index) noexcept;
+	//Snapshots are replaced by renaming, hence watched differently
+	void updateHostsSnapshot(unsigned int index) noexcept;
 	bool fixController() noexcept;
+	//Selects the controller's replica to probe after a failure
+	void failover() noexcept;
+	//Returns to the primary controller after a while on a standby replica
+	void failback() noexcept;
 	bool fixRoutingTable() noexcept;
 	bool connectToRoute(unsigned long long id, Digest *hc) noexcept;
 	//-----------------------------------------------------------------
@@ -62,6 +79,10 @@ private:
 	void onRecycle(Watcher *w) noexcept;
 	//Temporarily memorize the identifier
 	void addToCache(unsigned long long id) noexcept;
+	//Remember the address family of an outgoing connection's outcome
+	void updatePreference(Watcher *w, bool success) noexcept;
+	//Called by the resolver thread after a name lookup
+	static void onResolution(void *arg) noexcept;
 	//-----------------------------------------------------------------
 	//Check the stabilization response header
 	bool isValidStabilizationResponse(const Message *msg) const noexcept;
@@ -91,12 +112,45 @@ private:
 	void applyFlowControl(Message *message) noexcept;
 	//Generates a route for the given message
 	bool createRoute(Message *message) noexcept;
-	unsigned long long getNextHop(unsigned long long destination) const noexcept;
+	/*
+	 * Returns the next hop, consults the route cache first. If <direct> is true
+	 * then the one-hop route is preferred (if enabled and available).
+	 */
+	unsigned long long getNextHop(unsigned long long destination,
+			bool direct = false) noexcept;
 	bool allowCommunication(unsigned long long source,
 			unsigned long long destination) const noexcept;
 	//Checks the netmask
 	bool checkMask(unsigned long long source,
 			unsigned long long destination) const noexcept;
+	//Returns true if the client <uid> has presented a valid capability
+	bool isAuthorized(unsigned long long uid) const noexcept;
+	//Returns true if a direct overlay link to the hub <uid> is available
+	bool hasDirectLink(unsigned long long uid) const noexcept;
+	//Returns true if the request came from a neighbor's stabilizer directly
+	bool isPeerRequest(const Message *msg) const noexcept;
+	//-----------------------------------------------------------------
+	//Packs a small routed message into it's next hop's batch
+	bool batch(Message *message) noexcept;
+	//Forwards the expired (or all if <force> is true) batches
+	void flushBatches(bool force) noexcept;
+	//Forwards the pending batch of the next hop <id>
+	void flushBatch(unsigned long long id) noexcept;
+	//-----------------------------------------------------------------
+	/*
+	 * One-hop routing: full membership table disseminated through gossip
+	 */
+	//Merges a membership record, returns true if the table changed
+	bool updateMember(unsigned int key, unsigned int incarnation,
+			bool alive) noexcept;
+	//Rebuilds the root lookup table after a membership change
+	void indexMembers() noexcept;
+	//Returns true if <key> is an alive member (one-hop routing only)
+	bool isMember(unsigned int key) const noexcept;
+	//Returns true if the membership table agrees with the routing table
+	bool isConverged() noexcept;
+	//Establishes connections with the alive members (a few at a time)
+	void fixMembers() noexcept;
 	//-----------------------------------------------------------------
 	//Processes a direct request
 	bool process(Message *message) noexcept;
@@ -114,10 +168,13 @@ private:
 	bool handleGetKeyRequest(Message *msg) noexcept;
 	bool handleFindRootRequest(Message *msg) noexcept;
 	bool handleBootstrapRequest(Message *msg) noexcept;
+	bool handleAuthorizeRequest(Message *msg) noexcept;
 
 	bool handlePublishRequest(Message *msg) noexcept;
 	bool handleSubscribeRequest(Message *msg) noexcept;
 	bool handleUnsubscribeRequest(Message *msg) noexcept;
+	bool handleNamedSubscribeRequest(Message *msg) noexcept;
+	bool handleNamedUnsubscribeRequest(Message *msg) noexcept;
 
 	bool handleGetPredecessorRequest(Message *msg) noexcept;
 	bool handleSetPredecessorRequest(Message *msg) noexcept;
@@ -127,13 +184,100 @@ private:
 	bool handleSetFingerRequest(Message *msg) noexcept;
 	bool handleGetNeighboursRequest(Message *msg) noexcept;
 	bool handleNotifyRequest(Message *msg) noexcept;
+	bool handleGetMembersRequest(Message *msg) noexcept;
+	bool handleSetMembersRequest(Message *msg) noexcept;
 
 	bool handleFindSuccesssorRequest(Message *msg) noexcept;
 	bool handlePingNodeRequest(Message *msg) noexcept;
 	bool handleMapRequest(Message *msg) noexcept;
+	bool handleMapResponse(Message *msg) noexcept;
+	bool handleBatchRequest(Message *msg) noexcept;
+	bool handleSummaryRequest(Message *msg) noexcept;
+	bool handleMulticastRequest(Message *msg) noexcept;
+	//-----------------------------------------------------------------
+	//Distinct connected fingers inside (this node, <limit>), closest first
+	unsigned int getChildren(unsigned long long limit,
+			unsigned long long (&children)[TABLESIZE]) const noexcept;
 	//-----------------------------------------------------------------
-	//0: continue; 1: success/discontinue; -1: error/discontinue
-	int mapFunction(Message *msg) noexcept;
+	/*
+	 * Cross-hub multicast: the subscription summaries and the publications
+	 * travel down a tree formed by the finger tables. A publication enters a
+	 * subtree only if a hub inside it has matching subscribers.
+	 */
+	//Delivers a publication to the local subscribers, returns the count
+	unsigned int deliver(Message *msg) noexcept;
+	/*
+	 * Delivers a publication to the subscribers of a topic (or filter) which
+	 * accept it's data at the given <offset> inside the payload.
+	 */
+	unsigned int deliver(Message *msg, unsigned int offset,
+			const Topics &index, uint64_t topic, bool once) noexcept;
+	//Checks whether a subscriber should receive the publication
+	bool accepts(const Watcher *sub, const Message *msg,
+			const ContentFilter *content, unsigned int offset) const noexcept;
+	//Removes a connection's subscription to the given topic filter
+	void unsubscribe(Watcher *w, unsigned int filter) noexcept;
+	//Retains a publication as the last value of it's topic
+	bool store(Message *msg) noexcept;
+	//Sends the retained values to the new subscribers
+	void warmUp() noexcept;
+	//Delivers the stored messages to the reconnected clients
+	void drain() noexcept;
+	//Sends a batch of the stored messages, returns true if more are pending
+	bool unload(unsigned long long uid) noexcept;
+	//Forwards a publication to the subscribing hubs inside (this hub, <limit>)
+	unsigned int disseminate(const Message *msg,
+			unsigned long long limit) noexcept;
+	//Advertises this hub's subscriptions summary when required
+	void advertise() noexcept;
+	//Forwards the <owner>'s summary to the hubs inside (this hub, <limit>)
+	void spreadSummary(unsigned long long owner, const unsigned char *summary,
+			unsigned int size, unsigned long long limit) noexcept;
+	//Forgets the summaries which haven't been refreshed in time
+	void expireSummaries() noexcept;
+	//Adds a topic to the summary pointed to by <arg>
+	static int summarize(uint64_t topic, void *arg) noexcept;
+	/*
+	 * Extracts a multicast message's topic: the session identifier in the
+	 * classic form, leading 8 bytes of the payload in the extended form.
+	 */
+	static bool getTopic(const Message *msg, uint64_t &topic) noexcept;
+	/*
+	 * Extracts the topic name (or filter) of a message which carries the
+	 * <length> prefixed name at the start of the payload.
+	 */
+	static bool getTopicName(const Message *msg, const char *&name,
+			unsigned int &length) noexcept;
+	//Returns the offset of a publication's data inside the payload
+	static unsigned int getDataOffset(const Message *msg) noexcept;
+	/*
+	 * Compiles the content filter which starts at the given <offset> inside
+	 * a subscription request's payload (nullptr if there is no filter), fails
+	 * on invalid filter or memory allocation error.
+	 */
+	static bool createFilter(const Message *msg, unsigned int offset,
+			ContentFilter *&filter) noexcept;
+	//-----------------------------------------------------------------
+	/*
+	 * Ring-wide aggregation: the request is broadcast down a tree formed by
+	 * the finger tables, partial results are combined on the way back.
+	 */
+	//Forwards the request to the fingers inside (this node, <limit>)
+	//1: forwarded; 0: leaf node; -1: error (subtree unreachable)
+	int startMapJob(Message *msg, uint64_t local, uint64_t limit) noexcept;
+	//Sends the job's (partial) result to it's parent and releases it
+	void completeMapJob(unsigned int index) noexcept;
+	//Completes the timed out jobs with partial results
+	void expireMapJobs() noexcept;
+	//Builds the response in place (request's function and tag are retained)
+	void buildMapResponse(Message *msg, uint64_t result, unsigned int nodes,
+			bool partial, bool accepted) noexcept;
+	//Registers the built-in map functions
+	void installMapFunctions() noexcept;
+	static uint64_t mapNodes(void *hub, uint64_t arg) noexcept;
+	static uint64_t mapConnections(void *hub, uint64_t arg) noexcept;
+	static uint64_t mapSubscribers(void *hub, uint64_t arg) noexcept;
+	static uint64_t mapMessages(void *hub, uint64_t arg) noexcept;
 	/*
 	 * Builds a direct response header. Message's source is set to this hub's
 	 * identifier. If <length> isn't zero then the message length is updated.
@@ -144,6 +288,8 @@ private:
 	static unsigned int mapKey(unsigned long long key) noexcept;
 	//Returns the identifier associated with the given hash code
 	unsigned long long nonceToId(const Digest *hc) const noexcept;
+	//Returns the index key of the given nonce
+	static unsigned long long nonceKey(const Digest *hc) noexcept;
 	//Worker task's connection ID (hub's ID if no worker)
 	unsigned long long getWorkerId() const noexcept;
 	//Check whether the ID belongs to the worker task's connection
@@ -172,6 +318,8 @@ private:
 	Watcher* connect(int &sfd, bool blocking = false, int timeout = 0);
 	//Establish connection with the remote hub <id> asynchronously
 	Watcher* connect(unsigned long long id, Digest *hc);
+	//Connection attempt is slow and the other address family is available
+	bool isStalled(const Watcher *conn) noexcept;
 	/*
 	 * Creates an outgoing Socket connection to a remote node specified by <id>.
 	 * Returns a unique session identifier in <hc>.
@@ -215,18 +363,66 @@ private:
 		bool authenticateClient;
 		//If true, server will try to connect to the overlay network
 		bool connectToOverlay;
+		//If true, messages are routed directly to the root hub
+		bool oneHop;
 		//Frequency of Routing Table Update
 		unsigned int updateCycle;
+		//Bounds of the adaptive update cycle
+		unsigned int minUpdateCycle;
+		unsigned int maxUpdateCycle;
 		//Timeout for blocking I/O
 		unsigned int requestTimeout;
 		//Waiting period after stabilization error
 		unsigned int retryInterval;
+		//Number of latency probed nodes per finger (proximity selection)
+		unsigned int fingerCandidates;
+		//Suspicion level at which an unresponsive neighbor has failed
+		double suspicionThreshold;
+		//Period in milliseconds by which a neighbor can be late
+		unsigned int acceptablePause;
+		//Maximum size of a batched frame in bytes (0 to disable batching)
+		unsigned int batchFrameSize;
+		//Maximum time in microseconds a batch waits for more frames
+		unsigned int batchDelay;
+		//Maximum time in milliseconds a ring-wide aggregation can take
+		unsigned int mapTimeout;
+		//Minimum time in milliseconds between subscription advertisements
+		unsigned int summaryInterval;
+		//Memory in bytes for the retained publications (0 to disable)
+		unsigned long long retainedMemory;
+		//Retain the last value of each publisher instead of each topic
+		bool retainBySource;
+		//Size in bytes and number of the store-and-forward log's segments
+		unsigned int queueSegmentSize;
+		unsigned int queueSegments;
+		//Lifetime in seconds of a stored message
+		unsigned int queueTTL;
+		//Maximum number of messages stored for a client
+		unsigned int queueDepth;
+		//Maximum number of messages stored on behalf of a source
+		unsigned int queueQuota;
+		//Minimum time in milliseconds between the log's commits
+		unsigned int queueCommitInterval;
+		//Send the stabilization requests over the direct overlay links
+		bool bypassController;
+		//Shared key for verifying the clients' capabilities
+		char capabilityKey[128];
+		//Lifetime in seconds of the successful and failed name lookups
+		unsigned int dnsTTL;
+		unsigned int dnsNegativeTTL;
+		//Milliseconds before abandoning a connection attempt in favor of the other address family
+		unsigned int fallbackDelay;
 		//64-bit bitmask to restrict client<->client communication
 		unsigned long long netMask;
 		//Group ID of the hub
 		unsigned int groupId;
 		//Bootstrap nodes
 		unsigned long long bootstrapNodes[128];
+		//Hosts of the controller's replicas in the order of rank
+		unsigned long long controllers[8];
+		unsigned int replicas;
+		//Milliseconds on a standby replica before probing the primary again
+		unsigned int failbackInterval;
 	} ctx;
 	//-----------------------------------------------------------------
 	/*
@@ -238,6 +434,124 @@ private:
 		unsigned long long cache[NODECACHE_SIZE];
 	} nodes;
 	//-----------------------------------------------------------------
+	/*
+	 * Controller's replica in use, the consecutive failures, and the time
+	 * since the session with the replica got established.
+	 */
+	struct {
+		unsigned int rank;
+		unsigned int failures;
+		bool connected;
+		Timer timer;
+	} controller;
+	//-----------------------------------------------------------------
+	/*
+	 * Direct-mapped cache of the remote destinations' next hops. An entry is
+	 * valid only if it's version matches the routing table's version.
+	 */
+	static constexpr unsigned int ROUTECACHE_SIZE = 4096; //Must be power of 2
+	struct RouteEntry {
+		unsigned long long destination;
+		unsigned int version;
+		unsigned int next;
+	} routes[ROUTECACHE_SIZE];
+	//-----------------------------------------------------------------
+	/*
+	 * Membership table for the one-hop routing. Records are merged by
+	 * incarnation, a failure record wins over a live record of the same
+	 * incarnation. The key zero (0) is reserved for the controller.
+	 */
+	static constexpr unsigned int MEMBERS_CONNECT = 8;
+	struct {
+		//Incremented on every change
+		unsigned int version;
+		//Number of alive members
+		unsigned int count;
+		//Table's version and the routing table's version at the last check
+		unsigned int checked[2];
+		//Membership table agrees with the routing table
+		bool converged;
+		//Next member to connect to (round-robin)
+		unsigned int next;
+		//Connection attempts are made once per update cycle
+		Timer timer;
+		struct {
+			unsigned int incarnation;
+			bool alive;
+		} table[MAX_NODES];
+		//Root (first alive member at or after) of each key
+		unsigned short root[MAX_NODES];
+		//For authentication of the proxy connections
+		Digest sessions[MAX_NODES];
+		//Member key of each session, indexed by the nonce's leading bytes
+		Kmap<unsigned long long, unsigned int> nonces;
+	} members;
+	//-----------------------------------------------------------------
+	/*
+	 * Batches of small frames waiting for an overlay connection
+	 */
+	struct {
+		//Frames were batched in the current cycle
+		bool active;
+		struct {
+			unsigned long long id;
+			Message *msg;
+			Timer timer;
+		} slots[TABLESIZE];
+	} batches;
+	//-----------------------------------------------------------------
+	/*
+	 * Subscription summaries of the overlay hubs (cross-hub multicast)
+	 */
+	struct {
+		//Local subscriptions have changed since the last advertisement
+		bool dirty;
+		//Time of the last advertisement
+		Timer timer;
+		//Keys of the hubs which have a valid summary
+		unsigned int count;
+		unsigned short keys[MAX_NODES];
+		struct {
+			bool valid;
+			Timer timer;
+			TopicSummary filter;
+		} table[MAX_NODES];
+	} summaries;
+	//-----------------------------------------------------------------
+	/*
+	 * Ring-wide aggregation (map requests in progress)
+	 */
+	MapReduce mapReduce;
+	static constexpr unsigned int MAPJOBS_SIZE = 32;
+	struct MapJob {
+		//Identifies the job in the responses (0 if the slot is free)
+		unsigned int tag;
+		//Parent job's tag (0 at the entry point)
+		unsigned int parent;
+		//Request's header and origin (for the response)
+		MessageHeader header;
+		unsigned long long origin;
+		//Request's parameters
+		unsigned int function;
+		unsigned int timeout;
+		Timer timer;
+		//Combined result and the number of contributing nodes
+		uint64_t result;
+		unsigned int nodes;
+		bool partial;
+		//Outstanding requests to the children
+		unsigned int children;
+		unsigned int replies; //Bitmap
+		unsigned long long child[TABLESIZE];
+	};
+	static_assert((TABLESIZE <= 32), "Replies bitmap is too small");
+
+	struct {
+		unsigned int sequence;
+		unsigned int count;
+		MapJob jobs[MAPJOBS_SIZE];
+	} mapJobs;
+	//-----------------------------------------------------------------
 	/*
 	 * For authentication
 	 */
@@ -256,8 +570,9 @@ private:
 	 * [5]: SSL trusted certificate
 	 * [6]: SSL certificate
 	 * [7]: SSL host key
+	 * [8]: Hosts snapshot
 	 */
-	static constexpr unsigned int WATCHLIST_SIZE = 8;
+	static constexpr unsigned int WATCHLIST_SIZE = 9;
 	struct {
 		int context;
 		int identifier;
@@ -265,9 +580,47 @@ private:
 	} watchlist[WATCHLIST_SIZE];
 	//-----------------------------------------------------------------
 	/*
-	 * For multicasting: 256 topics in the range [0-255] are available
+	 * For multicasting: 64-bit topics (the classic topics are [0-255]),
+	 * and the hierarchical topic filters indexed by their identifiers.
 	 */
 	Topics topics;
+	TopicTrie filters;
+	Topics patterns;
+	//Subscribers which have received the current publication
+	Kset<void*> delivered;
+	//-----------------------------------------------------------------
+	/*
+	 * Retained publications: the new subscribers receive the last values in
+	 * the next cycle, after the subscription response has been queued.
+	 */
+	static constexpr unsigned int WARMUP_SIZE = 16;
+	LastValues values;
+	struct Warmup {
+		unsigned long long uid;
+		uint64_t topic;
+	};
+	struct {
+		ReadyList<Warmup> pending;
+		ReadyList<Warmup> ready;
+	} warmups;
+	//-----------------------------------------------------------------
+	/*
+	 * Store-and-forward queues of the disconnected clients. The stored
+	 * messages are delivered in batches, starting from the next cycle after
+	 * the registration response.
+	 */
+	static constexpr unsigned int DRAIN_SIZE = 32;
+	struct {
+		MessageLog log;
+		Timer timer;
+		ReadyList<unsigned long long> pending;
+		ReadyList<unsigned long long> ready;
+	} mailbox;
+	//-----------------------------------------------------------------
+	/*
+	 * Resolves the proxy connections' host names off the event loop
+	 */
+	Resolver resolver;
 	//-----------------------------------------------------------------
 	/*
 	 * TODO: This is an EXPERIMENTAL FEATURE.
@@ -30,6 +30,8 @@ void OverlayHubInfo::clear() noexcept {
 	successor = 0;
 	routes = 0;
 	stable = false;
+	updateCycle = 0;
+	fingers = 0;
 }
 
 unsigned long long OverlayHubInfo::getPredecessor() const noexcept {
@@ -64,6 +66,22 @@ void OverlayHubInfo::setStable(bool stable) noexcept {
 	this->stable = stable;
 }
 
+unsigned int OverlayHubInfo::getUpdateCycle() const noexcept {
+	return updateCycle;
+}
+
+void OverlayHubInfo::setUpdateCycle(unsigned int updateCycle) noexcept {
+	this->updateCycle = updateCycle;
+}
+
+unsigned int OverlayHubInfo::getFingerRefresh() const noexcept {
+	return fingers;
+}
+
+void OverlayHubInfo::setFingerRefresh(unsigned int fingers) noexcept {
+	this->fingers = fingers;
+}
+
 const RouteInfo* OverlayHubInfo::getRoute(unsigned int index) const noexcept {
 	if (index < routes) {
 		return &route[index];
@@ -94,6 +112,10 @@ unsigned int OverlayHubInfo::pack(unsigned char *buffer,
 	index += sizeof(uint32_t);
 	Serializer::packi8(buffer + index, isStable() ? 1 : 0);
 	index += sizeof(uint8_t);
+	Serializer::packi32(buffer + index, getUpdateCycle());
+	index += sizeof(uint32_t);
+	Serializer::packi32(buffer + index, getFingerRefresh());
+	index += sizeof(uint32_t);
 
 	for (unsigned int i = 0; i < getRoutes(); ++i) {
 		Serializer::packi64(buffer + index, getRoute(i)->start);
@@ -124,6 +146,10 @@ unsigned int OverlayHubInfo::unpack(const unsigned char *buffer,
 	index += sizeof(uint32_t);
 	setStable(Serializer::unpacku8(buffer + index));
 	index += sizeof(uint8_t);
+	setUpdateCycle(Serializer::unpacku32(buffer + index));
+	index += sizeof(uint32_t);
+	setFingerRefresh(Serializer::unpacku32(buffer + index));
+	index += sizeof(uint32_t);
 
 	if (size < MIN_BYTES + (25 * getRoutes())) {
 		return 0;
@@ -149,9 +175,10 @@ void OverlayHubInfo::print() const noexcept {
 	printf("\n------------------------------------------\n");
 	HubInfo::print();
 	printf("\n------------------------------------------\n");
-	printf("PREDECESSOR: %llu, SUCCESSOR: %llu\n\n"
+	printf("PREDECESSOR: %llu, SUCCESSOR: %llu\n"
+			"UPDATE CYCLE: %ums, FINGERS PER UPDATE: %u\n\n"
 			"ROUTING TABLE [STABLE: %s]\n", getPredecessor(), getSuccessor(),
-			WH_BOOLF(isStable()));
+			getUpdateCycle(), getFingerRefresh(), WH_BOOLF(isStable()));
 	printf(" SN    START  CURRENT  HISTORY   CONNECTED\n");
 
 	for (unsigned int i = 0; i < getRoutes(); i++) {
@@ -85,6 +85,29 @@ public:
 	 */
 	void setStable(bool stable) noexcept;
 	//-----------------------------------------------------------------
+	/**
+	 * Returns the stabilizer's current wait period between the routing
+	 * table's updates.
+	 * @return wait period in milliseconds (0 if the stabilizer is inactive)
+	 */
+	unsigned int getUpdateCycle() const noexcept;
+	/**
+	 * Sets the stabilizer's current wait period between the routing table's
+	 * updates.
+	 * @param updateCycle wait period in milliseconds
+	 */
+	void setUpdateCycle(unsigned int updateCycle) noexcept;
+	/**
+	 * Returns the number of fingers refreshed in each stabilization round.
+	 * @return fingers count
+	 */
+	unsigned int getFingerRefresh() const noexcept;
+	/**
+	 * Sets the number of fingers refreshed in each stabilization round.
+	 * @param fingers fingers count
+	 */
+	void setFingerRefresh(unsigned int fingers) noexcept;
+	//-----------------------------------------------------------------
 	/**
 	 * Returns a routing table entry.
 	 * @param index entry's index
@@ -121,7 +144,7 @@ public:
 	void print() const noexcept;
 public:
 	/** The minimum serialized data size in bytes */
-	static constexpr unsigned int MIN_BYTES = (HubInfo::BYTES + 21);
+	static constexpr unsigned int MIN_BYTES = (HubInfo::BYTES + 29);
 	/** The maximum serialized data size in bytes */
 	static constexpr unsigned int MAX_BYTES = MIN_BYTES
 			+ (25 * DHT::KEY_LENGTH);
@@ -130,6 +153,8 @@ private:
 	unsigned long long successor { 0 };
 	unsigned int routes { 0 };
 	bool stable { false };
+	unsigned int updateCycle { 0 };
+	unsigned int fingers { 0 };
 	RouteInfo route[DHT::KEY_LENGTH];
 };
 
@@ -74,8 +74,8 @@ unsigned int OverlayProtocol::processGetPredecessorResponse(
 	} else if (getPayloadLength() != sizeof(uint64_t)) {
 		return 0;
 	} else {
-		uint64_t v;
-		Serializer::unpack(payload(), (char*) "Q", &v);
+		uint64_t v = 0;
+		Layout<WireU64>::unpack(payload(), v);
 		key = v;
 		return header().getLength();
 	}
@@ -100,7 +100,7 @@ unsigned int OverlayProtocol::createSetPredecessorRequest(uint64_t host,
 	header().setContext(WH_DHT_CMD_NODE, WH_DHT_QLF_SETPREDECESSOR,
 			WH_DHT_AQLF_REQUEST);
 	packHeader();
-	Serializer::pack(payload(), "Q", key);
+	Layout<WireU64>::pack(payload(), key);
 	return header().getLength();
 }
 
@@ -111,8 +111,8 @@ unsigned int OverlayProtocol::processSetPredecessorResponse(
 	} else if (getPayloadLength() != sizeof(uint64_t)) {
 		return 0;
 	} else {
-		uint64_t v;
-		Serializer::unpack(payload(), (char*) "Q", &v);
+		uint64_t v = 0;
+		Layout<WireU64>::unpack(payload(), v);
 		if (v == key) {
 			return header().getLength();
 		} else {
@@ -148,8 +148,8 @@ unsigned int OverlayProtocol::processGetSuccessorResponse(
 	} else if (getPayloadLength() != sizeof(uint64_t)) {
 		return 0;
 	} else {
-		uint64_t v;
-		Serializer::unpack(payload(), (char*) "Q", &v);
+		uint64_t v = 0;
+		Layout<WireU64>::unpack(payload(), v);
 		key = v;
 		return header().getLength();
 	}
@@ -174,7 +174,7 @@ unsigned int OverlayProtocol::createSetSuccessorRequest(uint64_t host,
 	header().setContext(WH_DHT_CMD_NODE, WH_DHT_QLF_SETSUCCESSOR,
 			WH_DHT_AQLF_REQUEST);
 	packHeader();
-	Serializer::pack(payload(), "Q", key);
+	Layout<WireU64>::pack(payload(), key);
 	return header().getLength();
 }
 
@@ -186,7 +186,7 @@ unsigned int OverlayProtocol::processSetSuccessorResponse(
 		return 0;
 	} else {
 		uint64_t v = key;
-		Serializer::unpack(payload(), (char*) "Q", &v);
+		Layout<WireU64>::unpack(payload(), v);
 		if (v == key) {
 			return header().getLength();
 		} else {
@@ -214,7 +214,7 @@ unsigned int OverlayProtocol::createGetFingerRequest(uint64_t host,
 	header().setContext(WH_DHT_CMD_NODE, WH_DHT_QLF_GETFINGER,
 			WH_DHT_AQLF_REQUEST);
 	packHeader();
-	Serializer::pack(payload(), "L", index);
+	Layout<WireU32>::pack(payload(), index);
 	return header().getLength();
 }
 
@@ -227,7 +227,7 @@ unsigned int OverlayProtocol::processGetFingerResponse(uint32_t index,
 	} else {
 		uint32_t v0 = index;
 		uint64_t v1 = 0;
-		Serializer::unpack(payload(), (char*) "LQ", &v0, &v1);
+		Layout<WireU32, WireU64>::unpack(payload(), v0, v1);
 		if (v0 == index) {
 			key = v1;
 			return header().getLength();
@@ -259,7 +259,7 @@ unsigned int OverlayProtocol::createSetFingerRequest(uint64_t host,
 	header().setContext(WH_DHT_CMD_NODE, WH_DHT_QLF_SETFINGER,
 			WH_DHT_AQLF_REQUEST);
 	packHeader();
-	Serializer::pack(payload(), "LQ", index, key);
+	Layout<WireU32, WireU64>::pack(payload(), index, key);
 	return header().getLength();
 }
 
@@ -272,7 +272,7 @@ unsigned int OverlayProtocol::processSetFingerResponse(uint32_t index,
 	} else {
 		uint32_t v0 = index;
 		uint64_t v1 = key;
-		Serializer::unpack(payload(), (char*) "LQ", &v0, &v1);
+		Layout<WireU32, WireU64>::unpack(payload(), v0, v1);
 		if (v0 == index && v1 == key) {
 			return header().getLength();
 		} else {
@@ -309,8 +309,8 @@ unsigned int OverlayProtocol::processGetNeighboursResponse(
 	} else if (getPayloadLength() != (2 * sizeof(uint64_t))) {
 		return 0;
 	} else {
-		uint64_t v[2];
-		Serializer::unpack(payload(), (char*) "QQ", &v[0], &v[1]);
+		uint64_t v[2] = { 0, 0 };
+		Layout<WireU64, WireU64>::unpack(payload(), v[0], v[1]);
 		predecessor = v[0];
 		successor = v[1];
 		return header().getLength();
@@ -338,7 +338,7 @@ unsigned int OverlayProtocol::createNotifyRequest(uint64_t host,
 	header().setContext(WH_DHT_CMD_NODE, WH_DHT_QLF_NOTIFY,
 			WH_DHT_AQLF_REQUEST);
 	packHeader();
-	Serializer::pack(payload(), "Q", predecessor);
+	Layout<WireU64>::pack(payload(), predecessor);
 	return header().getLength();
 }
 
@@ -364,6 +364,102 @@ bool OverlayProtocol::notifyRequest(uint64_t host, uint64_t predecessor) {
 			&& processNotifyResponse();
 }
 
+unsigned int OverlayProtocol::createGetMembersRequest(uint64_t host,
+		uint32_t start) noexcept {
+	Packet::clear();
+	header().setAddress(getSource(), host);
+	header().setControl((HEADER_SIZE + sizeof(uint32_t)), nextSequenceNumber(),
+			getSession());
+	header().setContext(WH_DHT_CMD_NODE, WH_DHT_QLF_GETMEMBERS,
+			WH_DHT_AQLF_REQUEST);
+	packHeader();
+	Layout<WireU32>::pack(payload(), start);
+	return header().getLength();
+}
+
+unsigned int OverlayProtocol::processGetMembersResponse(uint32_t start,
+		uint64_t *records, uint32_t &count, uint32_t &next) const noexcept {
+	auto length = getPayloadLength();
+	if (!validate()) {
+		return 0;
+	} else if (!checkContext(WH_DHT_CMD_NODE, WH_DHT_QLF_GETMEMBERS)) {
+		return 0;
+	} else if (!records || length < 2 * sizeof(uint32_t)
+			|| ((length - 2 * sizeof(uint32_t)) % sizeof(uint64_t))
+			|| ((length - 2 * sizeof(uint32_t)) / sizeof(uint64_t))
+					> MEMBERS_PAGE) {
+		return 0;
+	} else {
+		uint32_t v[2] = { start, 0 };
+		Layout<WireU32, WireU32>::unpack(payload(), v[0], v[1]);
+		if (v[0] != start) {
+			return 0;
+		}
+
+		count = (length - 2 * sizeof(uint32_t)) / sizeof(uint64_t);
+		next = v[1];
+		for (unsigned int i = 0; i < count; ++i) {
+			records[i] = Serializer::unpacku64(
+					payload() + 2 * sizeof(uint32_t) + i * sizeof(uint64_t));
+		}
+		return header().getLength();
+	}
+}
+
+bool OverlayProtocol::getMembersRequest(uint64_t host, uint32_t start,
+		uint64_t *records, uint32_t &count, uint32_t &next) {
+	/*
+	 * HEADER: SRC=0, DEST=X, ....CMD=3, QLF=8, AQLF=0/1/127
+	 * BODY: 4 bytes as <start> in Request; 4 bytes as <start> + 4 bytes
+	 * as <next> + 8*N bytes as <records> in Response
+	 * TOTAL: 32+4=36 bytes in Request; 32+8+8*N bytes in Response
+	 */
+	return createGetMembersRequest(host, start) && executeRequest()
+			&& processGetMembersResponse(start, records, count, next);
+}
+
+unsigned int OverlayProtocol::createSetMembersRequest(uint64_t host,
+		const uint64_t *records, uint32_t count) noexcept {
+	if (!records || count > MEMBERS_PAGE) {
+		return 0;
+	}
+
+	Packet::clear();
+	header().setAddress(getSource(), host);
+	header().setControl((HEADER_SIZE + count * sizeof(uint64_t)),
+			nextSequenceNumber(), getSession());
+	header().setContext(WH_DHT_CMD_NODE, WH_DHT_QLF_SETMEMBERS,
+			WH_DHT_AQLF_REQUEST);
+	packHeader();
+	for (unsigned int i = 0; i < count; ++i) {
+		Serializer::packi64(payload() + i * sizeof(uint64_t), records[i]);
+	}
+	return header().getLength();
+}
+
+unsigned int OverlayProtocol::processSetMembersResponse() const noexcept {
+	if (!validate()) {
+		return 0;
+	} else if (!checkContext(WH_DHT_CMD_NODE, WH_DHT_QLF_SETMEMBERS)) {
+		return 0;
+	} else if (header().getLength() != HEADER_SIZE) {
+		return 0;
+	} else {
+		return header().getLength();
+	}
+}
+
+bool OverlayProtocol::setMembersRequest(uint64_t host, const uint64_t *records,
+		uint32_t count) {
+	/*
+	 * HEADER: SRC=0, DEST=X, ....CMD=3, QLF=9, AQLF=0/1/127
+	 * BODY: 8*N bytes as <records> in Request; 0 bytes in Response
+	 * TOTAL: 32+8*N bytes in Request; 32 bytes in Response
+	 */
+	return createSetMembersRequest(host, records, count) && executeRequest()
+			&& processSetMembersResponse();
+}
+
 unsigned int OverlayProtocol::createFindSuccessorRequest(uint64_t host,
 		uint64_t uid) noexcept {
 	Packet::clear();
@@ -373,7 +469,7 @@ unsigned int OverlayProtocol::createFindSuccessorRequest(uint64_t host,
 	header().setContext(WH_DHT_CMD_OVERLAY, WH_DHT_QLF_FINDSUCCESSOR,
 			WH_DHT_AQLF_REQUEST);
 	packHeader();
-	Serializer::pack(payload(), "Q", uid);
+	Layout<WireU64>::pack(payload(), uid);
 	return header().getLength();
 }
 
@@ -385,7 +481,7 @@ unsigned int OverlayProtocol::processFindSuccessorResponse(uint64_t uid,
 		return 0;
 	} else {
 		uint64_t v[2] = { uid, 0 };
-		Serializer::unpack(payload(), (char*) "QQ", &v[0], &v[1]);
+		Layout<WireU64, WireU64>::unpack(payload(), v[0], v[1]);
 		if (v[0] == uid) {
 			successor = v[1];
 			return header().getLength();
@@ -437,33 +533,62 @@ bool OverlayProtocol::pingRequest(uint64_t host) {
 	return createPingRequest(host) && executeRequest() && processPingRequest();
 }
 
-unsigned int OverlayProtocol::createMapRequest(uint64_t host) noexcept {
+unsigned int OverlayProtocol::createMapRequest(uint64_t host,
+		uint32_t function, uint64_t argument) noexcept {
 	Packet::clear();
 	header().setAddress(getSource(), host);
-	header().setControl(HEADER_SIZE, nextSequenceNumber(), getSession());
+	header().setControl((HEADER_SIZE + MapRequest::SIZE), nextSequenceNumber(),
+			getSession());
 	header().setContext(WH_DHT_CMD_OVERLAY, WH_DHT_QLF_MAP,
 			WH_DHT_AQLF_REQUEST);
 	packHeader();
+	//Limit, tag and timeout are assigned by the overlay
+	MapRequest::pack(payload(), argument, 0ULL, function, 0U, 0U);
 	return header().getLength();
 }
 
-unsigned int OverlayProtocol::processMapRequest() const noexcept {
+unsigned int OverlayProtocol::processMapRequest(uint64_t &result,
+		uint32_t &nodes, bool &partial) const noexcept {
 	if (!validate()) {
 		return 0;
 	} else if (!checkContext(WH_DHT_CMD_OVERLAY, WH_DHT_QLF_MAP)) {
 		return 0;
+	} else if (getPayloadLength() != MapResult::SIZE) {
+		return 0;
 	} else {
+		uint64_t r = 0;
+		uint32_t n = 0, p = 0, function = 0, tag = 0;
+		MapResult::unpack(payload(), r, n, p, function, tag);
+		result = r;
+		nodes = n;
+		partial = p;
 		return header().getLength();
 	}
 }
 
-bool OverlayProtocol::mapRequest(uint64_t host) {
+bool OverlayProtocol::mapRequest(uint64_t host, uint32_t function,
+		uint64_t argument, uint64_t &result, uint32_t &nodes, bool &partial) {
 	/*
 	 * HEADER: SRC=0, DEST=X, ....CMD=4, QLF=2, AQLF=0/1/127
-	 * BODY: variable in Request; variable in Response
-	 * TOTAL: at least 32 bytes in Request and Response
+	 * BODY: 28 bytes as <argument, limit, function, tag, timeout> in Request;
+	 * 24 bytes as <result, nodes, partial, function, tag> in Response
+	 * TOTAL: 32+28=60 bytes in Request; 32+24=56 bytes in Response
 	 */
-	return createMapRequest(host) && executeRequest() && processMapRequest();
+	return createMapRequest(host, function, argument) && executeRequest()
+			&& processMapRequest(result, nodes, partial);
+}
+
+uint64_t OverlayProtocol::toMemberRecord(uint32_t key, uint32_t incarnation,
+		bool alive) noexcept {
+	return (((uint64_t) incarnation) << 32) | (alive ? 0x80000000UL : 0)
+			| (key & 0x7fffffffUL);
+}
+
+void OverlayProtocol::fromMemberRecord(uint64_t record, uint32_t &key,
+		uint32_t &incarnation, bool &alive) noexcept {
+	key = (uint32_t) (record & 0x7fffffffUL);
+	incarnation = (uint32_t) (record >> 32);
+	alive = (record & 0x80000000UL);
 }
 
 } /* namespace wanhive */
@@ -12,6 +12,7 @@
 
 #ifndef WH_SERVER_OVERLAY_OVERLAYPROTOCOL_H_
 #define WH_SERVER_OVERLAY_OVERLAYPROTOCOL_H_
+#include "../../base/ds/Layout.h"
 #include "../../hub/Protocol.h"
 #include "OverlayHubInfo.h"
 
@@ -247,6 +248,67 @@ public:
 	 */
 	bool notifyRequest(uint64_t host, uint64_t predecessor);
 	//-----------------------------------------------------------------
+	/**
+	 * Creates a get-members request to fetch a page of a host's membership
+	 * table (see OverlayProtocol::MEMBERS_PAGE).
+	 * @param host host's identifier
+	 * @param start the page's first key
+	 * @return message length on success, 0 on error
+	 */
+	unsigned int createGetMembersRequest(uint64_t host, uint32_t start) noexcept;
+	/**
+	 * Processes the response to a get-members request to fetch a page of a
+	 * host's membership table.
+	 * @param start the page's first key
+	 * @param records stores the membership records (should be large enough to
+	 * hold OverlayProtocol::MEMBERS_PAGE records).
+	 * @param count stores the number of records
+	 * @param next stores the next page's first key (0 if this was the last page)
+	 * @return message length on success, 0 on error
+	 */
+	unsigned int processGetMembersResponse(uint32_t start, uint64_t *records,
+			uint32_t &count, uint32_t &next) const noexcept;
+	/**
+	 * Prepares and executes a get-members request to fetch a page of a host's
+	 * membership table.
+	 * @param host host's identifier
+	 * @param start the page's first key
+	 * @param records stores the membership records (should be large enough to
+	 * hold OverlayProtocol::MEMBERS_PAGE records).
+	 * @param count stores the number of records
+	 * @param next stores the next page's first key (0 if this was the last page)
+	 * @return true on success, false on error (request denied by the host)
+	 */
+	bool getMembersRequest(uint64_t host, uint32_t start, uint64_t *records,
+			uint32_t &count, uint32_t &next);
+	//-----------------------------------------------------------------
+	/**
+	 * Creates a set-members request to merge the membership records into a
+	 * host's membership table.
+	 * @param host host's identifier
+	 * @param records membership records
+	 * @param count number of records (at most OverlayProtocol::MEMBERS_PAGE)
+	 * @return message length on success, 0 on error
+	 */
+	unsigned int createSetMembersRequest(uint64_t host, const uint64_t *records,
+			uint32_t count) noexcept;
+	/**
+	 * Processes the response to a set-members request to merge the membership
+	 * records into a host's membership table.
+	 * @return message length on success, 0 on error
+	 */
+	unsigned int processSetMembersResponse() const noexcept;
+	/**
+	 * Prepares and executes a set-members request to merge the membership
+	 * records into a host's membership table.
+	 * @param host host's identifier
+	 * @param records membership records
+	 * @param count number of records (at most OverlayProtocol::MEMBERS_PAGE)
+	 * @return true on success, false on error (request denied by the host)
+	 */
+	bool setMembersRequest(uint64_t host, const uint64_t *records,
+			uint32_t count);
+	//-----------------------------------------------------------------
 	/**
 	 * Creates a find-successor request to recursively find a key's successor.
 	 * @param host bootstrap node's identifier
@@ -293,22 +355,63 @@ public:
 	bool pingRequest(uint64_t host);
 	//-----------------------------------------------------------------
 	/**
-	 * Creates a map request.
+	 * Creates a map (ring-wide aggregation) request.
 	 * @param host entry point's identifier
+	 * @param function map function's identifier
+	 * @param argument map function's argument
 	 * @return message length on success, 0 on error
 	 */
-	unsigned int createMapRequest(uint64_t host) noexcept;
+	unsigned int createMapRequest(uint64_t host, uint32_t function,
+			uint64_t argument) noexcept;
 	/**
 	 * Processes the response to a map request.
+	 * @param result stores the aggregated result
+	 * @param nodes stores the number of contributing nodes
+	 * @param partial stores true if some nodes didn't respond in time
 	 * @return message length on success, 0 on error
 	 */
-	unsigned int processMapRequest() const noexcept;
+	unsigned int processMapRequest(uint64_t &result, uint32_t &nodes,
+			bool &partial) const noexcept;
 	/**
-	 * Prepares and executes a map request.
+	 * Prepares and executes a map (ring-wide aggregation) request.
 	 * @param host entry point's identifier
+	 * @param function map function's identifier
+	 * @param argument map function's argument
+	 * @param result stores the aggregated result
+	 * @param nodes stores the number of contributing nodes
+	 * @param partial stores true if some nodes didn't respond in time
 	 * @return true on success, false on error (request denied by the host)
 	 */
-	bool mapRequest(uint64_t host);
+	bool mapRequest(uint64_t host, uint32_t function, uint64_t argument,
+			uint64_t &result, uint32_t &nodes, bool &partial);
+	//-----------------------------------------------------------------
+	/**
+	 * Encodes a membership record: bits [0-30] store the key, bit 31 is set if
+	 * the member is alive, bits [32-63] store the member's incarnation.
+	 * @param key member's key
+	 * @param incarnation member's incarnation (zero (0) stands for the latest
+	 * incarnation known to the recipient).
+	 * @param alive true if the member is alive, false otherwise
+	 * @return encoded record
+	 */
+	static uint64_t toMemberRecord(uint32_t key, uint32_t incarnation,
+			bool alive) noexcept;
+	/**
+	 * Decodes a membership record (see OverlayProtocol::toMemberRecord()).
+	 * @param record encoded record
+	 * @param key stores the member's key
+	 * @param incarnation stores the member's incarnation
+	 * @param alive stores true if the member is alive, false otherwise
+	 */
+	static void fromMemberRecord(uint64_t record, uint32_t &key,
+			uint32_t &incarnation, bool &alive) noexcept;
+public:
+	/** Maximum number of records in a membership table's page */
+	static constexpr unsigned int MEMBERS_PAGE = 64;
+	/** Map request's payload: <argument, limit, function, tag, timeout> */
+	using MapRequest = Layout<WireU64, WireU64, WireU32, WireU32, WireU32>;
+	/** Map response's payload: <result, nodes, partial, function, tag> */
+	using MapResult = Layout<WireU64, WireU32, WireU32, WireU32, WireU32>;
 };
 
 } /* namespace wanhive */
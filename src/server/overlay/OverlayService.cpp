@@ -11,8 +11,11 @@
  */
 
 #include "OverlayService.h"
+#include "../../base/common/Atomic.h"
 #include "../../base/common/Exception.h"
 #include "../../base/common/Logger.h"
+#include "../../base/Timer.h"
+#include "../../base/ds/Twiddler.h"
 #include <cstring>
 
 namespace wanhive {
@@ -27,18 +30,26 @@ OverlayService::~OverlayService() {
 }
 
 void OverlayService::configure(int connection, const unsigned long long *nodes,
-		unsigned int updateCycle, unsigned int retryInterval) noexcept {
+		unsigned int updateCycle, unsigned int retryInterval,
+		unsigned int candidates, bool gossip, double threshold,
+		unsigned int pause, unsigned int minCycle,
+		unsigned int maxCycle) noexcept {
 	cleanup();
 	setConnection(connection);
 	setBootstrapNodes(nodes);
-	setUpdateCycle(updateCycle);
+	setUpdateCycle(updateCycle, minCycle, maxCycle);
 	setRetryInterval(retryInterval);
+	setCandidates(candidates);
+	setGossip(gossip);
+	setDetector(threshold, pause);
 }
 
 void OverlayService::periodic() noexcept {
 	try {
 		while (true) {
-			auto delay = execute() ? ctx.updateCycle : ctx.retryInterval;
+			auto success = execute();
+			adapt(success);
+			auto delay = success ? pace.period : ctx.retryInterval;
 			if (wait(delay)) {
 				break;
 			}
@@ -77,7 +88,12 @@ bool OverlayService::execute() {
 			return false;
 		}
 
-		//STEP 5: success
+		//STEP 5: Spread the membership information (failure is not fatal)
+		if (!gossip(uid)) {
+			WH_LOG_DEBUG("Membership gossip failed");
+		}
+
+		//STEP 6: success
 		return true;
 	} catch (const BaseException &e) {
 		WH_LOG_EXCEPTION(e);
@@ -109,6 +125,14 @@ void OverlayService::cleanup() noexcept {
 	clear();
 }
 
+unsigned int OverlayService::getUpdateCycle() const noexcept {
+	return Atomic<>::load(&pace.period);
+}
+
+unsigned int OverlayService::getFingerRefresh() const noexcept {
+	return Atomic<>::load(&pace.fingers);
+}
+
 void OverlayService::setup() {
 	try {
 		if (!uid || initialized) {
@@ -147,9 +171,19 @@ void OverlayService::setup() {
 void OverlayService::clear() noexcept {
 	sIndex = 0;
 	fIndex = 0;
+	gIndex = 0;
+	gStart = 0;
 	controllerFailed = false;
 	initialized = false;
 	memset(successors, 0, sizeof(successors));
+	latencies.clear();
+	detector.clear();
+	detector.setThreshold(0);
+	Atomic<>::store(&pace.period, 0U);
+	Atomic<>::store(&pace.fingers, 0U);
+	pace.events = 0;
+	pace.predecessor = 0;
+	pace.successor = 0;
 	memset(&ctx, 0, sizeof(ctx));
 	ctx.connection = -1;
 }
@@ -194,12 +228,38 @@ bool OverlayService::bootstrap() noexcept {
 
 bool OverlayService::isReachable(uint64_t id) noexcept {
 	try {
-		return pingRequest(id);
+		Timer t;
+		if (pingRequest(id)) {
+			heartbeat(id);
+			sample(id, t);
+			return true;
+		} else {
+			return false;
+		}
 	} catch (...) {
 		return false;
 	}
 }
 
+void OverlayService::heartbeat(uint64_t id) noexcept {
+	//Ignore the local hub and the controller
+	if (id && id != uid) {
+		detector.heartbeat(id);
+	}
+}
+
+bool OverlayService::isFailed(uint64_t id, const Timer &t) noexcept {
+	//The request's timeout is not a part of the inter-arrival time
+	detector.miss(id, t.elapsed() * Timer::MILS_IN_SEC);
+	if (detector.isSuspected(id)) {
+		return true;
+	} else {
+		WH_LOG_DEBUG("Node %llu is unresponsive (phi: %.2f)", id,
+				detector.phi(id));
+		return false;
+	}
+}
+
 bool OverlayService::join(uint64_t id, uint64_t startNode) noexcept {
 	try {
 		uint64_t successor = 0;
@@ -235,14 +295,28 @@ bool OverlayService::checkPredecessor(uint64_t id) {
 		uint64_t predecessor = 0;
 		if (!getPredecessorRequest(id, predecessor)) {
 			return false;
-		} else if (!predecessor) {
+		} else if (observe(pace.predecessor, predecessor)) {
+			//Predecessor has joined or failed
+			churn();
+		}
+
+		if (!predecessor) {
 			//HACK: checking the controller
 			return checkController(id);
-		} else if (isReachable(predecessor)) {
+		}
+
+		Timer t;
+		if (isReachable(predecessor)) {
 			//Predecessor is alive
 			return true;
+		} else if (!isFailed(predecessor, t)) {
+			//Predecessor is suspected, wait for more evidence
+			return true;
 		} else if (checkController(id)) {
 			//Predecessor has failed
+			detector.remove(predecessor);
+			latencies.removeKey(predecessor);
+			reportFailure(id, predecessor);
 			return setPredecessorRequest(id, 0);
 		} else {
 			//Controller failure
@@ -255,17 +329,24 @@ bool OverlayService::checkPredecessor(uint64_t id) {
 }
 
 bool OverlayService::stabilize(uint64_t id) {
+	uint64_t successor = 0;
+	Timer t;
 	try {
-		uint64_t successor;
 		if (!getSuccessorRequest(id, successor)) {
 			return false;
+		} else if (observe(pace.successor, successor)) {
+			churn();
 		}
 		//-----------------------------------------------------------------
 		uint64_t sPredecessor = 0; //predecessor of the current successor
 		uint64_t sSuccessor = 0; //successor of the current successor
 		//Get the neighbors of the current successor
+		t.now();
 		if (!getNeighboursRequest(successor, sPredecessor, sSuccessor)) {
 			return false;
+		} else {
+			heartbeat(successor);
+			sample(successor, t);
 		}
 		//-----------------------------------------------------------------
 		//Stabilize the local node
@@ -291,12 +372,30 @@ bool OverlayService::stabilize(uint64_t id) {
 		return true;
 	} catch (const BaseException &e) {
 		WH_LOG_EXCEPTION(e);
+		if (successor && successor != id && !isFailed(successor, t)) {
+			//Successor is suspected, retry in the next cycle
+			return true;
+		}
 		//Stabilization failed, try to recover
+		detector.remove(successor);
+		latencies.removeKey(successor);
 		return repairSuccessor(id);
 	}
 }
 
 bool OverlayService::fixFingerTable(uint64_t id) noexcept {
+	auto n = Twiddler::min(Twiddler::max(pace.fingers, 1), Node::TABLESIZE);
+	for (unsigned int i = 0; i < n; ++i) {
+		if (!fixFinger(id)) {
+			//Failed lookup
+			churn();
+			return false;
+		}
+	}
+	return true;
+}
+
+bool OverlayService::fixFinger(uint64_t id) noexcept {
 	try {
 		fIndex = (fIndex + 1) % Node::TABLESIZE;
 		uint64_t start = Node::successor(id, fIndex);
@@ -307,17 +406,119 @@ bool OverlayService::fixFingerTable(uint64_t id) noexcept {
 			return false;
 		} else if (!findSuccessorRequest(target, start, key)) {
 			return false;
-		} else if (!setFingerRequest(id, fIndex, key)) {
-			return false;
-		} else {
-			return true;
 		}
+
+		auto finger = selectFinger(id, fIndex, key);
+		Timer t;
+		if (fIndex && finger != id && !isReachable(finger)
+				&& isFailed(finger, t)) {
+			//Don't route through the failed node until the ring repairs itself
+			detector.remove(finger);
+			latencies.removeKey(finger);
+			finger = id;
+		}
+		return setFingerRequest(id, fIndex, finger);
 	} catch (const BaseException &e) {
 		WH_LOG_EXCEPTION(e);
 		return false;
 	}
 }
 
+uint64_t OverlayService::selectFinger(uint64_t id, unsigned int index,
+		uint64_t key) noexcept {
+	//The immediate successor must always be exact
+	if (!index || index >= Node::TABLESIZE || ctx.candidates < 2) {
+		return key;
+	}
+	//-----------------------------------------------------------------
+	//Finger's interval: [id + 2^index, id + 2^(index+1))
+	auto first = Node::successor(id, index);
+	auto last = Node::predecessor(
+			(index + 1 < Node::TABLESIZE) ? Node::successor(id, index + 1) : id,
+			0);
+	if (key == id || !Node::isInRange(key, first, last)) {
+		return key;
+	}
+	//-----------------------------------------------------------------
+	/*
+	 * Walk the first few nodes inside the interval, starting with <key>. The
+	 * walk's own requests double as the latency probes, no pings are added.
+	 */
+	auto best = key;
+	auto found = false;
+	try {
+		auto node = key;
+		for (unsigned int i = 0; i < ctx.candidates; ++i) {
+			Timer t;
+			uint64_t next = 0;
+			auto walked = getSuccessorRequest(node, next);
+			if (walked) {
+				sample(node, t);
+			}
+
+			if (latencies.contains(node)
+					&& (!found || getLatency(node) < getLatency(best))) {
+				best = node;
+				found = true;
+			}
+
+			if (!walked || next == node || next == key
+					|| !Node::isInRange(next, first, last)) {
+				break;
+			}
+
+			node = next;
+		}
+		//-----------------------------------------------------------------
+		/*
+		 * Hysteresis: retain the current finger unless the best candidate is
+		 * at least 25% faster to prevent route flapping.
+		 */
+		uint64_t current = 0;
+		if (found && getFingerRequest(id, index, current) && current != best
+				&& current != id && Node::isInRange(current, first, last)
+				&& latencies.contains(current)
+				&& (4 * getLatency(best) > 3 * getLatency(current))) {
+			best = current;
+		}
+	} catch (const BaseException &e) {
+		WH_LOG_EXCEPTION(e);
+	}
+
+	return found ? best : key;
+}
+
+void OverlayService::sample(uint64_t id, const Timer &t) noexcept {
+	/*
+	 * The hub labels a response with the overlay link it arrived on. Samples
+	 * taken through the controller measure the controller's path instead of
+	 * the node's, hence they are discarded.
+	 */
+	if (!id || id == uid || header().getLabel() != id) {
+		return;
+	}
+
+	auto rtt = (unsigned int) (t.elapsed() * Timer::MS_IN_SEC);
+	int ret = 0;
+	auto i = latencies.put(id, ret);
+	if (i == latencies.end()) {
+		return;
+	} else if (ret == 0) {
+		//Smoothed estimate: srtt = 7/8 * srtt + 1/8 * sample
+		unsigned int srtt = 0;
+		latencies.getValue(i, srtt);
+		latencies.setValue(i, (unsigned int) ((7ULL * srtt + rtt) >> 3));
+	} else {
+		latencies.setValue(i, rtt);
+	}
+}
+
+unsigned int OverlayService::getLatency(uint64_t id) const noexcept {
+	unsigned int srtt = 0;
+	latencies.hmGet(id, srtt);
+	return srtt;
+}
+
 bool OverlayService::fixSuccessorsList(uint64_t id) noexcept {
 	try {
 		if (SUCCESSOR_LIST_LEN > 1) {
@@ -365,15 +566,123 @@ bool OverlayService::repairSuccessor(uint64_t id) {
 }
 
 bool OverlayService::checkController(uint64_t id) {
+	if (isReachable(0)) {
+		return true;
+	}
+
+	//Ask for maintenance, the hub may switch to a standby controller
+	pingRequest(id);
 	if (isReachable(0)) {
 		return true;
 	} else {
 		controllerFailed = true;
-		pingRequest(id);
 		return false;
 	}
 }
 
+bool OverlayService::gossip(uint64_t id) noexcept {
+	if (!ctx.gossip) {
+		return true;
+	}
+
+	//The successor and the fingers are contacted in round-robin order
+	uint64_t peer = 0;
+	auto answered = false;
+	Timer t;
+	try {
+		if (!getFingerRequest(id, gIndex, peer)) {
+			return false;
+		} else if (!peer || peer == id) {
+			nextPeer();
+			return true;
+		}
+		//-----------------------------------------------------------------
+		uint64_t records[MEMBERS_PAGE];
+		uint32_t count = 0;
+		uint32_t next = 0;
+		t.now();
+		if (!getMembersRequest(peer, gStart, records, count, next)) {
+			nextPeer();
+			return false;
+		}
+
+		heartbeat(peer);
+		answered = true;
+		if (count && !setMembersRequest(id, records, count)) {
+			return false;
+		} else if (next) {
+			//Continue with the next page in the next cycle
+			gStart = next;
+			return true;
+		} else {
+			nextPeer();
+			return true;
+		}
+	} catch (const BaseException &e) {
+		//Invalidate the unresponsive finger across the ring
+		if (peer && peer != id && !answered && isFailed(peer, t)) {
+			detector.remove(peer);
+			latencies.removeKey(peer);
+			reportFailure(id, peer);
+		}
+		nextPeer();
+		return false;
+	}
+}
+
+bool OverlayService::reportFailure(uint64_t id, uint64_t failed) noexcept {
+	if (!ctx.gossip) {
+		return true;
+	}
+
+	try {
+		//Zero incarnation: the recipient's latest known incarnation
+		auto record = toMemberRecord(failed, 0, false);
+		return setMembersRequest(id, &record, 1);
+	} catch (const BaseException &e) {
+		return false;
+	}
+}
+
+void OverlayService::nextPeer() noexcept {
+	gIndex = (gIndex + 1) % Node::TABLESIZE;
+	gStart = 0;
+}
+
+void OverlayService::churn() noexcept {
+	++pace.events;
+}
+
+bool OverlayService::observe(uint64_t &last, uint64_t current) noexcept {
+	auto changed = (last != current);
+	last = current;
+	return changed;
+}
+
+void OverlayService::adapt(bool success) noexcept {
+	auto period = pace.period;
+	auto fingers = pace.fingers;
+	if (!success || pace.events) {
+		period /= 2;
+		fingers *= 2;
+	} else {
+		period += Twiddler::max(period / 4, 1);
+		fingers /= 2;
+	}
+
+	period = Twiddler::min(Twiddler::max(period, ctx.minCycle), ctx.maxCycle);
+	fingers = Twiddler::min(Twiddler::max(fingers, 1), Node::TABLESIZE);
+	if (period != pace.period) {
+		WH_LOG_DEBUG("Stabilization period: %ums, fingers per round: %u",
+				period, fingers);
+	}
+
+	pace.events = 0;
+	detector.setPeriod(period);
+	Atomic<>::store(&pace.period, period);
+	Atomic<>::store(&pace.fingers, fingers);
+}
+
 void OverlayService::setConnection(int connection) noexcept {
 	ctx.connection = connection;
 }
@@ -387,12 +696,30 @@ void OverlayService::setBootstrapNodes(const unsigned long long *nodes) noexcept
 	ctx.nodes[i] = 0;
 }
 
-void OverlayService::setUpdateCycle(unsigned int updateCycle) noexcept {
+void OverlayService::setUpdateCycle(unsigned int updateCycle,
+		unsigned int minCycle, unsigned int maxCycle) noexcept {
 	ctx.updateCycle = updateCycle;
+	ctx.minCycle = (minCycle && minCycle < updateCycle) ? minCycle : updateCycle;
+	ctx.maxCycle = (maxCycle > updateCycle) ? maxCycle : updateCycle;
+	detector.setPeriod(updateCycle);
+	Atomic<>::store(&pace.period, updateCycle);
+	Atomic<>::store(&pace.fingers, 1U);
 }
 
 void OverlayService::setRetryInterval(unsigned int retryInterval) noexcept {
 	ctx.retryInterval = retryInterval;
 }
 
+void OverlayService::setCandidates(unsigned int candidates) noexcept {
+	ctx.candidates = candidates;
+}
+
+void OverlayService::setGossip(bool gossip) noexcept {
+	ctx.gossip = gossip;
+}
+
+void OverlayService::setDetector(double threshold, unsigned int pause) noexcept {
+	detector.setThreshold(threshold, pause);
+}
+
 } /* namespace wanhive */
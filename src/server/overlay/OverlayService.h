@@ -12,9 +12,12 @@
 
 #ifndef WH_SERVER_OVERLAY_OVERLAYSERVICE_H_
 #define WH_SERVER_OVERLAY_OVERLAYSERVICE_H_
+#include "FailureDetector.h"
 #include "Node.h"
 #include "OverlayProtocol.h"
+#include "../../base/Timer.h"
 #include "../../base/TurnGate.h"
+#include "../../base/ds/Khash.h"
 
 namespace wanhive {
 /**
@@ -41,9 +44,28 @@ public:
 	 * requests.
 	 * @param retryInterval wait period in milliseconds before recovery after
 	 * a temporary stabilization/network error.
+	 * @param candidates maximum number of nodes inside a finger's interval
+	 * which are compared by latency during the finger table's repair, set to
+	 * zero (0) or one (1) to disable the proximity based finger selection.
+	 * Latency is sampled only over the direct overlay links, i.e. when the
+	 * stabilization requests bypass the controller.
+	 * @param gossip true to disseminate the membership table (required by the
+	 * one-hop routing), false otherwise.
+	 * @param threshold suspicion level (phi) at which an unresponsive
+	 * neighbor is declared failed, set to zero (0) to declare failure at the
+	 * first unanswered request.
+	 * @param pause period in milliseconds by which a neighbor can be late
+	 * without raising the suspicion.
+	 * @param minCycle lower bound of the adaptive wait period in milliseconds
+	 * between stabilization requests (zero for the update cycle).
+	 * @param maxCycle upper bound of the adaptive wait period in milliseconds
+	 * between stabilization requests (zero for the update cycle).
 	 */
 	void configure(int connection, const unsigned long long *nodes,
-			unsigned int updateCycle, unsigned int retryInterval) noexcept;
+			unsigned int updateCycle, unsigned int retryInterval,
+			unsigned int candidates = 0, bool gossip = false,
+			double threshold = 0, unsigned int pause = 0,
+			unsigned int minCycle = 0, unsigned int maxCycle = 0) noexcept;
 	//-----------------------------------------------------------------
 	/**
 	 * Executes stabilization routines periodically until a notification (see
@@ -72,6 +94,19 @@ public:
 	 * Cleans up the internal structures to prevent resource leak.
 	 */
 	void cleanup() noexcept;
+	//-----------------------------------------------------------------
+	/**
+	 * Returns the current wait period between stabilization requests (can be
+	 * called from any thread).
+	 * @return wait period in milliseconds
+	 */
+	unsigned int getUpdateCycle() const noexcept;
+	/**
+	 * Returns the number of fingers refreshed in each stabilization round
+	 * (can be called from any thread).
+	 * @return fingers count
+	 */
+	unsigned int getFingerRefresh() const noexcept;
 private:
 	//-----------------------------------------------------------------
 	//Sets things up
@@ -85,6 +120,11 @@ private:
 	//-----------------------------------------------------------------
 	//Checks whether the remote node <id> is reachable or not
 	bool isReachable(uint64_t id) noexcept;
+	//Records a response from the remote node <id>
+	void heartbeat(uint64_t id) noexcept;
+	//Returns true if the unresponsive node <id> should be declared failed,
+	//<t> measures the time spent on the failed exchange
+	bool isFailed(uint64_t id, const Timer &t) noexcept;
 	//Join as node identified by <id> using the <startNode>
 	bool join(uint64_t id, uint64_t startNode) noexcept;
 	//Check the predecessor of the node identified by <id>
@@ -93,6 +133,15 @@ private:
 	bool stabilize(uint64_t id);
 	//Fix the finger table for the node identified by <id>
 	bool fixFingerTable(uint64_t id) noexcept;
+	//Fix the next finger of the node identified by <id>, a failed finger is
+	//replaced by the node itself
+	bool fixFinger(uint64_t id) noexcept;
+	//Select the lowest latency node from the <index>th finger's interval
+	uint64_t selectFinger(uint64_t id, unsigned int index, uint64_t key) noexcept;
+	//Update the round trip time estimate of <id> from the last response
+	void sample(uint64_t id, const Timer &t) noexcept;
+	//Returns the smoothed round trip time to the node <id> in microseconds
+	unsigned int getLatency(uint64_t id) const noexcept;
 	//-----------------------------------------------------------------
 	//Periodically update the successors list for the node <id>
 	bool fixSuccessorsList(uint64_t id) noexcept;
@@ -101,10 +150,28 @@ private:
 	//Check the controller's connection through the node <id>
 	bool checkController(uint64_t id);
 	//-----------------------------------------------------------------
+	//Pull a page of membership records from a neighbor of the node <id>
+	bool gossip(uint64_t id) noexcept;
+	//Report the failure of the node <failed> to the node <id>
+	bool reportFailure(uint64_t id, uint64_t failed) noexcept;
+	//Move on to the next neighbor for gossip
+	void nextPeer() noexcept;
+	//-----------------------------------------------------------------
+	//Records a change in the ring's membership
+	void churn() noexcept;
+	//Records the current neighbor, returns true if it has changed
+	bool observe(uint64_t &last, uint64_t current) noexcept;
+	//Adjusts the wait period and the fingers' refresh rate
+	void adapt(bool success) noexcept;
+	//-----------------------------------------------------------------
 	void setConnection(int connection) noexcept;
 	void setBootstrapNodes(const unsigned long long *nodes) noexcept;
-	void setUpdateCycle(unsigned int updateCycle) noexcept;
+	void setUpdateCycle(unsigned int updateCycle, unsigned int minCycle,
+			unsigned int maxCycle) noexcept;
 	void setRetryInterval(unsigned int retryInterval) noexcept;
+	void setCandidates(unsigned int candidates) noexcept;
+	void setGossip(bool gossip) noexcept;
+	void setDetector(double threshold, unsigned int pause) noexcept;
 private:
 	//Identifier of the hub
 	const unsigned long long uid;
@@ -112,6 +179,10 @@ private:
 	unsigned int sIndex;
 	//Next finger to fix
 	unsigned int fIndex;
+	//Finger which is the current gossip peer
+	unsigned int gIndex;
+	//First key of the next membership table's page to pull
+	uint32_t gStart;
 	//Set to true if connection with controller failed
 	bool controllerFailed;
 	//Initialization status
@@ -127,6 +198,31 @@ private:
 			Node::KEYLENGTH > 1 ? Node::KEYLENGTH - 1 : 1);
 	uint64_t successors[SUCCESSOR_LIST_LEN];
 	//-----------------------------------------------------------------
+	/*
+	 * Smoothed round trip time estimates (in microseconds) of the nodes which
+	 * answered over a direct overlay link (proximity neighbor selection).
+	 */
+	Kmap<uint64_t, unsigned int> latencies;
+	//-----------------------------------------------------------------
+	/*
+	 * Heartbeats are the responses of the neighbors to the stabilization
+	 * requests, no additional messages are exchanged.
+	 */
+	FailureDetector detector;
+	//-----------------------------------------------------------------
+	/*
+	 * The wait period shrinks by half and the fingers' refresh rate doubles
+	 * after a round which observes churn, both relax gradually otherwise.
+	 * The current values are readable by other threads.
+	 */
+	struct {
+		unsigned int period;
+		unsigned int fingers;
+		unsigned int events;
+		uint64_t predecessor;
+		uint64_t successor;
+	} pace;
+	//-----------------------------------------------------------------
 	/*
 	 * Configuration parameters: no shared states with the outside world except
 	 * the socket connection.
@@ -138,8 +234,15 @@ private:
 		int connection;
 		//Wait period in milliseconds between routing table updates
 		unsigned int updateCycle;
+		//Bounds of the adaptive wait period in milliseconds
+		unsigned int minCycle;
+		unsigned int maxCycle;
 		//Wait period in milliseconds after stabilization error
 		unsigned int retryInterval;
+		//Number of nodes probed for latency inside a finger's interval
+		unsigned int candidates;
+		//Disseminate the membership table
+		bool gossip;
 	} ctx;
 };
 
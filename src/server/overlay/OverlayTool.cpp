@@ -704,8 +704,24 @@ void OverlayTool::pingCmd() {
 void OverlayTool::mapCmd() {
 	std::cout << "CMD: [MAP]" << std::endl;
 	uint64_t id = destinationId;
+	unsigned int function = 0;
+	unsigned long long argument = 0;
+	std::cout
+			<< "Function (0: nodes, 1: connections, 2: subscribers, 3: messages): ";
+	std::cin >> function;
+	std::cout << "Argument: ";
+	std::cin >> argument;
+	if (CommandLine::inputError()) {
+		return;
+	}
+
 	try {
-		if (mapRequest(id)) {
+		uint64_t result = 0;
+		uint32_t nodes = 0;
+		bool partial = false;
+		if (mapRequest(id, function, argument, result, nodes, partial)) {
+			std::cout << "RESULT: " << result << ", NODES: " << nodes
+					<< (partial ? " (PARTIAL)" : "") << std::endl;
 			std::cout << "MAP SUCCEEDED" << std::endl;
 		} else {
 			std::cout << "MAP FAILED" << std::endl;
@@ -0,0 +1,135 @@
+/*
+ * TopicSummary.cpp
+ *
+ * Compact summary of a hub's subscriptions
+ *
+ *
+ * Copyright (C) 2025 Wanhive Systems Private Limited (info@wanhive.com)
+ * This program is part of the Wanhive IoT Platform.
+ * Check the COPYING file for the license.
+ *
+ */
+
+#include "TopicSummary.h"
+#include "../../base/ds/Twiddler.h"
+#include <cstring>
+#include <new>
+
+namespace wanhive {
+
+TopicSummary::TopicSummary() noexcept {
+
+}
+
+TopicSummary::~TopicSummary() {
+	delete[] bits;
+}
+
+bool TopicSummary::reset(unsigned int topics) noexcept {
+	//Smallest multiple of MIN_SIZE which holds BITS_PER_TOPIC for each topic
+	auto n = ((unsigned long long) topics * BITS_PER_TOPIC + 7) / 8;
+	n = ((n + MIN_SIZE - 1) / MIN_SIZE) * MIN_SIZE;
+	n = (n < MIN_SIZE) ? MIN_SIZE : ((n > MAX_SIZE) ? MAX_SIZE : n);
+	if (resize(n)) {
+		clear();
+		return true;
+	} else {
+		return false;
+	}
+}
+
+void TopicSummary::insert(uint64_t topic) noexcept {
+	if (!bytes) {
+		return;
+	}
+	//Double hashing: h1 + i*h2 (h2 is odd)
+	auto h = Twiddler::mix((unsigned long long) topic);
+	auto h1 = (unsigned int) h;
+	auto h2 = ((unsigned int) (h >> 32)) | 1;
+	auto m = bytes * 8;
+	for (unsigned int i = 0; i < HASHES; ++i) {
+		Twiddler::set(bits, (h1 + i * h2) % m);
+	}
+}
+
+bool TopicSummary::test(uint64_t topic) const noexcept {
+	if (full) {
+		return true;
+	} else if (!bytes) {
+		return false;
+	}
+
+	auto h = Twiddler::mix((unsigned long long) topic);
+	auto h1 = (unsigned int) h;
+	auto h2 = ((unsigned int) (h >> 32)) | 1;
+	auto m = bytes * 8;
+	for (unsigned int i = 0; i < HASHES; ++i) {
+		if (!Twiddler::test(bits, (h1 + i * h2) % m)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool TopicSummary::isEmpty() const noexcept {
+	if (full) {
+		return false;
+	}
+
+	for (unsigned int i = 0; i < bytes; ++i) {
+		if (bits[i]) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void TopicSummary::clear() noexcept {
+	full = false;
+	if (bits) {
+		memset(bits, 0, bytes);
+	}
+}
+
+const unsigned char* TopicSummary::data() const noexcept {
+	return bits;
+}
+
+unsigned int TopicSummary::size() const noexcept {
+	return bytes;
+}
+
+bool TopicSummary::load(const unsigned char *data, unsigned int size) noexcept {
+	if (!data || !isValid(size) || !resize(size)) {
+		full = true;
+		return false;
+	} else {
+		full = false;
+		memcpy(bits, data, size);
+		return true;
+	}
+}
+
+bool TopicSummary::isValid(unsigned int size) noexcept {
+	return size && size <= MAX_SIZE && !(size % MIN_SIZE);
+}
+
+bool TopicSummary::resize(unsigned int size) noexcept {
+	if (size == bytes) {
+		return true;
+	}
+
+	delete[] bits;
+	bytes = 0;
+	if ((bits = new (std::nothrow) unsigned char[size])) {
+		bytes = size;
+		return true;
+	} else {
+		full = true;
+		return false;
+	}
+}
+
+} /* namespace wanhive */
@@ -0,0 +1,111 @@
+/*
+ * TopicSummary.h
+ *
+ * Compact summary of a hub's subscriptions
+ *
+ *
+ * Copyright (C) 2025 Wanhive Systems Private Limited (info@wanhive.com)
+ * This program is part of the Wanhive IoT Platform.
+ * Check the COPYING file for the license.
+ *
+ */
+
+#ifndef WH_SERVER_OVERLAY_TOPICSUMMARY_H_
+#define WH_SERVER_OVERLAY_TOPICSUMMARY_H_
+#include "../../base/common/NonCopyable.h"
+#include <cstdint>
+
+namespace wanhive {
+/**
+ * Bloom filter over the topic space. Summarizes the topics which have at
+ * least one subscriber at a hub. False positives are possible, false
+ * negatives are not. The filter is sized from the number of topics, past the
+ * maximum size the false positive rate grows gradually.
+ */
+class TopicSummary: private NonCopyable {
+public:
+	/**
+	 * Default constructor: creates an empty summary.
+	 */
+	TopicSummary() noexcept;
+	/**
+	 * Destructor
+	 */
+	~TopicSummary();
+	//-----------------------------------------------------------------
+	/**
+	 * Clears the summary and sizes it for the given number of topics.
+	 * @param topics expected number of topics
+	 * @return true on success, false on memory allocation error (the summary
+	 * then matches every topic).
+	 */
+	bool reset(unsigned int topics) noexcept;
+	/**
+	 * Adds a topic to the summary.
+	 * @param topic topic's identifier
+	 */
+	void insert(uint64_t topic) noexcept;
+	/**
+	 * Tests whether a topic (probably) belongs to the summary.
+	 * @param topic topic's identifier
+	 * @return true if the topic probably belongs to the summary, false if it
+	 * definitely doesn't.
+	 */
+	bool test(uint64_t topic) const noexcept;
+	/**
+	 * Checks whether the summary is empty.
+	 * @return true if no topic has been added, false otherwise
+	 */
+	bool isEmpty() const noexcept;
+	/**
+	 * Removes all the topics.
+	 */
+	void clear() noexcept;
+	//-----------------------------------------------------------------
+	/**
+	 * Returns the summary's serialized form.
+	 * @return pointer to the bit array (TopicSummary::size() bytes), nullptr
+	 * if the summary doesn't have one.
+	 */
+	const unsigned char* data() const noexcept;
+	/**
+	 * Returns the size of the summary's serialized form.
+	 * @return size in bytes, zero (0) if the summary doesn't have one
+	 */
+	unsigned int size() const noexcept;
+	/**
+	 * Loads the summary from it's serialized form (see TopicSummary::data()).
+	 * @param data pointer to the serialized summary
+	 * @param size serialized summary's size in bytes
+	 * @return true on success, false on error (invalid size or memory
+	 * allocation error, the summary then matches every topic).
+	 */
+	bool load(const unsigned char *data, unsigned int size) noexcept;
+	/**
+	 * Checks whether a serialized summary can have the given size.
+	 * @param size size in bytes
+	 * @return true if the size is valid, false otherwise
+	 */
+	static bool isValid(unsigned int size) noexcept;
+public:
+	/** Serialized summaries are multiples of this size (in bytes) */
+	static constexpr unsigned int MIN_SIZE = 64;
+	/** Maximum size of a serialized summary in bytes */
+	static constexpr unsigned int MAX_SIZE = 15 * MIN_SIZE;
+	/** Number of bits reserved per topic */
+	static constexpr unsigned int BITS_PER_TOPIC = 10;
+	/** Number of bits set per topic */
+	static constexpr unsigned int HASHES = 3;
+private:
+	//Reallocates the bit array if required, contents are not preserved
+	bool resize(unsigned int size) noexcept;
+private:
+	unsigned char *bits { nullptr };
+	unsigned int bytes { 0 };
+	//Matches every topic
+	bool full { false };
+};
+
+} /* namespace wanhive */
+
+#endif /* WH_SERVER_OVERLAY_TOPICSUMMARY_H_ */
@@ -0,0 +1,312 @@
+/*
+ * TopicTrie.cpp
+ *
+ * Hierarchical topic filters
+ *
+ *
+ * Copyright (C) 2025 Wanhive Systems Private Limited (info@wanhive.com)
+ * This program is part of the Wanhive IoT Platform.
+ * Check the COPYING file for the license.
+ *
+ */
+
+#include "TopicTrie.h"
+#include "../../base/common/Memory.h"
+#include <cstring>
+
+namespace {
+
+constexpr char SEPARATOR = '/';
+constexpr char SINGLE_LEVEL = '+';
+constexpr char MULTI_LEVEL = '#';
+
+//Returns the length of the level starting at <s>
+unsigned int levelLength(const char *s, unsigned int length) noexcept {
+	unsigned int i = 0;
+	while (i < length && s[i] != SEPARATOR) {
+		++i;
+	}
+	return i;
+}
+
+}  // namespace
+
+namespace wanhive {
+
+TopicTrie::TopicTrie() noexcept :
+		nodes { nullptr }, size { 0 }, limit { 0 }, spare { 0 }, filters { 0 },
+		generation { 1 } {
+	memset(cache, 0, sizeof(cache));
+	memset(&matches, 0, sizeof(matches));
+	memset(frontier, 0, sizeof(frontier));
+	Memory<Node>::append(nodes, size, limit,
+			{ 0, 0, true, false, 0, nullptr }); //The root
+}
+
+TopicTrie::~TopicTrie() {
+	for (unsigned int i = 0; i < limit; ++i) {
+		Memory<char>::free(nodes[i].level);
+	}
+	Memory<Node>::free(nodes);
+	Memory<unsigned int>::free(matches.data);
+	Memory<unsigned int>::free(frontier[0].data);
+	Memory<unsigned int>::free(frontier[1].data);
+}
+
+unsigned int TopicTrie::insert(const char *filter,
+		unsigned int length) noexcept {
+	if (!isFilter(filter, length)) {
+		return 0;
+	}
+
+	unsigned int id = 0;
+	for (unsigned int i = 0;; ++i) {
+		auto len = levelLength(filter + i, length - i);
+		auto child = step(id, filter + i, len);
+		auto hash = Twiddler::wyHash(filter + i, len);
+		if (child) {
+			id = child;
+		} else if (edges.contains( { id, hash })) {
+			//Hash collision between the distinct levels
+			prune(id);
+			return 0;
+		} else {
+			id = create(id, filter + i, len);
+		}
+
+		i += len;
+		if (i == length) {
+			break;
+		}
+	}
+
+	if (!nodes[id].terminal) {
+		nodes[id].terminal = true;
+		++filters;
+		invalidate();
+	}
+	return id;
+}
+
+unsigned int TopicTrie::find(const char *filter,
+		unsigned int length) const noexcept {
+	if (!isFilter(filter, length)) {
+		return 0;
+	}
+
+	unsigned int id = 0;
+	for (unsigned int i = 0;; ++i) {
+		auto len = levelLength(filter + i, length - i);
+		if (!(id = step(id, filter + i, len))) {
+			return 0;
+		}
+
+		i += len;
+		if (i == length) {
+			break;
+		}
+	}
+
+	return nodes[id].terminal ? id : 0;
+}
+
+void TopicTrie::remove(unsigned int id) noexcept {
+	if (id && id < limit && nodes[id].used && nodes[id].terminal) {
+		nodes[id].terminal = false;
+		--filters;
+		invalidate();
+		prune(id);
+	}
+}
+
+unsigned int TopicTrie::match(const char *name, unsigned int length,
+		const unsigned int *&ids) noexcept {
+	ids = nullptr;
+	if (!isName(name, length)) {
+		return 0;
+	}
+
+	auto &entry = cache[Twiddler::wyHash(name, length) & (CACHE_SIZE - 1)];
+	if (entry.generation == generation && entry.length == length
+			&& !memcmp(entry.name, name, length)) {
+		ids = entry.ids;
+		return entry.count;
+	}
+	//-----------------------------------------------------------------
+	auto count = search(name, length);
+	ids = matches.data;
+	if (count <= CACHED_MATCHES) {
+		//The large results are not cached
+		entry.generation = generation;
+		entry.length = length;
+		memcpy(entry.name, name, length);
+		entry.count = count;
+		memcpy(entry.ids, matches.data, count * sizeof(unsigned int));
+	}
+	return count;
+}
+
+unsigned int TopicTrie::count() const noexcept {
+	return filters;
+}
+
+void TopicTrie::clear() noexcept {
+	for (unsigned int i = 1; i < limit; ++i) {
+		Memory<char>::free(nodes[i].level);
+	}
+
+	limit = 1; //Keep the root
+	nodes[0].children = 0;
+	nodes[0].terminal = false;
+	spare = 0;
+	edges.clear();
+	filters = 0;
+	invalidate();
+}
+
+bool TopicTrie::isName(const char *name, unsigned int length) noexcept {
+	if (!name || !length || length > MAX_LENGTH) {
+		return false;
+	}
+
+	for (unsigned int i = 0; i < length; ++i) {
+		if (name[i] == SINGLE_LEVEL || name[i] == MULTI_LEVEL) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool TopicTrie::isFilter(const char *filter, unsigned int length) noexcept {
+	if (!filter || !length || length > MAX_LENGTH) {
+		return false;
+	}
+
+	for (unsigned int i = 0;; ++i) {
+		auto len = levelLength(filter + i, length - i);
+		for (unsigned int j = i; j < i + len; ++j) {
+			if ((filter[j] == SINGLE_LEVEL || filter[j] == MULTI_LEVEL)
+					&& len != 1) {
+				return false;
+			}
+		}
+
+		i += len;
+		if (i == length) {
+			return true;
+		} else if (len == 1 && filter[i - 1] == MULTI_LEVEL) {
+			return false;
+		}
+	}
+}
+
+unsigned int TopicTrie::step(unsigned int parent, const char *level,
+		unsigned int length) const noexcept {
+	unsigned int child = 0;
+	if (edges.hmGet( { parent, Twiddler::wyHash(level, length) }, child)
+			&& nodes[child].length == length
+			&& !memcmp(nodes[child].level, level, length)) {
+		return child;
+	} else {
+		return 0;
+	}
+}
+
+unsigned int TopicTrie::create(unsigned int parent, const char *level,
+		unsigned int length) noexcept {
+	auto text = Memory<char>::allocate(length + 1);
+	memcpy(text, level, length);
+
+	Node node { parent, 0, true, false, length, text };
+	unsigned int id;
+	if ((id = spare)) {
+		spare = nodes[id].parent;
+		nodes[id] = node;
+	} else {
+		id = limit;
+		Memory<Node>::append(nodes, size, limit, node);
+	}
+
+	edges.hmPut( { parent, Twiddler::wyHash(level, length) }, id);
+	nodes[parent].children += 1;
+	return id;
+}
+
+void TopicTrie::prune(unsigned int id) noexcept {
+	while (id && !nodes[id].terminal && !nodes[id].children) {
+		auto &node = nodes[id];
+		auto parent = node.parent;
+		edges.removeKey(
+				{ parent, Twiddler::wyHash(node.level, node.length) });
+		Memory<char>::free(node.level);
+		node = { spare, 0, false, false, 0, nullptr };
+		spare = id;
+
+		nodes[parent].children -= 1;
+		id = parent;
+	}
+}
+
+unsigned int TopicTrie::search(const char *name, unsigned int length) noexcept {
+	matches.limit = 0;
+	auto add = [this](unsigned int id) {
+		if (id && nodes[id].terminal) {
+			Memory<unsigned int>::append(matches.data, matches.size,
+					matches.limit, id);
+		}
+	};
+
+	//Nodes reached by the levels consumed so far
+	auto current = &frontier[0];
+	auto next = &frontier[1];
+	current->limit = 0;
+	Memory<unsigned int>::append(current->data, current->size, current->limit,
+			0);
+
+	for (unsigned int i = 0; current->limit; ++i) {
+		auto len = levelLength(name + i, length - i);
+		next->limit = 0;
+		for (unsigned int k = 0; k < current->limit; ++k) {
+			auto id = current->data[k];
+			//'#' matches all the remaining levels
+			add(step(id, &MULTI_LEVEL, 1));
+
+			auto exact = step(id, name + i, len);
+			if (exact) {
+				Memory<unsigned int>::append(next->data, next->size,
+						next->limit, exact);
+			}
+
+			auto any = step(id, &SINGLE_LEVEL, 1);
+			if (any) {
+				Memory<unsigned int>::append(next->data, next->size,
+						next->limit, any);
+			}
+		}
+
+		auto swap = current;
+		current = next;
+		next = swap;
+
+		i += len;
+		if (i == length) {
+			break;
+		}
+	}
+	//-----------------------------------------------------------------
+	//'#' also matches the parent level
+	for (unsigned int k = 0; k < current->limit; ++k) {
+		add(current->data[k]);
+		add(step(current->data[k], &MULTI_LEVEL, 1));
+	}
+	return matches.limit;
+}
+
+void TopicTrie::invalidate() noexcept {
+	if (++generation == 0) {
+		memset(cache, 0, sizeof(cache));
+		generation = 1;
+	}
+}
+
+} /* namespace wanhive */
@@ -0,0 +1,179 @@
+/*
+ * TopicTrie.h
+ *
+ * Hierarchical topic filters
+ *
+ *
+ * Copyright (C) 2025 Wanhive Systems Private Limited (info@wanhive.com)
+ * This program is part of the Wanhive IoT Platform.
+ * Check the COPYING file for the license.
+ *
+ */
+
+#ifndef WH_SERVER_OVERLAY_TOPICTRIE_H_
+#define WH_SERVER_OVERLAY_TOPICTRIE_H_
+#include "../../base/ds/Khash.h"
+#include "../../base/ds/Twiddler.h"
+#include <cstdint>
+
+namespace wanhive {
+/**
+ * Subscription trie for the hierarchical topic names. A topic name consists
+ * of levels separated by '/', for example "site/7/temperature". A topic
+ * filter can additionally contain the single-level wildcard '+' and the
+ * multi-level wildcard '#' (the last level only) which also matches the
+ * parent level, for example "site/+/temperature" and "fleet/42/#". Each
+ * distinct filter is assigned a non-zero identifier. Matching cost is
+ * proportional to the depth of the topic name, the recent results are
+ * cached for the frequently published topics.
+ */
+class TopicTrie {
+public:
+	/** Maximum length of a topic name or filter in bytes */
+	static constexpr unsigned int MAX_LENGTH = 255;
+	/** Maximum number of filters inside a cached match result */
+	static constexpr unsigned int CACHED_MATCHES = 32;
+	/** Number of cached match results */
+	static constexpr unsigned int CACHE_SIZE = 64;
+	//-----------------------------------------------------------------
+	/**
+	 * Default constructor: initializes an empty trie.
+	 */
+	TopicTrie() noexcept;
+	/**
+	 * Destructor
+	 */
+	~TopicTrie();
+	//-----------------------------------------------------------------
+	/**
+	 * Adds a topic filter to the trie.
+	 * @param filter topic filter (need not be nul-terminated)
+	 * @param length filter's length in bytes
+	 * @return filter's identifier on success (existing identifier if the
+	 * filter is already present), 0 on error (invalid filter).
+	 */
+	unsigned int insert(const char *filter, unsigned int length) noexcept;
+	/**
+	 * Returns the identifier of an existing topic filter.
+	 * @param filter topic filter (need not be nul-terminated)
+	 * @param length filter's length in bytes
+	 * @return filter's identifier on success, 0 if not found
+	 */
+	unsigned int find(const char *filter, unsigned int length) const noexcept;
+	/**
+	 * Removes a topic filter from the trie.
+	 * @param id filter's identifier
+	 */
+	void remove(unsigned int id) noexcept;
+	/**
+	 * Finds the filters which match a topic name.
+	 * @param name topic name (need not be nul-terminated)
+	 * @param length name's length in bytes
+	 * @param ids stores the identifiers of the matching filters, valid until
+	 * the next call to this method or the trie's modification.
+	 * @return number of matching filters
+	 */
+	unsigned int match(const char *name, unsigned int length,
+			const unsigned int *&ids) noexcept;
+	/**
+	 * Returns the number of filters inside the trie.
+	 * @return filters count
+	 */
+	unsigned int count() const noexcept;
+	/**
+	 * Removes all the filters.
+	 */
+	void clear() noexcept;
+	//-----------------------------------------------------------------
+	/**
+	 * Validates a topic name: non-empty, bounded length, no wildcards.
+	 * @param name topic name
+	 * @param length name's length in bytes
+	 * @return true if the name is valid, false otherwise
+	 */
+	static bool isName(const char *name, unsigned int length) noexcept;
+	/**
+	 * Validates a topic filter: non-empty, bounded length, a wildcard must
+	 * occupy the entire level and '#' can appear only at the last level.
+	 * @param filter topic filter
+	 * @param length filter's length in bytes
+	 * @return true if the filter is valid, false otherwise
+	 */
+	static bool isFilter(const char *filter, unsigned int length) noexcept;
+private:
+	//Returns the child of <parent> at the given level, 0 if not found
+	unsigned int step(unsigned int parent, const char *level,
+			unsigned int length) const noexcept;
+	//Creates a child of <parent> at the given level
+	unsigned int create(unsigned int parent, const char *level,
+			unsigned int length) noexcept;
+	//Removes the unused nodes starting from <id> towards the root
+	void prune(unsigned int id) noexcept;
+	//Walks the trie (matching cost is proportional to the name's depth)
+	unsigned int search(const char *name, unsigned int length) noexcept;
+	//Invalidates the cached match results
+	void invalidate() noexcept;
+
+	//Trie's node, the level is stored out of line
+	struct Node {
+		//Next recycled node if unused
+		unsigned int parent;
+		unsigned int children;
+		bool used;
+		bool terminal;
+		unsigned int length;
+		char *level;
+	};
+
+	//Parent-child relationship
+	struct Edge {
+		unsigned int parent;
+		uint64_t hash;
+	};
+
+	struct HFN {
+		unsigned int operator()(const Edge &e) const noexcept {
+			return Twiddler::mix((unsigned long long) e.parent) ^ e.hash;
+		}
+	};
+
+	struct EQFN {
+		bool operator()(const Edge &e1, const Edge &e2) const noexcept {
+			return e1.parent == e2.parent && e1.hash == e2.hash;
+		}
+	};
+
+	//Cached result of a match
+	struct Match {
+		unsigned int generation;
+		unsigned int length;
+		unsigned int count;
+		unsigned int ids[CACHED_MATCHES];
+		char name[MAX_LENGTH];
+	};
+
+	//Dynamically resizable array
+	struct Buffer {
+		unsigned int *data;
+		unsigned int size;
+		unsigned int limit;
+	};
+
+	Node *nodes;
+	unsigned int size;
+	unsigned int limit;
+	//Head of the recycled nodes' list (0 if empty)
+	unsigned int spare;
+	Kmap<Edge, unsigned int, HFN, EQFN> edges;
+	unsigned int filters;
+	//Invalidates the cached results on modification
+	unsigned int generation;
+	Match cache[CACHE_SIZE];
+	//Search results and the search's frontiers (current and next)
+	Buffer matches;
+	Buffer frontier[2];
+};
+
+} /* namespace wanhive */
+
+#endif /* WH_SERVER_OVERLAY_TOPICTRIE_H_ */
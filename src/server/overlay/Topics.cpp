@@ -12,6 +12,11 @@
 
 #include "Topics.h"
 
+namespace {
+//Initial capacity of the per-topic and per-watcher lists
+constexpr unsigned int LIST_SIZE = 4;
+}  // namespace
+
 namespace wanhive {
 
 Topics::Topics() noexcept {
@@ -19,79 +24,199 @@ Topics::Topics() noexcept {
 }
 
 Topics::~Topics() {
-
+	clear();
 }
 
-bool Topics::put(unsigned int topic, const Watcher *w) noexcept {
-	if ((topic >= Topic::COUNT) || !w) {
+bool Topics::put(uint64_t topic, const Watcher *w,
+		ContentFilter *filter) noexcept {
+	if (!w) {
+		delete filter;
 		return false;
 	}
 
 	int ret = 0;
 	auto i = indexes.put( { w, topic }, ret);
-	if (ret) { //Key was not present
-		//Elements are always added at the list's end
-		auto index = topics[topic].readSpace();
-		indexes.setValue(i, index);
-		topics[topic].put(w);
-		return true;
-	} else { //Key was already present
+	if (i == indexes.end()) {
+		delete filter;
+		return false;
+	} else if (!ret) { //Key was already present, replace the filter
+		Subscribers *subscribers = nullptr;
+		topics.hmGet(topic, subscribers);
+		auto entry = subscribers->get(indexes.getValueReference(i)->topic);
+		delete entry->filter;
+		entry->filter = filter;
 		return true;
 	}
+	//-----------------------------------------------------------------
+	//Get (or create) the lists, elements are always added at the end
+	Subscribers *subscribers = nullptr;
+	if (!topics.hmGet(topic, subscribers)) {
+		subscribers = new Subscribers(LIST_SIZE);
+		topics.hmPut(topic, subscribers);
+	}
+
+	Subscriptions *subscriptions = nullptr;
+	if (!watchers.hmGet(w, subscriptions)) {
+		subscriptions = new Subscriptions(LIST_SIZE);
+		watchers.hmPut(w, subscriptions);
+	}
+
+	indexes.setValue(i,
+			{ subscribers->readSpace(), subscriptions->readSpace() });
+	subscribers->put( { w, filter });
+	subscriptions->put(topic);
+	return true;
+}
+
+Watcher* Topics::get(uint64_t topic, unsigned int index) const noexcept {
+	const ContentFilter *filter;
+	return get(topic, index, filter);
 }
 
-Watcher* Topics::get(unsigned int topic, unsigned int index) const noexcept {
-	const Watcher *w = nullptr;
-	if ((topic < Topic::COUNT) && topics[topic].get(w, index)) {
-		return const_cast<Watcher*>(w);
+Watcher* Topics::get(uint64_t topic, unsigned int index,
+		const ContentFilter *&filter) const noexcept {
+	Subscribers *subscribers = nullptr;
+	Subscriber s { nullptr, nullptr };
+	if (topics.hmGet(topic, subscribers) && subscribers->get(s, index)) {
+		filter = s.filter;
+		return const_cast<Watcher*>(s.w);
 	} else {
+		filter = nullptr;
 		return nullptr;
 	}
 }
 
-void Topics::remove(unsigned int topic, const Watcher *w) noexcept {
-	if ((topic >= Topic::COUNT) || !w) {
-		return;
-	}
+bool Topics::get(const Watcher *w, unsigned int index,
+		uint64_t &topic) const noexcept {
+	Subscriptions *subscriptions = nullptr;
+	return watchers.hmGet(w, subscriptions)
+			&& subscriptions->get(topic, index);
+}
 
-	//Get the index to delete
+void Topics::remove(uint64_t topic, const Watcher *w) noexcept {
+	//Get the positions to delete
 	auto i = indexes.get( { w, topic });
-	unsigned int index = 0;
-	if (!indexes.getValue(i, index)) {
+	Position p;
+	if (!w || !indexes.getValue(i, p)) {
 		return;
 	}
 
-	//Remove from the containers
 	indexes.remove(i);
-	topics[topic].remove(index);
+	//-----------------------------------------------------------------
+	//Remove from the topic's list and adjust the replacement's position
+	Subscribers *subscribers = nullptr;
+	if (topics.hmGet(topic, subscribers)) {
+		Subscriber s { nullptr, nullptr };
+		subscribers->get(s, p.topic);
+		delete s.filter;
+		subscribers->remove(p.topic);
+		if (subscribers->get(s, p.topic)) {
+			indexes.getValueReference(indexes.get( { s.w, topic }))->topic =
+					p.topic;
+		} else if (subscribers->isEmpty()) {
+			topics.removeKey(topic);
+			delete subscribers;
+		}
+	}
+	//-----------------------------------------------------------------
+	//Remove from the watcher's list and adjust the replacement's position
+	Subscriptions *subscriptions = nullptr;
+	if (watchers.hmGet(w, subscriptions)) {
+		subscriptions->remove(p.watcher);
+		uint64_t t = 0;
+		if (subscriptions->get(t, p.watcher)) {
+			indexes.getValueReference(indexes.get( { w, t }))->watcher =
+					p.watcher;
+		} else if (subscriptions->isEmpty()) {
+			watchers.removeKey(w);
+			delete subscriptions;
+		}
+	}
+}
 
-	//Adjust replacement's index
-	const Watcher *s = nullptr;
-	if (!topics[topic].get(s, index)) { //The last entry
-		return;
+unsigned int Topics::remove(const Watcher *w) noexcept {
+	unsigned int count = 0;
+	Subscriptions *subscriptions = nullptr;
+	while (watchers.hmGet(w, subscriptions)) {
+		uint64_t topic = 0;
+		subscriptions->get(topic, subscriptions->readSpace() - 1);
+		remove(topic, w);
+		++count;
+	}
+
+	return count;
+}
+
+bool Topics::contains(uint64_t topic, const Watcher *w) const noexcept {
+	return w && indexes.contains( { w, topic });
+}
+
+bool Topics::lookup(uint64_t topic, const Watcher *w,
+		const ContentFilter *&filter) const noexcept {
+	Position p;
+	filter = nullptr;
+	if (!w || !indexes.hmGet( { w, topic }, p)) {
+		return false;
 	} else {
-		unsigned int tmp;
-		indexes.hmReplace( { s, topic }, index, tmp);
+		get(topic, p.topic, filter);
+		return true;
 	}
 }
 
-bool Topics::contains(unsigned int topic, const Watcher *w) const noexcept {
-	return (topic < Topic::COUNT) && w && indexes.contains( { w, topic });
+unsigned int Topics::count(uint64_t topic) const noexcept {
+	Subscribers *subscribers = nullptr;
+	if (topics.hmGet(topic, subscribers)) {
+		return subscribers->readSpace();
+	} else {
+		return 0;
+	}
 }
 
-unsigned int Topics::count(unsigned int topic) const noexcept {
-	if (topic < Topic::COUNT) {
-		return topics[topic].readSpace();
+unsigned int Topics::subscriptions(const Watcher *w) const noexcept {
+	Subscriptions *subscriptions = nullptr;
+	if (watchers.hmGet(w, subscriptions)) {
+		return subscriptions->readSpace();
 	} else {
 		return 0;
 	}
 }
 
+unsigned int Topics::size() const noexcept {
+	return topics.size();
+}
+
+void Topics::iterate(int (&fn)(uint64_t topic, void *arg), void *arg) const {
+	for (auto i = topics.begin(); i != topics.end(); ++i) {
+		uint64_t topic = 0;
+		if (topics.exists(i) && topics.getKey(i, topic) && fn(topic, arg)) {
+			break;
+		}
+	}
+}
+
 void Topics::clear() noexcept {
-	for (unsigned int i = 0; i < Topic::COUNT; i++) {
-		topics[i].clear();
+	for (auto i = topics.begin(); i != topics.end(); ++i) {
+		Subscribers *subscribers = nullptr;
+		if (!topics.exists(i) || !topics.getValue(i, subscribers)) {
+			continue;
+		}
+
+		Subscriber s { nullptr, nullptr };
+		for (unsigned int j = 0; subscribers->get(s, j); ++j) {
+			delete s.filter;
+		}
+		delete subscribers;
+	}
+
+	for (auto i = watchers.begin(); i != watchers.end(); ++i) {
+		Subscriptions *subscriptions = nullptr;
+		if (watchers.exists(i) && watchers.getValue(i, subscriptions)) {
+			delete subscriptions;
+		}
 	}
 
+	topics.clear();
+	watchers.clear();
 	indexes.clear();
 }
 
@@ -12,15 +12,17 @@
 
 #ifndef WH_SERVER_OVERLAY_TOPICS_H_
 #define WH_SERVER_OVERLAY_TOPICS_H_
+#include "ContentFilter.h"
 #include "../../base/ds/Khash.h"
 #include "../../base/ds/ReadyList.h"
 #include "../../base/ds/Twiddler.h"
-#include "../../hub/Topic.h"
 #include "../../reactor/Watcher.h"
+#include <cstdint>
 
 namespace wanhive {
 /**
- * Subscriptions manager for overlay hub
+ * Subscriptions manager for overlay hub. Topics are 64-bit identifiers, the
+ * memory usage is proportional to the number of active subscriptions.
  */
 class Topics {
 public:
@@ -33,12 +35,16 @@ public:
 	 */
 	~Topics();
 	/**
-	 * Associates a watcher to the given topic.
+	 * Associates a watcher to the given topic. If the association already
+	 * exists then it's content filter gets replaced.
 	 * @param topic topic's identifier
 	 * @param w watcher's pointer
-	 * @return true on success, false on error (invalid topic or watcher)
+	 * @param filter optional content filter, this object takes it's ownership
+	 * (the filter is deleted on error).
+	 * @return true on success, false on error (invalid watcher)
 	 */
-	bool put(unsigned int topic, const Watcher *w) noexcept;
+	bool put(uint64_t topic, const Watcher *w,
+			ContentFilter *filter = nullptr) noexcept;
 	/**
 	 * Iterates over the list of watchers associated with the given topic.
 	 * @param topic topic's identifier
@@ -46,39 +52,111 @@ public:
 	 * @return pointer to the watcher at the given index, nullptr on error
 	 * (invalid topic/index).
 	 */
-	Watcher* get(unsigned int topic, unsigned int index) const noexcept;
+	Watcher* get(uint64_t topic, unsigned int index) const noexcept;
+	/**
+	 * Iterates over the list of watchers associated with the given topic.
+	 * @param topic topic's identifier
+	 * @param index list's index
+	 * @param filter stores the association's content filter (nullptr if
+	 * the association doesn't have a filter).
+	 * @return pointer to the watcher at the given index, nullptr on error
+	 * (invalid topic/index).
+	 */
+	Watcher* get(uint64_t topic, unsigned int index,
+			const ContentFilter *&filter) const noexcept;
+	/**
+	 * Iterates over the list of topics associated with the given watcher.
+	 * @param w watcher's pointer
+	 * @param index list's index
+	 * @param topic stores the topic's identifier
+	 * @return true on success, false on error (invalid watcher/index)
+	 */
+	bool get(const Watcher *w, unsigned int index,
+			uint64_t &topic) const noexcept;
 	/**
 	 * Dissociates a watcher from the given topic.
 	 * @param topic topic's identifier
 	 * @param w watcher's pointer
 	 */
-	void remove(unsigned int topic, const Watcher *w) noexcept;
+	void remove(uint64_t topic, const Watcher *w) noexcept;
+	/**
+	 * Dissociates a watcher from all of it's topics.
+	 * @param w watcher's pointer
+	 * @return number of removed associations
+	 */
+	unsigned int remove(const Watcher *w) noexcept;
 	/**
 	 * Checks whether a watcher is associated with a topic.
 	 * @param topic topic's identifier
 	 * @param w watcher's pointer
 	 * @return true if an association exists, false otherwise
 	 */
-	bool contains(unsigned int topic, const Watcher *w) const noexcept;
+	bool contains(uint64_t topic, const Watcher *w) const noexcept;
+	/**
+	 * Checks whether a watcher is associated with a topic and returns the
+	 * association's content filter.
+	 * @param topic topic's identifier
+	 * @param w watcher's pointer
+	 * @param filter stores the association's content filter (nullptr if
+	 * the association doesn't have a filter).
+	 * @return true if an association exists, false otherwise
+	 */
+	bool lookup(uint64_t topic, const Watcher *w,
+			const ContentFilter *&filter) const noexcept;
 	/**
 	 * Returns the number of watchers associated with the given topic.
 	 * @param topic topic's identifier
 	 * @return subscriptions count for the given topic
 	 */
-	unsigned int count(unsigned int topic) const noexcept;
+	unsigned int count(uint64_t topic) const noexcept;
 	/**
-	 * Clears all associations (doesn't deallocate memory).
+	 * Returns the number of topics a watcher is associated with.
+	 * @param w watcher's pointer
+	 * @return subscriptions count for the given watcher
+	 */
+	unsigned int subscriptions(const Watcher *w) const noexcept;
+	/**
+	 * Returns the number of topics which have at least one subscriber.
+	 * @return number of subscribed topics
+	 */
+	unsigned int size() const noexcept;
+	/**
+	 * Iterates a callback function over the topics which have at least one
+	 * subscriber. The callback function must return zero (0) to continue and
+	 * any other value to stop the iteration.
+	 * @param fn callback function, it's first argument is a topic's identifier
+	 * and the second argument is a generic pointer.
+	 * @param arg second argument of the callback function
+	 */
+	void iterate(int (&fn)(uint64_t topic, void *arg), void *arg) const;
+	/**
+	 * Clears all associations.
 	 */
 	void clear() noexcept;
 private:
 	struct Key {
 		const Watcher *w;
+		uint64_t topic;
+	};
+
+	//Positions inside the topic's and the watcher's lists
+	struct Position {
 		unsigned int topic;
+		unsigned int watcher;
 	};
 
 	struct HFN {
 		unsigned int operator()(const Key &key) const noexcept {
-			return (Twiddler::mix((unsigned long long) key.w) + key.topic);
+			return (Twiddler::mix((unsigned long long) key.w)
+					+ Twiddler::mix((unsigned long long) key.topic));
+		}
+
+		unsigned int operator()(const Watcher *w) const noexcept {
+			return Twiddler::mix((unsigned long long) w);
+		}
+
+		unsigned int operator()(uint64_t topic) const noexcept {
+			return Twiddler::mix((unsigned long long) topic);
 		}
 	};
 
@@ -86,12 +164,29 @@ private:
 		bool operator()(const Key &k1, const Key &k2) const noexcept {
 			return ((k1.w == k2.w) && (k1.topic == k2.topic));
 		}
+
+		bool operator()(const Watcher *w1, const Watcher *w2) const noexcept {
+			return w1 == w2;
+		}
+
+		bool operator()(uint64_t t1, uint64_t t2) const noexcept {
+			return t1 == t2;
+		}
+	};
+
+	struct Subscriber {
+		const Watcher *w;
+		ContentFilter *filter;
 	};
 
-	//Lists of watchers organized by topics
-	ReadyList<const Watcher*> topics[Topic::COUNT];
+	using Subscribers = ReadyList<Subscriber>;
+	using Subscriptions = ReadyList<uint64_t>;
+	//Compact lists of watchers organized by topics
+	Kmap<uint64_t, Subscribers*, HFN, EQFN> topics;
+	//Compact lists of topics organized by watchers
+	Kmap<const Watcher*, Subscriptions*, HFN, EQFN> watchers;
 	//Index lookup table for fast insertion and deletion
-	Kmap<Key, unsigned int, HFN, EQFN> indexes;
+	Kmap<Key, Position, HFN, EQFN> indexes;
 };
 
 } /* namespace wanhive */
@@ -40,10 +40,17 @@ enum WhpDhtQualifier {
 	WH_DHT_QLF_GETKEY = WH_QLF_GETKEY, /**< session key */
 	WH_DHT_QLF_FINDROOT = WH_QLF_FINDROOT, /**< root host */
 	WH_DHT_QLF_BOOTSTRAP = WH_QLF_BOOTSTRAP, /**< bootstrap nodes */
+	WH_DHT_QLF_AUTHORIZE = WH_QLF_AUTHORIZE, /**< capability presentation */
 	//WH_DHT_CMD_MULTICAST
 	WH_DHT_QLF_PUBLISH = WH_QLF_PUBLISH, /**< publish */
 	WH_DHT_QLF_SUBSCRIBE = WH_QLF_SUBSCRIBE, /**< subscribe */
 	WH_DHT_QLF_UNSUBSCRIBE = WH_QLF_UNSUBSCRIBE, /**< unsubscribe */
+	WH_DHT_QLF_XPUBLISH = WH_QLF_XPUBLISH, /**< publish (64-bit topic) */
+	WH_DHT_QLF_XSUBSCRIBE = WH_QLF_XSUBSCRIBE, /**< subscribe (64-bit topic) */
+	WH_DHT_QLF_XUNSUBSCRIBE = WH_QLF_XUNSUBSCRIBE, /**< unsubscribe (64-bit topic) */
+	WH_DHT_QLF_NPUBLISH = WH_QLF_NPUBLISH, /**< publish (topic name) */
+	WH_DHT_QLF_NSUBSCRIBE = WH_QLF_NSUBSCRIBE, /**< subscribe (topic filter) */
+	WH_DHT_QLF_NUNSUBSCRIBE = WH_QLF_NUNSUBSCRIBE, /**< unsubscribe (topic filter) */
 	//WH_DHT_CMD_NODE
 	WH_DHT_QLF_GETPREDECESSOR = 0, /**< get predecessor */
 	WH_DHT_QLF_SETPREDECESSOR = 1, /**< set predecessor */
@@ -53,10 +60,25 @@ enum WhpDhtQualifier {
 	WH_DHT_QLF_SETFINGER = 5, /**< set finger table entry */
 	WH_DHT_QLF_GETNEIGHBOURS = 6, /**< get immediate neighbors */
 	WH_DHT_QLF_NOTIFY = 7, /**< notify successor */
+	WH_DHT_QLF_GETMEMBERS = 8, /**< get membership table's page */
+	WH_DHT_QLF_SETMEMBERS = 9, /**< merge membership records */
 	//WH_DHT_CMD_OVERLAY
 	WH_DHT_QLF_FINDSUCCESSOR = 0, /**< find successor */
 	WH_DHT_QLF_PING = 1, /**< ping the host */
-	WH_DHT_QLF_MAP = 2 /**< map request */
+	WH_DHT_QLF_MAP = 2, /**< map request */
+	WH_DHT_QLF_BATCH = 3, /**< batch of frames */
+	WH_DHT_QLF_SUMMARY = 4, /**< subscriptions summary */
+	WH_DHT_QLF_MULTICAST = 5 /**< publication forwarded between hubs */
+};
+
+/**
+ * Enumeration of the built-in ring-wide aggregation functions (map requests)
+ */
+enum WhpDhtMapFunction {
+	WH_DHT_MAP_NODES = 0, /**< number of overlay hubs (sum) */
+	WH_DHT_MAP_CONNECTIONS = 1, /**< number of connections (sum) */
+	WH_DHT_MAP_SUBSCRIBERS = 2, /**< number of subscribers of a topic (sum) */
+	WH_DHT_MAP_MESSAGES = 3 /**< messages in use at the busiest hub (max) */
 };
 
 /**
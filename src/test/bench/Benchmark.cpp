@@ -0,0 +1,200 @@
+/*
+ * Benchmark.cpp
+ *
+ * Microbenchmark harness
+ *
+ *
+ * Copyright (C) 2025 Wanhive Systems Private Limited (info@wanhive.com)
+ * This program is part of the Wanhive IoT Platform.
+ * Check the COPYING file for the license.
+ *
+ */
+
+#include "Benchmark.h"
+#include "../../base/common/Atomic.h"
+#include <config.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+unsigned long long heapAllocations = 0;
+unsigned long long heapBytes = 0;
+
+void count(size_t size) noexcept {
+	wanhive::Atomic<unsigned long long>::fetchAndAdd(&heapAllocations, 1);
+	wanhive::Atomic<unsigned long long>::fetchAndAdd(&heapBytes, size);
+}
+
+double percentile(const double *sorted, unsigned int n, double p) noexcept {
+	auto rank = (unsigned int) (p * n + 0.999999);
+	return sorted[(rank ? rank : 1) - 1];
+}
+
+}  // namespace
+
+#ifdef __GLIBC__
+/*
+ * Counts the heap allocations made by this program and the libraries (the
+ * allocator itself is glibc's).
+ */
+extern "C" {
+void* __libc_malloc(size_t size) noexcept;
+void* __libc_calloc(size_t n, size_t size) noexcept;
+void* __libc_realloc(void *p, size_t size) noexcept;
+void* __libc_memalign(size_t alignment, size_t size) noexcept;
+void __libc_free(void *p) noexcept;
+
+void* malloc(size_t size) noexcept {
+	count(size);
+	return __libc_malloc(size);
+}
+
+void* calloc(size_t n, size_t size) noexcept {
+	count(n * size);
+	return __libc_calloc(n, size);
+}
+
+void* realloc(void *p, size_t size) noexcept {
+	count(size);
+	return __libc_realloc(p, size);
+}
+
+void* memalign(size_t alignment, size_t size) noexcept {
+	count(size);
+	return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) noexcept {
+	count(size);
+	return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void **p, size_t alignment, size_t size) noexcept {
+	if (!alignment || (alignment & (alignment - 1))
+			|| (alignment % sizeof(void*))) {
+		return EINVAL;
+	}
+
+	count(size);
+	auto m = __libc_memalign(alignment, size);
+	if (m) {
+		*p = m;
+		return 0;
+	} else {
+		return ENOMEM;
+	}
+}
+
+void free(void *p) noexcept {
+	__libc_free(p);
+}
+}
+#endif
+
+namespace wanhive {
+
+Benchmark::Benchmark(unsigned int samples, const char *filter) noexcept :
+		samples(std::clamp(samples, 1U, MAX_SAMPLES)), filter(filter) {
+
+}
+
+Benchmark::~Benchmark() {
+
+}
+
+void Benchmark::print(FILE *out) const noexcept {
+	fprintf(out, "%-32s %10s %10s %10s %10s %12s %9s %8s\n", "BENCHMARK",
+			"NS/OP", "P50", "P90", "P99", "OPS/S", "MB/S", "ALLOCS");
+	for (unsigned int i = 0; i < count; ++i) {
+		auto &r = results[i];
+		fprintf(out, "%-32s %10.1lf %10.1lf %10.1lf %10.1lf %12.0lf ", r.name,
+				r.mean, r.p50, r.p90, r.p99, 1e9 / r.mean);
+		if (r.bytes) {
+			fprintf(out, "%9.1lf ", (r.bytes * 1e9 / r.mean) / (1024 * 1024));
+		} else {
+			fprintf(out, "%9s ", "-");
+		}
+
+		if (countsAllocations()) {
+			fprintf(out, "%8.2lf\n", r.allocations);
+		} else {
+			fprintf(out, "%8s\n", "-");
+		}
+	}
+}
+
+void Benchmark::json(FILE *out) const noexcept {
+	fprintf(out, "{\n  \"version\": \"%s\",\n  \"samples\": %u,\n"
+			"  \"allocationsCounted\": %s,\n  \"results\": [",
+			PACKAGE_VERSION, samples, countsAllocations() ? "true" : "false");
+	for (unsigned int i = 0; i < count; ++i) {
+		auto &r = results[i];
+		fprintf(out, "%s\n    {\"name\": \"%s\", \"samples\": %u, "
+				"\"batch\": %llu, \"nsPerOp\": %.3lf, \"min\": %.3lf, "
+				"\"p50\": %.3lf, \"p90\": %.3lf, \"p99\": %.3lf, "
+				"\"max\": %.3lf, \"opsPerSec\": %.1lf", i ? "," : "", r.name,
+				r.samples, r.batch, r.mean, r.min, r.p50, r.p90, r.p99, r.max,
+				1e9 / r.mean);
+		if (r.bytes) {
+			fprintf(out, ", \"bytesPerOp\": %u, \"mbPerSec\": %.3lf", r.bytes,
+					(r.bytes * 1e9 / r.mean) / (1024 * 1024));
+		}
+
+		if (countsAllocations()) {
+			fprintf(out, ", \"allocsPerOp\": %.4lf, \"allocBytesPerOp\": %.2lf",
+					r.allocations, r.allocatedBytes);
+		}
+		fprintf(out, "}");
+	}
+	fprintf(out, "\n  ]\n}\n");
+}
+
+unsigned long long Benchmark::allocations() noexcept {
+	return Atomic<unsigned long long>::load(&heapAllocations);
+}
+
+unsigned long long Benchmark::allocatedBytes() noexcept {
+	return Atomic<unsigned long long>::load(&heapBytes);
+}
+
+bool Benchmark::countsAllocations() noexcept {
+#ifdef __GLIBC__
+	return true;
+#else
+	return false;
+#endif
+}
+
+bool Benchmark::selected(const char *name) const noexcept {
+	return !filter || !*filter || strstr(name, filter);
+}
+
+void Benchmark::record(const char *name, unsigned int bytes,
+		unsigned long long batch, double *values,
+		unsigned long long allocations, unsigned long long allocated) noexcept {
+	std::sort(values, values + samples);
+	double sum = 0;
+	for (unsigned int i = 0; i < samples; ++i) {
+		sum += values[i];
+	}
+
+	auto ops = (double) batch * samples;
+	auto &r = results[count++];
+	r.name = name;
+	r.bytes = bytes;
+	r.samples = samples;
+	r.batch = batch;
+	r.mean = sum / samples;
+	r.min = values[0];
+	r.p50 = percentile(values, samples, 0.5);
+	r.p90 = percentile(values, samples, 0.9);
+	r.p99 = percentile(values, samples, 0.99);
+	r.max = values[samples - 1];
+	r.allocations = allocations / ops;
+	r.allocatedBytes = allocated / ops;
+}
+
+} /* namespace wanhive */
@@ -0,0 +1,146 @@
+/*
+ * Benchmark.h
+ *
+ * Microbenchmark harness
+ *
+ *
+ * Copyright (C) 2025 Wanhive Systems Private Limited (info@wanhive.com)
+ * This program is part of the Wanhive IoT Platform.
+ * Check the COPYING file for the license.
+ *
+ */
+
+#ifndef WH_TEST_BENCH_BENCHMARK_H_
+#define WH_TEST_BENCH_BENCHMARK_H_
+#include <cstdio>
+#include <ctime>
+
+namespace wanhive {
+/**
+ * Microbenchmark harness: times batches of operations, reports the latency
+ * percentiles, the throughput, and the heap allocations per operation as a
+ * text table or as JSON.
+ */
+class Benchmark {
+public:
+	Benchmark(unsigned int samples = 31, const char *filter = nullptr) noexcept;
+	~Benchmark();
+	/**
+	 * Measures an operation, the results are recorded for the report.
+	 * @param name benchmark's name ("group.operation")
+	 * @param bytes bytes processed per operation (0 if not applicable)
+	 * @param op the operation
+	 */
+	template<typename F> void run(const char *name, unsigned int bytes, F &&op);
+	/**
+	 * Prints the results as a text table.
+	 * @param out the output stream
+	 */
+	void print(FILE *out) const noexcept;
+	/**
+	 * Prints the results as a JSON document.
+	 * @param out the output stream
+	 */
+	void json(FILE *out) const noexcept;
+	//-----------------------------------------------------------------
+	/**
+	 * Keeps the compiler from optimizing away a value or a buffer's contents.
+	 * @param p pointer to the value
+	 */
+	static void clobber(const void *p) noexcept {
+		asm volatile("" : : "r"(p) : "memory");
+	}
+	/**
+	 * Returns the number of heap allocations made so far by this process.
+	 * @return allocations count, 0 if not supported
+	 */
+	static unsigned long long allocations() noexcept;
+	/**
+	 * Returns the number of bytes allocated on heap so far by this process.
+	 * @return allocated bytes count, 0 if not supported
+	 */
+	static unsigned long long allocatedBytes() noexcept;
+	/**
+	 * Checks whether the heap allocations are counted.
+	 * @return true if the allocations are counted, false otherwise
+	 */
+	static bool countsAllocations() noexcept;
+public:
+	/** Maximum number of benchmarks */
+	static constexpr unsigned int MAX_RESULTS = 64;
+	/** Maximum number of samples per benchmark */
+	static constexpr unsigned int MAX_SAMPLES = 1024;
+private:
+	struct Result {
+		const char *name;
+		unsigned int bytes; //Bytes per operation
+		unsigned int samples;
+		unsigned long long batch; //Operations per sample
+		double mean; //Nanoseconds per operation
+		double min;
+		double p50;
+		double p90;
+		double p99;
+		double max;
+		double allocations; //Per operation
+		double allocatedBytes; //Per operation
+	};
+
+	bool selected(const char *name) const noexcept;
+	void record(const char *name, unsigned int bytes, unsigned long long batch,
+			double *samples, unsigned long long allocations,
+			unsigned long long allocated) noexcept;
+	static unsigned long long now() noexcept {
+		timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return (unsigned long long) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+	}
+private:
+	//Minimum duration of a sample in nanoseconds
+	static constexpr unsigned long long SAMPLE_TIME = 200000;
+	unsigned int samples;
+	const char *filter;
+	unsigned int count { 0 };
+	Result results[MAX_RESULTS];
+};
+
+template<typename F> void Benchmark::run(const char *name, unsigned int bytes,
+		F &&op) {
+	if (!selected(name) || count == MAX_RESULTS) {
+		return;
+	}
+
+	//Calibration (also warms up the caches)
+	unsigned long long batch = 1;
+	for (;;) {
+		auto start = now();
+		for (unsigned long long i = 0; i < batch; ++i) {
+			op();
+		}
+		auto elapsed = now() - start;
+		if (elapsed >= SAMPLE_TIME || batch >= (1ULL << 30)) {
+			break;
+		} else if (elapsed < SAMPLE_TIME / 16) {
+			batch *= 8;
+		} else {
+			batch *= 2;
+		}
+	}
+	//-----------------------------------------------------------------
+	double values[MAX_SAMPLES];
+	auto a = allocations();
+	auto b = allocatedBytes();
+	for (unsigned int s = 0; s < samples; ++s) {
+		auto start = now();
+		for (unsigned long long i = 0; i < batch; ++i) {
+			op();
+		}
+		values[s] = (double) (now() - start) / batch;
+	}
+	record(name, bytes, batch, values, allocations() - a,
+			allocatedBytes() - b);
+}
+
+} /* namespace wanhive */
+
+#endif /* WH_TEST_BENCH_BENCHMARK_H_ */
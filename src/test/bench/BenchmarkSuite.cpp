@@ -0,0 +1,351 @@
+/*
+ * BenchmarkSuite.cpp
+ *
+ * Microbenchmarks of the data structures and utilities
+ *
+ *
+ * Copyright (C) 2025 Wanhive Systems Private Limited (info@wanhive.com)
+ * This program is part of the Wanhive IoT Platform.
+ * Check the COPYING file for the license.
+ *
+ */
+
+#include "BenchmarkSuite.h"
+#include "../../base/ds/BinaryHeap.h"
+#include "../../base/ds/CircularBuffer.h"
+#include "../../base/ds/Encoding.h"
+#include "../../base/ds/Khash.h"
+#include "../../base/ds/MemoryPool.h"
+#include "../../base/ds/MersenneTwister.h"
+#include "../../base/ds/Pooled.h"
+#include "../../base/ds/ReadyList.h"
+#include "../../base/ds/Serializer.h"
+#include "../../base/ds/StaticCircularBuffer.h"
+#include "../../base/ds/Twiddler.h"
+#include "../../base/ds/Xoshiro.h"
+#include "../../base/security/CSPRNG.h"
+#include "../../base/security/Sha.h"
+#include "../../util/Hash.h"
+#include "../../util/Message.h"
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+using namespace wanhive;
+
+//Number of keys in the hash table benchmarks
+constexpr unsigned int KEYS = 1 << 16;
+
+//Pooled object of a typical size
+class Object: public Pooled<Object> {
+public:
+	Object() noexcept :
+			Pooled<Object>('\0') {
+	}
+	static Object* create() noexcept {
+		return new Object();
+	}
+	static void destroy(Object *o) noexcept {
+		delete o;
+	}
+private:
+	unsigned char data[64];
+};
+
+//Serves the same frame over and over
+class FrameSource: public Source<unsigned char> {
+public:
+	FrameSource(const unsigned char *frame, unsigned int length) noexcept :
+			frame(frame), length(length) {
+	}
+
+	size_t take(unsigned char *buffer, size_t count) override {
+		auto n = Twiddler::min((unsigned int) count, length - offset);
+		memcpy(buffer, frame + offset, n);
+		offset = (offset + n) % length;
+		return n;
+	}
+
+	size_t available() const noexcept override {
+		return length - offset;
+	}
+private:
+	const unsigned char *frame;
+	unsigned int length;
+	unsigned int offset { 0 };
+};
+
+}  // namespace
+
+namespace wanhive {
+
+void BenchmarkSuite::execute(Benchmark &b) {
+	hashTables(b);
+	buffers(b);
+	heaps(b);
+	pools(b);
+	serialization(b);
+	hashing(b);
+	messages(b);
+	random(b);
+}
+
+void BenchmarkSuite::hashTables(Benchmark &b) {
+	Xoshiro prng(1);
+	static unsigned long long keys[KEYS];
+	prng.fill(keys, KEYS);
+	//-----------------------------------------------------------------
+	Kmap<unsigned long long, unsigned long long> map;
+	for (auto k : keys) {
+		map.hmPut(k, k);
+	}
+
+	unsigned int i = 0;
+	b.run("kmap.get", 0, [&] {
+		unsigned long long v = 0;
+		map.hmGet(keys[i++ & (KEYS - 1)], v);
+		Benchmark::clobber(&v);
+	});
+
+	auto miss = prng.next();
+	b.run("kmap.get.miss", 0, [&] {
+		unsigned long long v = 0;
+		map.hmGet(++miss, v);
+		Benchmark::clobber(&v);
+	});
+
+	b.run("kmap.put+remove", 0, [&] {
+		auto k = keys[i++ & (KEYS - 1)] ^ 1;
+		map.hmPut(k, k);
+		map.removeKey(k);
+	});
+	//-----------------------------------------------------------------
+	Kset<unsigned long long> set;
+	for (auto k : keys) {
+		set.hsPut(k);
+	}
+
+	b.run("kset.contains", 0, [&] {
+		auto found = set.contains(keys[i++ & (KEYS - 1)]);
+		Benchmark::clobber(&found);
+	});
+
+	b.run("kset.put+remove", 0, [&] {
+		auto k = keys[i++ & (KEYS - 1)] ^ 1;
+		set.hsPut(k);
+		set.removeKey(k);
+	});
+}
+
+void BenchmarkSuite::buffers(Benchmark &b) {
+	CircularBuffer<unsigned long long> cb(1024);
+	unsigned long long x = 0;
+	b.run("circularbuffer.put+get", 0, [&] {
+		cb.put(x);
+		cb.get(x);
+		Benchmark::clobber(&x);
+	});
+
+	unsigned long long block[64] = { };
+	b.run("circularbuffer.write+read/64", 64 * sizeof(x), [&] {
+		cb.write(block, 64);
+		cb.read(block, 64);
+		Benchmark::clobber(block);
+	});
+
+	CircularBuffer<unsigned long long, true> acb(1024);
+	b.run("circularbuffer.atomic.put+get", 0, [&] {
+		acb.put(x);
+		acb.get(x);
+		Benchmark::clobber(&x);
+	});
+
+	static StaticCircularBuffer<unsigned long long, 1024> scb;
+	b.run("staticcircularbuffer.put+get", 0, [&] {
+		scb.put(x);
+		scb.get(x);
+		Benchmark::clobber(&x);
+	});
+	//-----------------------------------------------------------------
+	ReadyList<unsigned long long> list(1024);
+	b.run("readylist.put+get", 0, [&] {
+		list.put(x);
+		list.get(x);
+		Benchmark::clobber(&x);
+	});
+}
+
+void BenchmarkSuite::heaps(Benchmark &b) {
+	Xoshiro prng(2);
+	BinaryHeap<unsigned int> heap(1024);
+	while (heap.size() < 512) {
+		heap.insert((unsigned int) prng.next());
+	}
+
+	b.run("binaryheap.insert+remove/512", 0, [&] {
+		heap.insert((unsigned int) prng.next());
+		heap.remove();
+	});
+}
+
+void BenchmarkSuite::pools(Benchmark &b) {
+	MemoryPool pool(64, 1024);
+	b.run("memorypool.allocate+deallocate", 0, [&] {
+		auto p = pool.allocate();
+		Benchmark::clobber(p);
+		pool.deallocate(p);
+	});
+
+	Object::initPool(1024);
+	b.run("pooled.create+destroy", 0, [&] {
+		auto o = Object::create();
+		Benchmark::clobber(o);
+		Object::destroy(o);
+	});
+	Object::destroyPool();
+
+	b.run("malloc.allocate+free/64", 0, [&] {
+		auto p = malloc(64);
+		Benchmark::clobber(p);
+		free(p);
+	});
+}
+
+void BenchmarkSuite::serialization(Benchmark &b) {
+	unsigned char buf[64];
+	b.run("serializer.pack/QQLHC", 23, [&] {
+		Serializer::pack(buf, sizeof(buf), "QQLHC", 1ULL, 2ULL, 3UL, 4, 5);
+		Benchmark::clobber(buf);
+	});
+
+	b.run("serializer.unpack/QQLHC", 23, [&] {
+		unsigned long long q1, q2;
+		unsigned long l;
+		unsigned int h;
+		unsigned char c;
+		Serializer::unpack(buf, sizeof(buf), "QQLHC", &q1, &q2, &l, &h, &c);
+		Benchmark::clobber(&q1);
+	});
+	//-----------------------------------------------------------------
+	constexpr unsigned int SIZE = 1024;
+	static unsigned char data[SIZE];
+	static unsigned char decoded[SIZE + 8];
+	static char encoded[2 * SIZE + 8];
+	Xoshiro(3).bytes(data, SIZE);
+	auto length = Encoding::base64Encode(encoded, data, SIZE, sizeof(encoded));
+	b.run("encoding.base64.encode/1k", SIZE, [&] {
+		Encoding::base64Encode(encoded, data, SIZE, sizeof(encoded));
+		Benchmark::clobber(encoded);
+	});
+
+	b.run("encoding.base64.decode/1k", SIZE, [&] {
+		Encoding::base64Decode(decoded, encoded, length, sizeof(decoded));
+		Benchmark::clobber(decoded);
+	});
+
+	b.run("encoding.base16.encode/1k", SIZE, [&] {
+		Encoding::base16Encode(encoded, data, SIZE, sizeof(encoded));
+		Benchmark::clobber(encoded);
+	});
+}
+
+void BenchmarkSuite::hashing(Benchmark &b) {
+	static unsigned char data[1024];
+	Xoshiro(4).bytes(data, sizeof(data));
+	b.run("twiddler.fvn1a/32", 32, [&] {
+		auto h = Twiddler::FVN1aHash(data, 32);
+		Benchmark::clobber(&h);
+	});
+
+	b.run("twiddler.wyhash/32", 32, [&] {
+		auto h = Twiddler::wyHash(data, 32);
+		Benchmark::clobber(&h);
+	});
+
+	b.run("twiddler.wyhash/1k", sizeof(data), [&] {
+		auto h = Twiddler::wyHash(data, sizeof(data));
+		Benchmark::clobber(&h);
+	});
+	//-----------------------------------------------------------------
+	Sha sha(WH_SHA512);
+	unsigned char md[64];
+	b.run("sha512.create/64", 64, [&] {
+		sha.create(data, 64, md);
+		Benchmark::clobber(md);
+	});
+
+	b.run("sha512.create/1k", sizeof(data), [&] {
+		sha.create(data, sizeof(data), md);
+		Benchmark::clobber(md);
+	});
+
+	Hash hash;
+	Digest digest;
+	b.run("hash.create/64", 64, [&] {
+		hash.create(data, 64, &digest);
+		Benchmark::clobber(digest);
+	});
+
+	b.run("hash.hmac/64", 64, [&] {
+		hash.create(WH_HMAC_SHA512, data + 64, 32, data, 64, &digest);
+		Benchmark::clobber(digest);
+	});
+
+	b.run("hash.blake2b/64", 64, [&] {
+		hash.create(WH_BLAKE2B512, data + 64, 32, data, 64, &digest);
+		Benchmark::clobber(digest);
+	});
+}
+
+void BenchmarkSuite::messages(Benchmark &b) {
+	constexpr unsigned int LENGTH = 256;
+	unsigned char frame[LENGTH];
+	memset(frame, 0, sizeof(frame));
+	MessageHeader header;
+	header.setLength(LENGTH);
+	header.write(frame);
+	FrameSource source(frame, LENGTH);
+
+	Message::initPool(16);
+	b.run("message.build/256", LENGTH, [&] {
+		auto m = Message::create();
+		auto done = m && m->build(source);
+		Benchmark::clobber(&done);
+		Message::recycle(m);
+	});
+	Message::destroyPool();
+}
+
+void BenchmarkSuite::random(Benchmark &b) {
+	MersenneTwister mt(5);
+	b.run("mersennetwister.next", 4, [&] {
+		auto x = mt.next();
+		Benchmark::clobber(&x);
+	});
+
+	Xoshiro prng(5);
+	b.run("xoshiro.next", 8, [&] {
+		auto x = prng.next();
+		Benchmark::clobber(&x);
+	});
+
+	unsigned long long values[256];
+	b.run("xoshiro.fill/256", sizeof(values), [&] {
+		prng.fill(values, 256);
+		Benchmark::clobber(values);
+	});
+
+	unsigned char bytes[16];
+	b.run("csprng.bytes/16", sizeof(bytes), [&] {
+		CSPRNG::bytes(bytes, sizeof(bytes));
+		Benchmark::clobber(bytes);
+	});
+
+	b.run("csprng.buffered/16", sizeof(bytes), [&] {
+		CSPRNG::buffered(bytes, sizeof(bytes));
+		Benchmark::clobber(bytes);
+	});
+}
+
+} /* namespace wanhive */
@@ -0,0 +1,35 @@
+/*
+ * BenchmarkSuite.h
+ *
+ * Microbenchmarks of the data structures and utilities
+ *
+ *
+ * Copyright (C) 2025 Wanhive Systems Private Limited (info@wanhive.com)
+ * This program is part of the Wanhive IoT Platform.
+ * Check the COPYING file for the license.
+ *
+ */
+
+#ifndef WH_TEST_BENCH_BENCHMARKSUITE_H_
+#define WH_TEST_BENCH_BENCHMARKSUITE_H_
+#include "Benchmark.h"
+
+namespace wanhive {
+
+class BenchmarkSuite {
+public:
+	static void execute(Benchmark &b);
+private:
+	static void hashTables(Benchmark &b);
+	static void buffers(Benchmark &b);
+	static void heaps(Benchmark &b);
+	static void pools(Benchmark &b);
+	static void serialization(Benchmark &b);
+	static void hashing(Benchmark &b);
+	static void messages(Benchmark &b);
+	static void random(Benchmark &b);
+};
+
+} /* namespace wanhive */
+
+#endif /* WH_TEST_BENCH_BENCHMARKSUITE_H_ */
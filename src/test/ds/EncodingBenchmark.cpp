@@ -0,0 +1,113 @@
+/*
+ * EncodingBenchmark.cpp
+ *
+ * Binary-to-text encoding throughput benchmark
+ *
+ *
+ * Copyright (C) 2025 Wanhive Systems Private Limited (info@wanhive.com)
+ * This program is part of the Wanhive IoT Platform.
+ * Check the COPYING file for the license.
+ *
+ */
+
+#include "EncodingBenchmark.h"
+#include "../../base/Timer.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+const char *NAMES[] = { "BASE16", "BASE32", "BASE64" };
+
+}  // namespace
+
+namespace wanhive {
+
+EncodingBenchmark::EncodingBenchmark(unsigned int size,
+		unsigned int rounds) noexcept :
+		size(size), rounds(rounds) {
+	auto length = Encoding::encodedLength16(size); //The largest one
+	data = (unsigned char*) malloc(size);
+	decoded = (unsigned char*) malloc(size + 8);
+	encoded = (char*) malloc(length);
+	reference = (char*) malloc(length);
+	for (unsigned int i = 0; data && i < size; ++i) {
+		data[i] = (unsigned char) rand();
+	}
+}
+
+EncodingBenchmark::~EncodingBenchmark() {
+	free(data);
+	free(decoded);
+	free(encoded);
+	free(reference);
+	Encoding::accelerate(true);
+}
+
+void EncodingBenchmark::execute() noexcept {
+	if (!data || !decoded || !encoded || !reference) {
+		printf("Out of memory\n");
+		return;
+	}
+
+	printf("Implementation: %s\n", Encoding::accelerate(true));
+	printf("%-8s %10s %10s %10s   (MB/s of binary data)\n", "", "ENCODE",
+			"DECODE", "VALIDATE");
+	for (unsigned int i = ENC_BASE16; i <= ENC_BASE64; ++i) {
+		double scalar[3], vector[3];
+		auto base = (EncodingBase) i;
+		if (!run(base, false, scalar) || !run(base, true, vector)) {
+			printf("%s: FAILED\n", NAMES[i]);
+			continue;
+		}
+
+		printf("%-8s %10.0lf %10.0lf %10.0lf   scalar\n", NAMES[i], scalar[0],
+				scalar[1], scalar[2]);
+		printf("%-8s %10.0lf %10.0lf %10.0lf   vector", "", vector[0],
+				vector[1], vector[2]);
+		printf(" (%.1lfx, %.1lfx, %.1lfx)\n", vector[0] / scalar[0],
+				vector[1] / scalar[1], vector[2] / scalar[2]);
+	}
+	Encoding::accelerate(true);
+}
+
+bool EncodingBenchmark::run(EncodingBase base, bool accelerate,
+		double rates[3]) noexcept {
+	Encoding::accelerate(accelerate);
+	auto capacity = Encoding::encodedLength(base, size);
+	auto megabytes = ((double) size * rounds) / (1024 * 1024);
+	unsigned int length = 0;
+	bool valid = true;
+
+	Timer t;
+	for (unsigned int i = 0; i < rounds; ++i) {
+		length = Encoding::encode(base, encoded, data, size, capacity);
+	}
+	rates[0] = megabytes / t.elapsed();
+
+	t.now();
+	unsigned int n = 0;
+	for (unsigned int i = 0; i < rounds; ++i) {
+		n = Encoding::decode(base, decoded, encoded, length,
+				Encoding::decodedLength(base, length));
+	}
+	rates[1] = megabytes / t.elapsed();
+
+	t.now();
+	for (unsigned int i = 0; i < rounds; ++i) {
+		valid = Encoding::validate(base, encoded, length) && valid;
+	}
+	rates[2] = megabytes / t.elapsed();
+
+	//The output must match the scalar code's output byte for byte
+	if (!accelerate) {
+		memcpy(reference, encoded, length + 1);
+	} else if (memcmp(reference, encoded, length + 1)) {
+		return false;
+	}
+
+	return valid && n == size && !memcmp(data, decoded, size);
+}
+
+} /* namespace wanhive */
@@ -0,0 +1,38 @@
+/*
+ * EncodingBenchmark.h
+ *
+ * Binary-to-text encoding throughput benchmark
+ *
+ *
+ * Copyright (C) 2025 Wanhive Systems Private Limited (info@wanhive.com)
+ * This program is part of the Wanhive IoT Platform.
+ * Check the COPYING file for the license.
+ *
+ */
+
+#ifndef WH_TEST_DS_ENCODINGBENCHMARK_H_
+#define WH_TEST_DS_ENCODINGBENCHMARK_H_
+#include "../../base/ds/Encoding.h"
+
+namespace wanhive {
+
+class EncodingBenchmark {
+public:
+	EncodingBenchmark(unsigned int size = 64 * 1024, unsigned int rounds =
+			2000) noexcept;
+	~EncodingBenchmark();
+	void execute() noexcept;
+private:
+	bool run(EncodingBase base, bool accelerate, double rates[3]) noexcept;
+private:
+	unsigned int size;
+	unsigned int rounds;
+	unsigned char *data;
+	unsigned char *decoded;
+	char *encoded;
+	char *reference;
+};
+
+} /* namespace wanhive */
+
+#endif /* WH_TEST_DS_ENCODINGBENCHMARK_H_ */
@@ -0,0 +1,203 @@
+/*
+ * LayoutBenchmark.cpp
+ *
+ * Compile-time wire layout benchmark
+ *
+ *
+ * Copyright (C) 2025 Wanhive Systems Private Limited (info@wanhive.com)
+ * This program is part of the Wanhive IoT Platform.
+ * Check the COPYING file for the license.
+ *
+ */
+
+#include "LayoutBenchmark.h"
+#include "../../base/Timer.h"
+#include "../../base/common/BaseException.h"
+#include "../../base/ds/Layout.h"
+#include "../../util/Message.h"
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+//Same as the hub's runtime information
+constexpr char FORMAT[] = "QgQQQQLLLLL";
+using Info = wanhive::Layout<wanhive::WireU64, wanhive::WireF64,
+		wanhive::WireU64, wanhive::WireU64, wanhive::WireU64, wanhive::WireU64,
+		wanhive::WireU32, wanhive::WireU32, wanhive::WireU32, wanhive::WireU32,
+		wanhive::WireU32>;
+//Same as the overlay's map request
+using Request = wanhive::Layout<wanhive::WireU64, wanhive::WireU64,
+		wanhive::WireU32, wanhive::WireU32, wanhive::WireU32>;
+
+//Keeps the compiler from optimizing away the buffer's contents
+inline void clobber(void *p) noexcept {
+	asm volatile("" : : "r"(p) : "memory");
+}
+
+struct Record {
+	uint64_t q[5];
+	double g;
+	uint32_t l[5];
+};
+
+Record sample(unsigned int i) noexcept {
+	return { { i, 1ULL << 40 | i, ~0ULL - i, 7, 1ULL << 63 }, i * 0.5, { i, 2,
+			~0U, 1U << 31, 1024 } };
+}
+
+//Field-wise comparison (the padding bytes are indeterminate)
+bool equals(const Record &a, const Record &b) noexcept {
+	return !memcmp(a.q, b.q, sizeof(a.q)) && a.g == b.g
+			&& !memcmp(a.l, b.l, sizeof(a.l));
+}
+
+}  // namespace
+
+namespace wanhive {
+
+LayoutBenchmark::LayoutBenchmark(unsigned int count) noexcept :
+		count(count), checksum(0) {
+
+}
+
+LayoutBenchmark::~LayoutBenchmark() {
+
+}
+
+void LayoutBenchmark::execute() noexcept {
+	printf("Wire compatibility: %s\n", verify() ? "OK" : "FAILED");
+	Timer t;
+	formatTest();
+	auto format = t.elapsed();
+	printf("Format string: %.3lf sec (%.1lf ns/op)\n", format,
+			format * 1e9 / (2.0 * count));
+	t.now();
+	layoutTest();
+	auto layout = t.elapsed();
+	printf("Layout: %.3lf sec (%.1lf ns/op)\n", layout,
+			layout * 1e9 / (2.0 * count));
+	printf("Speedup: %.1lfx [checksum: %llu]\n", format / layout, checksum);
+	messageTest();
+}
+
+bool LayoutBenchmark::verify() noexcept {
+	unsigned char a[Info::SIZE];
+	unsigned char b[Info::SIZE];
+	for (unsigned int i = 0; i < 1024; ++i) {
+		auto r = sample(i * 2654435761U);
+		Record x, y;
+		auto n = Serializer::pack(a, sizeof(a), FORMAT, r.q[0], r.g, r.q[1],
+				r.q[2], r.q[3], r.q[4], r.l[0], r.l[1], r.l[2], r.l[3], r.l[4]);
+		auto m = Info::pack(b, sizeof(b), r.q[0], r.g, r.q[1], r.q[2], r.q[3],
+				r.q[4], r.l[0], r.l[1], r.l[2], r.l[3], r.l[4]);
+		if (n != Info::SIZE || m != n || memcmp(a, b, n)) {
+			return false;
+		}
+
+		Serializer::unpack(a, sizeof(a), FORMAT, &x.q[0], &x.g, &x.q[1],
+				&x.q[2], &x.q[3], &x.q[4], &x.l[0], &x.l[1], &x.l[2], &x.l[3],
+				&x.l[4]);
+		Info::unpack(b, sizeof(b), y.q[0], y.g, y.q[1], y.q[2], y.q[3], y.q[4],
+				y.l[0], y.l[1], y.l[2], y.l[3], y.l[4]);
+		if (!equals(x, r) || !equals(y, r)) {
+			return false;
+		}
+	}
+
+	//Overflow must be detected
+	return Info::pack(a, Info::SIZE - 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0) == 0;
+}
+
+void LayoutBenchmark::formatTest() noexcept {
+	unsigned char buf[Request::SIZE];
+	uint64_t q[2];
+	uint32_t l[3];
+	for (unsigned int i = 0; i < count; ++i) {
+		Serializer::pack(buf, sizeof(buf), "QQLLL", (uint64_t) i, ~0ULL - i, i,
+				2U, 1024U);
+		clobber(buf);
+		Serializer::unpack(buf, sizeof(buf), "QQLLL", &q[0], &q[1], &l[0],
+				&l[1], &l[2]);
+		checksum += q[1] + l[0];
+	}
+}
+
+void LayoutBenchmark::layoutTest() noexcept {
+	unsigned char buf[Request::SIZE];
+	uint64_t q[2];
+	uint32_t l[3];
+	for (unsigned int i = 0; i < count; ++i) {
+		Request::pack(buf, sizeof(buf), i, ~0ULL - i, i, 2U, 1024U);
+		clobber(buf);
+		Request::unpack(buf, sizeof(buf), q[0], q[1], l[0], l[1], l[2]);
+		checksum += q[1] + l[0];
+	}
+}
+
+void LayoutBenchmark::messageTest() noexcept {
+	try {
+		Message::initPool(2);
+	} catch (const BaseException &e) {
+		printf("Message pool unavailable\n");
+		return;
+	}
+
+	auto a = Message::create();
+	auto b = Message::create();
+	MessageHeader header;
+	header.setAddress(1, 2);
+	header.setControl(0, 3, 4);
+	header.setContext(5, 6, 7);
+	//-----------------------------------------------------------------
+	//Message::pack<L> and Message::unpack<L> against the format string
+	auto compatible = a && b;
+	for (unsigned int i = 0; compatible && i < 1024; ++i) {
+		auto r = sample(i * 2654435761U);
+		uint64_t q[2] = { 0, 0 };
+		uint32_t l[3] = { 0, 0, 0 };
+		compatible = a->pack(header, "QQLLL", r.q[0], r.q[1], r.l[0], r.l[1],
+				r.l[2])
+				&& b->pack<Request>(header, r.q[0], r.q[1], r.l[0], r.l[1],
+						r.l[2]) && a->getLength() == b->getLength()
+				&& !memcmp(a->buffer(), b->buffer(), a->getLength())
+				&& a->unpack<Request>(q[0], q[1], l[0], l[1], l[2])
+				&& q[0] == r.q[0] && q[1] == r.q[1] && l[0] == r.l[0]
+				&& l[1] == r.l[1] && l[2] == r.l[2];
+	}
+
+	printf("Message compatibility: %s\n", compatible ? "OK" : "FAILED");
+	//-----------------------------------------------------------------
+	if (compatible) {
+		uint64_t q[2] = { 0, 0 };
+		uint32_t l[3] = { 0, 0, 0 };
+		Timer t;
+		for (unsigned int i = 0; i < count; ++i) {
+			a->pack(header, "QQLLL", (uint64_t) i, ~0ULL - i, i, 2U, 1024U);
+			clobber(a);
+			a->unpack("QQLLL", &q[0], &q[1], &l[0], &l[1], &l[2]);
+			checksum += q[1] + l[0];
+		}
+		auto format = t.elapsed();
+		printf("Message format string: %.3lf sec (%.1lf ns/op)\n", format,
+				format * 1e9 / (2.0 * count));
+		t.now();
+		for (unsigned int i = 0; i < count; ++i) {
+			b->pack<Request>(header, (uint64_t) i, ~0ULL - i, i, 2U, 1024U);
+			clobber(b);
+			b->unpack<Request>(q[0], q[1], l[0], l[1], l[2]);
+			checksum += q[1] + l[0];
+		}
+		auto layout = t.elapsed();
+		printf("Message layout: %.3lf sec (%.1lf ns/op)\n", layout,
+				layout * 1e9 / (2.0 * count));
+		printf("Speedup: %.1lfx [checksum: %llu]\n", format / layout,
+				checksum);
+	}
+
+	Message::recycle(a);
+	Message::recycle(b);
+	Message::destroyPool();
+}
+
+} /* namespace wanhive */
@@ -0,0 +1,35 @@
+/*
+ * LayoutBenchmark.h
+ *
+ * Compile-time wire layout benchmark
+ *
+ *
+ * Copyright (C) 2025 Wanhive Systems Private Limited (info@wanhive.com)
+ * This program is part of the Wanhive IoT Platform.
+ * Check the COPYING file for the license.
+ *
+ */
+
+#ifndef WH_TEST_DS_LAYOUTBENCHMARK_H_
+#define WH_TEST_DS_LAYOUTBENCHMARK_H_
+
+namespace wanhive {
+
+class LayoutBenchmark {
+public:
+	LayoutBenchmark(unsigned int count = 5000000) noexcept;
+	~LayoutBenchmark();
+	void execute() noexcept;
+private:
+	bool verify() noexcept;
+	void formatTest() noexcept;
+	void layoutTest() noexcept;
+	void messageTest() noexcept;
+private:
+	unsigned int count;
+	unsigned long long checksum;
+};
+
+} /* namespace wanhive */
+
+#endif /* WH_TEST_DS_LAYOUTBENCHMARK_H_ */
@@ -0,0 +1,241 @@
+/*
+ * MessageLogTest.cpp
+ *
+ * Store-and-forward log test routines
+ *
+ *
+ * Copyright (C) 2025 Wanhive Systems Private Limited (info@wanhive.com)
+ * This program is part of the Wanhive IoT Platform.
+ * Check the COPYING file for the license.
+ *
+ */
+
+#include "MessageLogTest.h"
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+namespace {
+
+constexpr unsigned int PAYLOAD = 248;
+constexpr unsigned int SEGMENT_SIZE = wanhive::MessageLog::MIN_SEGMENT_SIZE;
+
+}  // namespace
+
+namespace wanhive {
+
+MessageLogTest::MessageLogTest() noexcept :
+		segments { 0 } {
+	strcpy(path, "/tmp/wanhive-log-XXXXXX");
+	if (!mkdtemp(path)) {
+		path[0] = '\0';
+	}
+}
+
+MessageLogTest::~MessageLogTest() {
+	close();
+	if (path[0]) {
+		rmdir(path);
+	}
+}
+
+void MessageLogTest::execute() noexcept {
+	if (!path[0]) {
+		printf("Temporary directory not available\n");
+		return;
+	}
+
+	printf("Log directory: %s\n", path);
+	orderTest();
+	limitsTest();
+	expiryTest();
+	recoveryTest();
+	compactionTest();
+	relocationTest();
+}
+
+bool MessageLogTest::open(unsigned int segments) noexcept {
+	try {
+		log.open(path, SEGMENT_SIZE, segments);
+		this->segments = segments;
+		return true;
+	} catch (...) {
+		return false;
+	}
+}
+
+void MessageLogTest::close() noexcept {
+	log.close();
+	log.setLimits(0, 0, 0);
+	for (unsigned int i = 0; i < segments; ++i) {
+		char name[PATH_MAX];
+		snprintf(name, sizeof(name), "%s/%02u.log", path, i);
+		unlink(name);
+	}
+	segments = 0;
+}
+
+bool MessageLogTest::put(unsigned long long uid, unsigned long long source,
+		unsigned int value) noexcept {
+	unsigned char frame[PAYLOAD];
+	memset(frame, (int) (value & 0xff), sizeof(frame));
+	memcpy(frame, &value, sizeof(value));
+	return log.put(uid, source, frame, sizeof(frame));
+}
+
+bool MessageLogTest::check(unsigned long long uid, unsigned int value) noexcept {
+	unsigned int length = 0;
+	auto frame = log.peek(uid, length);
+	if (!frame || length != PAYLOAD || memcmp(frame, &value, sizeof(value))) {
+		return false;
+	}
+
+	for (auto i = sizeof(value); i < length; ++i) {
+		if (frame[i] != (value & 0xff)) {
+			return false;
+		}
+	}
+	log.pop(uid);
+	return true;
+}
+
+void MessageLogTest::report(const char *name, bool passed) noexcept {
+	printf("%-12s %s\n", name, passed ? "PASSED" : "FAILED");
+}
+
+void MessageLogTest::orderTest() noexcept {
+	bool passed = open(2);
+	for (unsigned int i = 0; passed && i < 64; ++i) {
+		passed = put(1 + (i & 3), 100, i);
+	}
+
+	passed = passed && log.count() == 64 && log.count(1) == 16
+			&& log.usage(100) == 64;
+	for (unsigned int i = 0; passed && i < 64; ++i) {
+		passed = check(1 + (i & 3), i);
+	}
+
+	passed = passed && !log.count() && !log.usage(100);
+	close();
+	report("[ORDER]", passed);
+}
+
+void MessageLogTest::limitsTest() noexcept {
+	bool passed = open(2);
+	log.setLimits(0, 2, 3);
+	//Destination's depth
+	passed = passed && put(1, 10, 1) && put(1, 20, 2) && !put(1, 30, 3);
+	//Source's quota
+	passed = passed && put(2, 40, 1) && put(3, 40, 2) && put(4, 40, 3)
+			&& !put(5, 40, 4) && log.usage(40) == 3;
+	passed = passed && check(2, 1) && log.usage(40) == 2 && put(5, 40, 4);
+	close();
+	report("[LIMITS]", passed);
+}
+
+void MessageLogTest::expiryTest() noexcept {
+	bool passed = open(2);
+	log.setLimits(1, 0, 0);
+	passed = passed && put(1, 10, 1) && put(2, 10, 2);
+	sleep(2);
+	log.setLimits(0, 0, 0);
+	passed = passed && put(2, 10, 3) && log.compact() == 2 && log.count() == 1
+			&& log.usage(10) == 1 && check(2, 3);
+	close();
+	report("[EXPIRY]", passed);
+}
+
+void MessageLogTest::recoveryTest() noexcept {
+	bool passed = open(4);
+	for (unsigned int i = 0; passed && i < 512; ++i) {
+		passed = put(1 + (i & 1), 10 + (i & 1), i);
+	}
+
+	for (unsigned int i = 0; passed && i < 256; ++i) {
+		passed = check(1 + (i & 1), i);
+	}
+
+	//Crash-free restart
+	log.close();
+	passed = passed && open(4) && log.count() == 256 && log.count(1) == 128
+			&& log.usage(10) == 128 && log.usage(11) == 128;
+	for (unsigned int i = 256; passed && i < 512; ++i) {
+		passed = check(1 + (i & 1), i);
+	}
+	close();
+	report("[RECOVERY]", passed);
+}
+
+void MessageLogTest::compactionTest() noexcept {
+	//Every segment retains some records: relocation into the reserve
+	bool passed = open(2);
+	unsigned int value = 0;
+	unsigned int kept = 0;
+	for (unsigned int cycle = 0; passed && cycle < 8; ++cycle) {
+		auto first = value;
+		while (put(value, 1, value)) {
+			++value;
+		}
+
+		//Keep every eighth record
+		for (auto i = first; passed && i < value; ++i) {
+			if (i & 7) {
+				passed = check(i, i);
+			} else {
+				++kept;
+			}
+		}
+
+		//The space is reclaimed after the copies have been written back
+		unsigned int steps = 0;
+		while (passed && !put(UINT_MAX, 2, value) && steps < 1000) {
+			log.compact();
+			log.commit();
+			usleep(1000);
+			++steps;
+		}
+		passed = passed && steps && steps < 1000 && check(UINT_MAX, value);
+	}
+
+	passed = passed && log.count() == kept && log.usage(1) == kept;
+	for (unsigned int i = 0; passed && i < value; i += 8) {
+		passed = check(i, i);
+	}
+
+	passed = passed && !log.count();
+	close();
+	report("[COMPACTION]", passed);
+}
+
+void MessageLogTest::relocationTest() noexcept {
+	//Restart before the originals of the relocated records are released
+	bool passed = open(2);
+	unsigned int value = 0;
+	unsigned int kept = 0;
+	while (put(value, 1, value)) {
+		++value;
+	}
+
+	for (unsigned int i = 0; passed && i < value; ++i) {
+		if (i & 7) {
+			passed = check(i, i);
+		} else {
+			++kept;
+		}
+	}
+
+	log.compact();
+	log.close();
+	passed = passed && open(2) && log.count() == kept && log.usage(1) == kept;
+	for (unsigned int i = 0; passed && i < value; i += 8) {
+		passed = check(i, i);
+	}
+
+	passed = passed && !log.count();
+	close();
+	report("[RELOCATION]", passed);
+}
+
+} /* namespace wanhive */
@@ -0,0 +1,46 @@
+/*
+ * MessageLogTest.h
+ *
+ * Store-and-forward log test routines
+ *
+ *
+ * Copyright (C) 2025 Wanhive Systems Private Limited (info@wanhive.com)
+ * This program is part of the Wanhive IoT Platform.
+ * Check the COPYING file for the license.
+ *
+ */
+
+#ifndef WH_TEST_OVERLAY_MESSAGELOGTEST_H_
+#define WH_TEST_OVERLAY_MESSAGELOGTEST_H_
+#include "../../server/overlay/MessageLog.h"
+
+namespace wanhive {
+
+class MessageLogTest {
+public:
+	MessageLogTest() noexcept;
+	~MessageLogTest();
+	void execute() noexcept;
+private:
+	bool open(unsigned int segments) noexcept;
+	void close() noexcept;
+	bool put(unsigned long long uid, unsigned long long source,
+			unsigned int value) noexcept;
+	bool check(unsigned long long uid, unsigned int value) noexcept;
+	static void report(const char *name, bool passed) noexcept;
+	//-----------------------------------------------------------------
+	void orderTest() noexcept;
+	void limitsTest() noexcept;
+	void expiryTest() noexcept;
+	void recoveryTest() noexcept;
+	void compactionTest() noexcept;
+	void relocationTest() noexcept;
+private:
+	MessageLog log;
+	char path[64];
+	unsigned int segments;
+};
+
+} /* namespace wanhive */
+
+#endif /* WH_TEST_OVERLAY_MESSAGELOGTEST_H_ */
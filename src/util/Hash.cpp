@@ -12,11 +12,12 @@
 
 #include "Hash.h"
 #include "../base/ds/Encoding.h"
+#include <openssl/crypto.h>
 
 namespace wanhive {
 
 Hash::Hash() noexcept :
-		sha(WH_SHA512) {
+		sha(WH_SHA512), hmac(WH_HMAC_SHA512), blake2b(WH_BLAKE2B512) {
 }
 
 Hash::~Hash() {
@@ -33,9 +34,32 @@ bool Hash::verify(const Digest *digest, const void *block,
 			(const unsigned char*) digest);
 }
 
+bool Hash::create(MacType type, const void *key, unsigned int keyLength,
+		const void *block, unsigned int size, Digest *digest) noexcept {
+	auto mac = select(type, key, keyLength);
+	return mac && digest && mac->create(block, size, (unsigned char*) digest);
+}
+
+bool Hash::verify(MacType type, const void *key, unsigned int keyLength,
+		const Digest *digest, const void *block, unsigned int size) noexcept {
+	auto mac = select(type, key, keyLength);
+	return mac && digest
+			&& mac->verify(block, size, (const unsigned char*) digest);
+}
+
 unsigned int Hash::encode(const Digest *digest, EncodedDigest *enc) noexcept {
 	return Encoding::encode(ENC_BASE64, (char*) enc, digest, Hash::SIZE,
 			sizeof(EncodedDigest));
 }
 
+bool Hash::compare(const Digest *first, const Digest *second) noexcept {
+	return first && second && !CRYPTO_memcmp(first, second, Hash::SIZE);
+}
+
+Mac* Hash::select(MacType type, const void *key,
+		unsigned int keyLength) noexcept {
+	auto mac = (type == WH_BLAKE2B512) ? &blake2b : &hmac;
+	return mac->setKey(key, keyLength) ? mac : nullptr;
+}
+
 } /* namespace wanhive */
@@ -12,6 +12,7 @@
 
 #ifndef WH_UTIL_HASH_H_
 #define WH_UTIL_HASH_H_
+#include "../base/security/Mac.h"
 #include "../base/security/Sha.h"
 
 namespace wanhive {
@@ -53,6 +54,32 @@ public:
 	bool verify(const Digest *digest, const void *block,
 			unsigned int size) noexcept;
 	//-----------------------------------------------------------------
+	/**
+	 * Computes a keyed message authentication code, the keyed state is cached
+	 * and reused while the key doesn't change.
+	 * @param type the message authentication code type
+	 * @param key the secret key (at most Mac::MAX_KEY_LENGTH bytes)
+	 * @param keyLength key's size in bytes
+	 * @param block the input data
+	 * @param size size of the input data in bytes
+	 * @param digest the object for storing the authentication code
+	 * @return true on success, false otherwise
+	 */
+	bool create(MacType type, const void *key, unsigned int keyLength,
+			const void *block, unsigned int size, Digest *digest) noexcept;
+	/**
+	 * Verifies a keyed message authentication code in constant time.
+	 * @param type the message authentication code type
+	 * @param key the secret key (at most Mac::MAX_KEY_LENGTH bytes)
+	 * @param keyLength key's size in bytes
+	 * @param digest the authentication code to verify
+	 * @param block the reference data
+	 * @param size reference data's size in bytes
+	 * @return true on successful verification, false otherwise
+	 */
+	bool verify(MacType type, const void *key, unsigned int keyLength,
+			const Digest *digest, const void *block, unsigned int size) noexcept;
+	//-----------------------------------------------------------------
 	/**
 	 * Base-64 encodes the given digest value.
 	 * @param digest the digest value to encode
@@ -61,11 +88,23 @@ public:
 	 */
 	static unsigned int encode(const Digest *digest,
 			EncodedDigest *enc) noexcept;
+	/**
+	 * Compares two digest values in constant time.
+	 * @param first the first digest value
+	 * @param second the second digest value
+	 * @return true if the two values are equal, false otherwise
+	 */
+	static bool compare(const Digest *first, const Digest *second) noexcept;
 public:
 	/** The output size in bytes (64 bytes) **/
 	static constexpr unsigned int SIZE = Sha::length(WH_SHA512);
+	static_assert(SIZE == Mac::SIZE, "Invalid MAC size");
+private:
+	Mac* select(MacType type, const void *key, unsigned int keyLength) noexcept;
 private:
 	Sha sha;
+	Mac hmac;
+	Mac blake2b;
 };
 
 } /* namespace wanhive */
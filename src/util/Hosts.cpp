@@ -142,6 +142,44 @@ void Hosts::batchDump(const char *path, int version) {
 	}
 }
 
+void Hosts::iterate(void (*fn)(unsigned long long uid, const NameInfo &ni,
+		void *arg), void *arg) {
+	if (!db.conn || !fn) {
+		throw Exception(EX_RESOURCE);
+	}
+	//-----------------------------------------------------------------
+	auto query = "SELECT uid, name, service, type FROM hosts ORDER BY uid ASC";
+	sqlite3_stmt *stmt = nullptr;
+	if (sqlite3_prepare_v2(db.conn, query, strlen(query), &stmt,
+			nullptr) != SQLITE_OK) {
+		finalize(stmt);
+		throw Exception(EX_STATE);
+	}
+	//-----------------------------------------------------------------
+	try {
+		NameInfo ni;
+		int z;
+		while ((z = sqlite3_step(stmt)) == SQLITE_ROW) {
+			memset(&ni, 0, sizeof(ni));
+			auto id = (unsigned long long) sqlite3_column_int64(stmt, 0);
+			strncpy(ni.host, (const char*) sqlite3_column_text(stmt, 1),
+					sizeof(ni.host) - 1);
+			strncpy(ni.service, (const char*) sqlite3_column_text(stmt, 2),
+					sizeof(ni.service) - 1);
+			ni.type = sqlite3_column_int(stmt, 3);
+			fn(id, ni, arg);
+		}
+
+		if (z != SQLITE_DONE) {
+			throw Exception(EX_OPERATION);
+		}
+		finalize(stmt);
+	} catch (const BaseException &e) {
+		finalize(stmt);
+		throw;
+	}
+}
+
 int Hosts::get(unsigned long long uid, NameInfo &ni) noexcept {
 	if (db.conn && db.qStmt) {
 		int ret = 0;
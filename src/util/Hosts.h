@@ -61,6 +61,15 @@ public:
 	 * @param version the output format specifier
 	 */
 	void batchDump(const char *path, int version = 1);
+	/**
+	 * Visits every record of the hosts database in the ascending order of the
+	 * host identifiers.
+	 * @param fn the callback function, invoked with the host identifier, the
+	 * associated network address, and the additional argument.
+	 * @param arg additional argument for the callback function
+	 */
+	void iterate(void (*fn)(unsigned long long uid, const NameInfo &ni,
+			void *arg), void *arg);
 	//-----------------------------------------------------------------
 	/**
 	 * Retrieves the network address associated with the given host identifier.
@@ -119,7 +128,8 @@ public:
 	 */
 	enum : int {
 		BOOTSTRAP = 1, /**< Bootstrapping host */
-		AUTHENTICATOR = 2/**< Authentication host */
+		AUTHENTICATOR = 2, /**< Authentication host */
+		CONTROLLER = 3 /**< Controller's standby replica */
 	};
 private:
 	struct {
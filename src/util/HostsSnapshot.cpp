@@ -0,0 +1,319 @@
+/*
+ * HostsSnapshot.cpp
+ *
+ * Read-only, memory-mapped snapshot of the hosts database
+ *
+ *
+ * Copyright (C) 2025 Wanhive Systems Private Limited (info@wanhive.com)
+ * This program is part of the Wanhive IoT Platform.
+ * Check the COPYING file for the license.
+ *
+ */
+
+#include "HostsSnapshot.h"
+#include "../base/Timer.h"
+#include "../base/common/Atomic.h"
+#include "../base/common/Exception.h"
+#include "../base/common/Memory.h"
+#include "../base/ds/Xoshiro.h"
+#include "../base/unix/FStat.h"
+#include "../base/unix/FileSystem.h"
+#include "../base/unix/SystemException.h"
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace wanhive {
+
+HostsSnapshot::HostsSnapshot() noexcept {
+
+}
+
+HostsSnapshot::HostsSnapshot(const char *path) {
+	open(path);
+}
+
+HostsSnapshot::~HostsSnapshot() {
+	close();
+}
+
+void HostsSnapshot::open(const char *path) {
+	auto image = load(path);
+	auto previous = Atomic<Image*>::exchange(&current, image, MO_SEQ_CST);
+	if (previous) {
+		synchronize();
+		release(previous);
+	}
+}
+
+void HostsSnapshot::close() noexcept {
+	auto previous = Atomic<Image*>::exchange(&current, nullptr, MO_SEQ_CST);
+	if (previous) {
+		synchronize();
+		release(previous);
+	}
+}
+
+bool HostsSnapshot::isOpen() const noexcept {
+	return Atomic<Image*>::load(&current, MO_ACQUIRE) != nullptr;
+}
+
+unsigned int HostsSnapshot::count() const noexcept {
+	auto slot = enter();
+	auto image = Atomic<Image*>::load(&current, MO_SEQ_CST);
+	auto n = image ? image->header->count : 0;
+	leave(slot);
+	return n;
+}
+
+int HostsSnapshot::get(unsigned long long uid, NameInfo &ni) const noexcept {
+	auto slot = enter();
+	auto ret = get(Atomic<Image*>::load(&current, MO_SEQ_CST), uid, ni);
+	leave(slot);
+	return ret;
+}
+
+int HostsSnapshot::list(unsigned long long uids[], unsigned int &count,
+		int type) const noexcept {
+	auto slot = enter();
+	auto ret = list(Atomic<Image*>::load(&current, MO_SEQ_CST), uids, count,
+			type);
+	leave(slot);
+	return ret;
+}
+
+void HostsSnapshot::create(const char *path, Hosts &hosts) {
+	if (!path || !path[0]) {
+		throw Exception(EX_ARGUMENT);
+	}
+
+	char temp[PATH_MAX];
+	if (snprintf(temp, sizeof(temp), "%s.tmp", path) >= (int) sizeof(temp)) {
+		throw Exception(EX_ARGUMENT);
+	}
+	//-----------------------------------------------------------------
+	struct Builder {
+		Record *records;
+		unsigned int capacity;
+		unsigned int count;
+		char *strings;
+		size_t size;
+		size_t used;
+	} b { nullptr, 0, 0, nullptr, 0, 0 };
+	auto collect = [](unsigned long long uid, const NameInfo &ni, void *arg) {
+		auto b = static_cast<Builder*>(arg);
+		auto host = strlen(ni.host);
+		auto service = strlen(ni.service);
+		auto length = host + service + 2;
+		if (b->used + length > UINT32_MAX) {
+			throw Exception(EX_OVERFLOW);
+		} else if (b->used + length > b->size) {
+			b->size = (b->size + length) << 1;
+			Memory<char>::resize(b->strings, b->size);
+		}
+
+		Record r { uid, (uint32_t) b->used, ni.type, (uint16_t) host,
+				(uint16_t) service, 0 };
+		Memory<Record>::append(b->records, b->capacity, b->count, r);
+		memcpy(b->strings + b->used, ni.host, host + 1);
+		memcpy(b->strings + b->used + host + 1, ni.service, service + 1);
+		b->used += length;
+	};
+
+	int fd = -1;
+	try {
+		hosts.iterate(collect, &b);
+		Header h { MAGIC, VERSION, b.count, (uint32_t) b.used };
+		fd = Storage::open(temp, O_WRONLY | O_CREAT | O_TRUNC,
+				S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+		Storage::write(fd, &h, sizeof(h));
+		Storage::write(fd, b.records, b.count * sizeof(Record));
+		Storage::write(fd, b.strings, b.used);
+		Storage::sync(fd);
+		Storage::close(fd);
+		fd = -1;
+		FileSystem::rename(temp, path);
+		Memory<Record>::free(b.records);
+		Memory<char>::free(b.strings);
+	} catch (const BaseException &e) {
+		if (fd != -1) {
+			Storage::close(fd);
+		}
+		::unlink(temp);
+		Memory<Record>::free(b.records);
+		Memory<char>::free(b.strings);
+		throw;
+	}
+}
+
+HostsSnapshot::Image* HostsSnapshot::load(const char *path) {
+	auto fd = Storage::open(path, O_RDONLY);
+	void *base = MAP_FAILED;
+	size_t length = 0;
+	try {
+		length = FStat(fd).size();
+		if (length >= sizeof(Header)) {
+			base = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+		}
+		Storage::close(fd);
+	} catch (const BaseException &e) {
+		Storage::close(fd);
+		throw;
+	}
+
+	if (length < sizeof(Header)) {
+		throw Exception(EX_RESOURCE);
+	} else if (base == MAP_FAILED) {
+		throw SystemException();
+	} else if (!validate(base, length)) {
+		munmap(base, length);
+		throw Exception(EX_RESOURCE);
+	}
+	//-----------------------------------------------------------------
+	auto image = new Image;
+	image->base = base;
+	image->length = length;
+	image->header = static_cast<const Header*>(base);
+	image->records = reinterpret_cast<const Record*>(image->header + 1);
+	image->strings = reinterpret_cast<const char*>(image->records
+			+ image->header->count);
+	return image;
+}
+
+bool HostsSnapshot::validate(const void *base, size_t length) noexcept {
+	auto h = static_cast<const Header*>(base);
+	if (h->magic != MAGIC || h->version != VERSION) {
+		return false;
+	} else if (length
+			!= sizeof(Header) + ((size_t) h->count * sizeof(Record)) + h->size) {
+		return false;
+	}
+	//-----------------------------------------------------------------
+	//Sorted unique keys and NUL-terminated strings inside the pool
+	auto records = reinterpret_cast<const Record*>(h + 1);
+	auto strings = reinterpret_cast<const char*>(records + h->count);
+	for (uint32_t i = 0; i < h->count; ++i) {
+		auto &r = records[i];
+		auto end = (size_t) r.offset + r.host + r.service + 2;
+		if (i && r.uid <= records[i - 1].uid) {
+			return false;
+		} else if (end > h->size) {
+			return false;
+		} else if (strings[r.offset + r.host] || strings[end - 1]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void HostsSnapshot::release(Image *image) noexcept {
+	if (image) {
+		munmap(image->base, image->length);
+		delete image;
+	}
+}
+
+int HostsSnapshot::get(const Image *image, unsigned long long uid,
+		NameInfo &ni) noexcept {
+	if (!image) {
+		return -1;
+	}
+
+	auto r = find(image, uid);
+	if (!r) {
+		return 1;
+	}
+
+	memset(&ni, 0, sizeof(ni));
+	auto host = image->strings + r->offset;
+	memcpy(ni.host, host,
+			(r->host < sizeof(ni.host)) ? r->host : (sizeof(ni.host) - 1));
+	memcpy(ni.service, host + r->host + 1,
+			(r->service < sizeof(ni.service)) ?
+					r->service : (sizeof(ni.service) - 1));
+	ni.type = r->type;
+	return 0;
+}
+
+int HostsSnapshot::list(const Image *image, unsigned long long uids[],
+		unsigned int &count, int type) noexcept {
+	if (count == 0) {
+		return 0;
+	} else if (!uids || !image) {
+		count = 0;
+		return -1;
+	}
+	//-----------------------------------------------------------------
+	//Reservoir sampling followed by a shuffle
+	Xoshiro prng(Timer::timeSeed());
+	unsigned int n = 0;
+	for (unsigned int i = 0; i < image->header->count; ++i) {
+		auto &r = image->records[i];
+		if (r.type != type) {
+			continue;
+		} else if (n < count) {
+			uids[n] = r.uid;
+		} else if (auto j = prng.next(n + 1); j < count) {
+			uids[j] = r.uid;
+		}
+		++n;
+	}
+
+	count = (n < count) ? n : count;
+	for (unsigned int i = count; i > 1; --i) {
+		auto j = prng.next(i);
+		auto tmp = uids[i - 1];
+		uids[i - 1] = uids[j];
+		uids[j] = tmp;
+	}
+	return 0;
+}
+
+unsigned int HostsSnapshot::enter() const noexcept {
+	auto slot = Atomic<unsigned int>::load(&epoch, MO_SEQ_CST) & 1;
+	Atomic<unsigned int>::fetchAndAdd(&readers[slot], 1, MO_SEQ_CST);
+	return slot;
+}
+
+void HostsSnapshot::leave(unsigned int slot) const noexcept {
+	Atomic<unsigned int>::fetchAndSub(&readers[slot], 1, MO_RELEASE);
+}
+
+void HostsSnapshot::synchronize() noexcept {
+	/*
+	 * Advance the epoch twice and drain both slots: a reader which sampled
+	 * the epoch before the first advance may register itself after the
+	 * first wait. The new readers use the other slot, hence the wait ends.
+	 */
+	for (unsigned int i = 0; i < 2; ++i) {
+		auto slot = Atomic<unsigned int>::fetchAndAdd(&epoch, 1, MO_SEQ_CST)
+				& 1;
+		while (Atomic<unsigned int>::load(&readers[slot], MO_ACQUIRE)) {
+			sched_yield();
+		}
+	}
+}
+
+const HostsSnapshot::Record* HostsSnapshot::find(const Image *image,
+		uint64_t uid) noexcept {
+	uint32_t low = 0;
+	uint32_t high = image->header->count;
+	while (low < high) {
+		auto mid = low + ((high - low) >> 1);
+		auto &r = image->records[mid];
+		if (r.uid == uid) {
+			return &r;
+		} else if (r.uid < uid) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+	return nullptr;
+}
+
+} /* namespace wanhive */
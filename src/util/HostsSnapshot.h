@@ -0,0 +1,146 @@
+/*
+ * HostsSnapshot.h
+ *
+ * Read-only, memory-mapped snapshot of the hosts database
+ *
+ *
+ * Copyright (C) 2025 Wanhive Systems Private Limited (info@wanhive.com)
+ * This program is part of the Wanhive IoT Platform.
+ * Check the COPYING file for the license.
+ *
+ */
+
+#ifndef WH_UTIL_HOSTSSNAPSHOT_H_
+#define WH_UTIL_HOSTSSNAPSHOT_H_
+#include "Hosts.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace wanhive {
+/**
+ * Compiled, read-only hosts directory backed by a memory-mapped file. The
+ * records are sorted by the host identifiers, lookups perform a binary search
+ * without taking any lock or touching the SQLite database.
+ * Lookups are thread safe, reloads must be serialized by the caller. A
+ * replaced snapshot is unmapped after the lookups which might be using it
+ * have completed (epoch-based reclamation).
+ */
+class HostsSnapshot: private NonCopyable {
+public:
+	/**
+	 * Default constructor: doesn't map any file. Call HostsSnapshot::open()
+	 * explicitly to load a snapshot.
+	 */
+	HostsSnapshot() noexcept;
+	/**
+	 * Constructor: loads a snapshot.
+	 * @param path pathname of the snapshot file
+	 */
+	HostsSnapshot(const char *path);
+	/**
+	 * Destructor: unmaps the snapshot.
+	 */
+	~HostsSnapshot();
+	//-----------------------------------------------------------------
+	/**
+	 * Maps and validates a snapshot file, and atomically replaces the current
+	 * snapshot with it. Waits for the in-flight lookups to complete before
+	 * unmapping the replaced snapshot. On failure, the current snapshot
+	 * remains in use.
+	 * @param path pathname of the snapshot file
+	 */
+	void open(const char *path);
+	/**
+	 * Unmaps the snapshot after the in-flight lookups have completed.
+	 */
+	void close() noexcept;
+	/**
+	 * Checks whether a snapshot has been loaded.
+	 * @return true if a snapshot is available, false otherwise
+	 */
+	bool isOpen() const noexcept;
+	/**
+	 * Returns the number of records in the current snapshot.
+	 * @return records count
+	 */
+	unsigned int count() const noexcept;
+	//-----------------------------------------------------------------
+	/**
+	 * Retrieves the network address associated with the given host identifier.
+	 * @param uid the host identifier
+	 * @param ni object for storing the network address
+	 * @return 0 on success, 1 if no record found, -1 on error
+	 */
+	int get(unsigned long long uid, NameInfo &ni) const noexcept;
+	/**
+	 * Returns a randomized list of host identifiers of the given type.
+	 * @param uids the output array for storing the host identifiers
+	 * @param count before the call it's value should be set to the maximum
+	 * capacity of the output array. The actual number of elements transferred
+	 * into the output array is written to this argument.
+	 * @param type the desired host type
+	 * @return 0 on success, -1 on error
+	 */
+	int list(unsigned long long uids[], unsigned int &count,
+			int type) const noexcept;
+	//-----------------------------------------------------------------
+	/**
+	 * Compiles the hosts database into a snapshot file. The snapshot is
+	 * written into a temporary file which then replaces the target, hence the
+	 * readers never observe a partially written snapshot.
+	 * @param path pathname of the snapshot file
+	 * @param hosts the hosts database
+	 */
+	static void create(const char *path, Hosts &hosts);
+private:
+	struct Header {
+		uint32_t magic;
+		uint32_t version;
+		uint32_t count; //Number of records
+		uint32_t size; //String pool's size in bytes
+	};
+
+	struct Record {
+		uint64_t uid;
+		uint32_t offset; //Host name's offset into the string pool
+		int32_t type;
+		uint16_t host; //Host name's length
+		uint16_t service; //Service name's length (follows the host name)
+		uint32_t reserved;
+	};
+
+	struct Image {
+		void *base;
+		size_t length;
+		const Header *header;
+		const Record *records;
+		const char *strings;
+	};
+
+	static Image* load(const char *path);
+	static bool validate(const void *base, size_t length) noexcept;
+	static void release(Image *image) noexcept;
+	static const Record* find(const Image *image, uint64_t uid) noexcept;
+	static int get(const Image *image, unsigned long long uid,
+			NameInfo &ni) noexcept;
+	static int list(const Image *image, unsigned long long uids[],
+			unsigned int &count, int type) noexcept;
+	//-----------------------------------------------------------------
+	//Registers a lookup in the current epoch, returns the reader's slot
+	unsigned int enter() const noexcept;
+	//Unregisters a lookup
+	void leave(unsigned int slot) const noexcept;
+	//Waits for the lookups which might still use a replaced snapshot
+	void synchronize() noexcept;
+	static constexpr uint32_t MAGIC = 0x57485350; //"WHSP"
+	static constexpr uint32_t VERSION = 1;
+private:
+	Image *current { nullptr }; //Serves the lookups
+	//The readers alternate between two slots as the epoch advances
+	unsigned int epoch { 0 };
+	mutable unsigned int readers[2] { 0, 0 };
+};
+
+} /* namespace wanhive */
+
+#endif /* WH_UTIL_HOSTSSNAPSHOT_H_ */
@@ -27,8 +27,8 @@ InstanceID::~InstanceID() {
 }
 
 void InstanceID::generateNonce(Hash &hash, uint64_t salt, uint64_t id,
-		Digest *nonce) const noexcept {
-	if (nonce) {
+		Digest *nonce, NonceType type) const noexcept {
+	if (nonce && !keyed(hash, salt, id, nonce, type)) {
 		uint64_t block[ArraySize(buffer) + 2];
 		block[0] = salt;
 		block[1] = id;
@@ -39,8 +39,17 @@ void InstanceID::generateNonce(Hash &hash, uint64_t salt, uint64_t id,
 }
 
 bool InstanceID::verifyNonce(Hash &hash, uint64_t salt, uint64_t id,
-		const Digest *nonce) const noexcept {
-	if (nonce) {
+		const Digest *nonce, NonceType type) const noexcept {
+	if (!nonce) {
+		return false;
+	}
+
+	Digest md;
+	if (keyed(hash, salt, id, &md, type)) {
+		auto ret = Hash::compare(&md, nonce);
+		memset(md, 0, sizeof(md));
+		return ret;
+	} else {
 		uint64_t block[ArraySize(buffer) + 2];
 		block[0] = salt;
 		block[1] = id;
@@ -48,9 +57,19 @@ bool InstanceID::verifyNonce(Hash &hash, uint64_t salt, uint64_t id,
 		auto ret = hash.verify(nonce, block, sizeof(block));
 		memset(block, 0, sizeof(block));
 		return ret;
-	} else {
+	}
+}
+
+bool InstanceID::keyed(Hash &hash, uint64_t salt, uint64_t id, Digest *nonce,
+		NonceType type) const noexcept {
+	if (type != WH_NONCE_HMAC && type != WH_NONCE_BLAKE2B) {
 		return false;
 	}
+
+	uint64_t block[2] = { salt, id };
+	auto mac = (type == WH_NONCE_HMAC) ? WH_HMAC_SHA512 : WH_BLAKE2B512;
+	return hash.create(mac, buffer, sizeof(buffer), block, sizeof(block),
+			nonce);
 }
 
 } /* namespace wanhive */
@@ -16,6 +16,16 @@
 #include "../base/common/NonCopyable.h"
 
 namespace wanhive {
+//-----------------------------------------------------------------
+/**
+ * Nonce generation algorithms
+ */
+enum NonceType {
+	WH_NONCE_SHA512, /**< SHA-512 over the salt, identifier, and secret */
+	WH_NONCE_HMAC, /**< HMAC-SHA-512 keyed with the secret */
+	WH_NONCE_BLAKE2B /**< BLAKE2b-512 keyed with the secret */
+};
+//-----------------------------------------------------------------
 /**
  * A unique and secret identifier.
  */
@@ -36,19 +46,26 @@ public:
 	 * @param salt the salt
 	 * @param id the identifier, (salt, id) pair should be unique.
 	 * @param nonce the object for storing the generated nonce
+	 * @param type the nonce generation algorithm, the keyed algorithms fall
+	 * back to SHA-512 if they are not available.
 	 */
-	void generateNonce(Hash &hash, uint64_t salt, uint64_t id,
-			Digest *nonce) const noexcept;
+	void generateNonce(Hash &hash, uint64_t salt, uint64_t id, Digest *nonce,
+			NonceType type = WH_NONCE_SHA512) const noexcept;
 	/**
 	 * Verifies a nonce.
 	 * @param hash the object that provides the hash function
 	 * @param salt the salt
 	 * @param id the identifier
 	 * @param nonce the nonce for verification
+	 * @param type the algorithm used for generating the nonce
 	 * @return true on successful verification, false otherwise
 	 */
-	bool verifyNonce(Hash &hash, uint64_t salt, uint64_t id,
-			const Digest *nonce) const noexcept;
+	bool verifyNonce(Hash &hash, uint64_t salt, uint64_t id, const Digest *nonce,
+			NonceType type = WH_NONCE_SHA512) const noexcept;
+private:
+	//Keyed nonce, returns false if the algorithm is not available
+	bool keyed(Hash &hash, uint64_t salt, uint64_t id, Digest *nonce,
+			NonceType type) const noexcept;
 private:
 	uint64_t buffer[4]; //256 bits of the instance id
 };
@@ -14,6 +14,7 @@
 #define WH_UTIL_MESSAGE_H_
 #include "Packet.h"
 #include "../base/common/Source.h"
+#include "../base/ds/Layout.h"
 #include "../base/ds/Pooled.h"
 #include "../base/ds/State.h"
 #include <cstdarg>
@@ -565,6 +566,35 @@ public:
 	 */
 	bool unpack(const char *format, va_list ap) const noexcept;
 	//-----------------------------------------------------------------
+	/**
+	 * Writes header and payload data into this message (see Layout).
+	 * @tparam L payload's layout
+	 * @param header header data. It's length field is ignored and the correct
+	 * message length is calculated.
+	 * @param values payload data
+	 * @return true on success, false on failure (overflow)
+	 */
+	template<typename L, typename ...Args>
+	bool pack(const MessageHeader &header, Args ...values) noexcept {
+		static_assert(L::SIZE <= PAYLOAD_SIZE, "Payload too large");
+		this->header() = header;
+		this->header().setLength(0); //Length will be calculated
+		auto size = this->header().write(frame().array());
+		auto n = L::pack(frame().array() + HEADER_SIZE, values...);
+		return n && putLength(size + n);
+	}
+	/**
+	 * Extracts this message's payload data (see Layout).
+	 * @tparam L payload's layout
+	 * @param values objects for storing the payload data
+	 * @return true on success, false on error (invalid message or underflow)
+	 */
+	template<typename L, typename ...Args>
+	bool unpack(Args &...values) const noexcept {
+		return L::unpack(frame().array() + HEADER_SIZE, getPayloadLength(),
+				values...);
+	}
+	//-----------------------------------------------------------------
 	/**
 	 * Checks if a given number of messages can be created.
 	 * @param count number of messages to create
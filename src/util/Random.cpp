@@ -25,7 +25,7 @@ Random::~Random() {
 }
 
 void Random::bytes(void *buffer, unsigned int count) {
-	if (!CSPRNG::bytes(buffer, count)) {
+	if (!CSPRNG::buffered(buffer, count)) {
 		throw Exception(EX_SECURITY);
 	}
 }
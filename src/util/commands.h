@@ -38,10 +38,17 @@ enum WhpQualifier {
 	WH_QLF_GETKEY = 1, /**< Session key request */
 	WH_QLF_FINDROOT = 2, /**< Root identification request */
 	WH_QLF_BOOTSTRAP = 3, /**< Bootstrap request */
+	WH_QLF_AUTHORIZE = 4, /**< Capability presentation request */
 	//WH_CMD_MULTICAST
 	WH_QLF_PUBLISH = 0, /**< Publish request */
 	WH_QLF_SUBSCRIBE = 1, /**< Subscribe request */
-	WH_QLF_UNSUBSCRIBE = 2 /**< Unsubscribe request */
+	WH_QLF_UNSUBSCRIBE = 2, /**< Unsubscribe request */
+	WH_QLF_XPUBLISH = 3, /**< Publish request (64-bit topic) */
+	WH_QLF_XSUBSCRIBE = 4, /**< Subscribe request (64-bit topic) */
+	WH_QLF_XUNSUBSCRIBE = 5, /**< Unsubscribe request (64-bit topic) */
+	WH_QLF_NPUBLISH = 6, /**< Publish request (topic name) */
+	WH_QLF_NSUBSCRIBE = 7, /**< Subscribe request (topic filter) */
+	WH_QLF_NUNSUBSCRIBE = 8 /**< Unsubscribe request (topic filter) */
 };
 
 /**
@@ -53,6 +60,40 @@ enum WhpStatus {
 	WH_AQLF_REQUEST = 127/**< Request status */
 };
 
+/**
+ * Enumeration of the fields tested by the subscriptions' content filters.
+ * A content filter is a sequence of 12-byte terms: [field(1) | operator(1) |
+ * offset(2) | operand(8)]. The typed fields are read from the publication's
+ * data at the given offset (the data follows the topic in the extended and
+ * the named forms).
+ */
+enum WhpFilterField {
+	WH_FLT_SOURCE = 0, /**< Publisher's identifier (header) */
+	WH_FLT_LENGTH = 1, /**< Publication's length (header) */
+	WH_FLT_U8 = 2, /**< 8-bit unsigned integer (data) */
+	WH_FLT_U16 = 3, /**< 16-bit unsigned integer (data) */
+	WH_FLT_U32 = 4, /**< 32-bit unsigned integer (data) */
+	WH_FLT_U64 = 5, /**< 64-bit unsigned integer (data) */
+	WH_FLT_I32 = 6, /**< 32-bit signed integer (data) */
+	WH_FLT_I64 = 7 /**< 64-bit signed integer (data) */
+};
+
+/**
+ * Enumeration of the content filters' operators. The terms are combined
+ * with logical AND, the WH_FLT_OR term starts an alternative group.
+ */
+enum WhpFilterOperator {
+	WH_FLT_EQ = 0, /**< Equal to the operand */
+	WH_FLT_NE = 1, /**< Not equal to the operand */
+	WH_FLT_LT = 2, /**< Less than the operand */
+	WH_FLT_LE = 3, /**< Less than or equal to the operand */
+	WH_FLT_GT = 4, /**< Greater than the operand */
+	WH_FLT_GE = 5, /**< Greater than or equal to the operand */
+	WH_FLT_ALL = 6, /**< All the operand's bits are set */
+	WH_FLT_ANY = 7, /**< Any of the operand's bits is set */
+	WH_FLT_OR = 8 /**< Starts an alternative group of terms */
+};
+
 }  // namespace wanhive
 
 #endif /* WH_UTIL_COMMANDS_H_ */
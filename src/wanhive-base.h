@@ -30,6 +30,7 @@
 #include "base/ds/Encoding.h"
 #include "base/ds/Handle.h"
 #include "base/ds/Khash.h"
+#include "base/ds/Layout.h"
 #include "base/ds/MersenneTwister.h"
 #include "base/ds/Pooled.h"
 #include "base/ds/ReadyList.h"
@@ -39,12 +40,15 @@
 #include "base/ds/StaticCircularBuffer.h"
 #include "base/ds/Tokens.h"
 #include "base/ds/UID.h"
+#include "base/ds/Xoshiro.h"
 
 /*
  * IPC library
  */
+#include "base/ipc/Connector.h"
 #include "base/ipc/DNS.h"
 #include "base/ipc/NetworkAddressException.h"
+#include "base/ipc/Resolver.h"
 
 /*
  * System utilities
@@ -64,6 +68,7 @@
  */
 #include "base/security/CryptoUtils.h"
 #include "base/security/CSPRNG.h"
+#include "base/security/Mac.h"
 #include "base/security/Rsa.h"
 #include "base/security/SecurityException.h"
 #include "base/security/Sha.h"
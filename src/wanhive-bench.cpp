@@ -0,0 +1,90 @@
+//============================================================================
+// Name        : wanhive-bench.cpp
+// Author      : Wanhive Systems Private Limited (info@wanhive.com)
+// Version     :
+// Copyright   : Copyright 2025 Wanhive Systems Private Limited
+// License     : Check the COPYING file for the license
+// Description : Microbenchmarks of the data structures and utilities
+//============================================================================
+
+#include "test/bench/BenchmarkSuite.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <getopt.h>
+
+namespace {
+
+void printHelp(FILE *stream, const char *program) {
+	fprintf(stream, "Usage: %s [OPTIONS]\n"
+			"OPTIONS\n"
+			"-f --filter   <pattern>  Run the benchmarks whose names contain the pattern.\n"
+			"-h --help                Display this information.\n"
+			"-j --json     <path>     Write the results as JSON to the file (\"-\" for stdout).\n"
+			"-n --samples  <number>   Number of samples per benchmark.\n"
+			"-q --quiet               Do not print the text table.\n", program);
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+	const char *filter = nullptr;
+	const char *json = nullptr;
+	unsigned int samples = 31;
+	bool quiet = false;
+
+	const char *shortOptions = "f:hj:n:q";
+	const struct option longOptions[] = { { "filter", 1, nullptr, 'f' }, {
+			"help", 0, nullptr, 'h' }, { "json", 1, nullptr, 'j' }, { "samples",
+			1, nullptr, 'n' }, { "quiet", 0, nullptr, 'q' }, { nullptr, 0,
+			nullptr, 0 } };
+	int option;
+	while ((option = getopt_long(argc, argv, shortOptions, longOptions,
+			nullptr)) != -1) {
+		switch (option) {
+		case 'f':
+			filter = optarg;
+			break;
+		case 'h':
+			printHelp(stdout, argv[0]);
+			return EXIT_SUCCESS;
+		case 'j':
+			json = optarg;
+			break;
+		case 'n':
+			samples = strtoul(optarg, nullptr, 10);
+			break;
+		case 'q':
+			quiet = true;
+			break;
+		default:
+			printHelp(stderr, argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+	//-----------------------------------------------------------------
+	try {
+		wanhive::Benchmark b(samples, filter);
+		wanhive::BenchmarkSuite::execute(b);
+		if (!quiet) {
+			b.print(stdout);
+		}
+
+		if (!json) {
+			return EXIT_SUCCESS;
+		} else if (!strcmp(json, "-")) {
+			b.json(stdout);
+			return EXIT_SUCCESS;
+		} else if (auto out = fopen(json, "w"); out) {
+			b.json(out);
+			fclose(out);
+			return EXIT_SUCCESS;
+		} else {
+			perror(json);
+			return EXIT_FAILURE;
+		}
+	} catch (...) {
+		fprintf(stderr, "Benchmark failed\n");
+		return EXIT_FAILURE;
+	}
+}
@@ -17,6 +17,7 @@
 #include "util/Endpoint.h"
 #include "util/FlowControl.h"
 #include "util/Hosts.h"
+#include "util/HostsSnapshot.h"
 #include "util/InstanceID.h"
 #include "util/Message.h"
 #include "util/Random.h"